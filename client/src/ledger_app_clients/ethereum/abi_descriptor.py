@@ -0,0 +1,73 @@
+import struct
+from enum import IntEnum
+
+
+# Prefix of the signed ABI descriptors
+ABI_DESCRIPTOR_MAGIC = b"ABI DESCRIPTOR"
+
+ABI_DESCRIPTOR_VERSION = 0x01
+
+# Set on the type of a parameter for a dynamic array of it
+ABI_TYPE_ARRAY_FLAG = 0x80
+
+
+class AbiType(IntEnum):
+    ADDRESS = 0x00
+    UINT = 0x01
+    INT = 0x02
+    BOOL = 0x03
+    FIXED_BYTES = 0x04
+    BYTES = 0x05
+    STRING = 0x06
+
+
+class AbiParam:
+    def __init__(self,
+                 label: str,
+                 type_: AbiType,
+                 size: int = 0,
+                 unit: str = "",
+                 array: bool = False,
+                 bits: int = 256):
+        self.label = label
+        self.type = type_
+        self.size = size  # decimals of the integers, length of the fixed-size byte arrays
+        self.unit = unit
+        self.array = array
+        self.bits = bits  # M of the integers uint<M> and int<M>
+
+    def serialize(self) -> bytes:
+        type_ = self.type | (ABI_TYPE_ARRAY_FLAG if self.array else 0)
+        width = self.bits // 8 if self.type in (AbiType.UINT, AbiType.INT) else 0
+        payload = struct.pack(">BBB", type_, self.size, width)
+        payload += _serialize_str(self.unit)
+        payload += _serialize_str(self.label)
+        return payload
+
+
+def _serialize_str(value: str) -> bytes:
+    data = value.encode()
+    return struct.pack(">B", len(data)) + data
+
+
+# Payload of an ABI descriptor, without its signature
+def abi_descriptor_payload(chain_id: int,
+                           address: bytes,
+                           selector: bytes,
+                           name: str,
+                           method: str,
+                           params: list[AbiParam]) -> bytes:
+    payload = struct.pack(">BQ", ABI_DESCRIPTOR_VERSION, chain_id)
+    payload += address
+    payload += selector
+    payload += _serialize_str(name)
+    payload += _serialize_str(method)
+    payload += struct.pack(">B", len(params))
+    for param in params:
+        payload += param.serialize()
+    return payload
+
+
+# Signed ABI descriptor, as sent to the app
+def abi_descriptor_with_signature(payload: bytes, sig: bytes) -> bytes:
+    return payload + struct.pack(">B", len(sig)) + sig
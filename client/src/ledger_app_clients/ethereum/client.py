@@ -5,9 +5,13 @@ from ragger.utils import RAPDU
 from typing import Optional
 
 from .command_builder import CommandBuilder
+from .response_parser import ProfilingCounter, profiling_counters, MemoryUsage, memory_usage
 from .eip712 import EIP712FieldType
 from .keychain import sign_data, Key
 from .tlv import format_tlv
+from .token_list import TokenListTree, TOKEN_LIST_MAGIC
+from .abi_descriptor import AbiParam, abi_descriptor_payload, abi_descriptor_with_signature
+from .abi_descriptor import ABI_DESCRIPTOR_MAGIC
 
 from web3 import Web3
 
@@ -20,6 +24,7 @@ class StatusWord(IntEnum):
     INVALID_INS = 0x6d00
     INVALID_P1_P2 = 0x6b00
     CONDITION_NOT_SATISFIED = 0x6985
+    COMMAND_NOT_ALLOWED = 0x6986
     REF_DATA_NOT_FOUND = 0x6a88
     EXCEPTION_OVERFLOW = 0x6807
 
@@ -75,6 +80,16 @@ class EthAppClient:
                           array_levels,
                           key_name))
 
+    # Returns the number of APDUs it took
+    def eip712_send_struct_defs_packed(self, structs: list[tuple[str, list[tuple]]]) -> int:
+        chunks = self._cmd_builder.eip712_send_struct_defs_packed(structs)
+        for chunk in chunks:
+            self._exchange(chunk)
+        return len(chunks)
+
+    def eip712_send_struct_defs_schema_hash(self, schema_hash: bytes):
+        return self._exchange(self._cmd_builder.eip712_send_struct_defs_schema_hash(schema_hash))
+
     def eip712_send_struct_impl_root_struct(self, name: str):
         return self._exchange_async(self._cmd_builder.eip712_send_struct_impl_root_struct(name))
 
@@ -87,6 +102,12 @@ class EthAppClient:
             self._exchange(chunk)
         return self._exchange_async(chunks[-1])
 
+    def eip712_send_struct_impl_packed_fields(self, raw_values: list[bytes]):
+        chunks = self._cmd_builder.eip712_send_struct_impl_packed_fields(raw_values)
+        for chunk in chunks[:-1]:
+            self._exchange(chunk)
+        return self._exchange_async(chunks[-1])
+
     def eip712_sign_new(self, bip32_path: str):
         return self._exchange_async(self._cmd_builder.eip712_sign_new(bip32_path))
 
@@ -184,6 +205,23 @@ class EthAppClient:
             self._exchange(chunk)
         return self._exchange(chunks[-1])
 
+    def provide_abi_descriptor(self,
+                               chain_id: int,
+                               address: bytes,
+                               selector: bytes,
+                               name: str,
+                               method: str,
+                               params: list[AbiParam],
+                               sig: Optional[bytes] = None) -> RAPDU:
+        payload = abi_descriptor_payload(chain_id, address, selector, name, method, params)
+        if sig is None:
+            sig = sign_data(Key.CAL, ABI_DESCRIPTOR_MAGIC + payload)
+        chunks = self._cmd_builder.provide_abi_descriptor(abi_descriptor_with_signature(payload,
+                                                                                        sig))
+        for chunk in chunks[:-1]:
+            self._exchange(chunk)
+        return self._exchange(chunks[-1])
+
     def set_plugin(self,
                    plugin_name: str,
                    contract_addr: bytes,
@@ -293,3 +331,40 @@ class EthAppClient:
                                                                                 decimals,
                                                                                 chain_id,
                                                                                 sig))
+
+    def provide_token_list_root(self, root: bytes, sig: Optional[bytes] = None) -> RAPDU:
+        if sig is None:
+            sig = sign_data(Key.CAL, TOKEN_LIST_MAGIC + root)
+        return self._exchange(self._cmd_builder.provide_erc20_token_list_root(root, sig))
+
+    def provide_token_list_entries(self, entries: list[tuple[bytes, list[bytes]]]) -> list[int]:
+        indexes = list()
+        for chunk in self._cmd_builder.provide_erc20_token_list_entries(entries):
+            indexes += list(self._exchange(chunk).data)
+        return indexes
+
+    # Provide several tokens with a single signature, returns the index of each of them
+    def provide_token_list(self, tokens: list[tuple[str, bytes, int, int]]) -> list[int]:
+        descriptors = [self._cmd_builder.erc20_token_descriptor(*token) for token in tokens]
+        tree = TokenListTree(descriptors)
+        self.provide_token_list_root(tree.root)
+        return self.provide_token_list_entries([(desc, tree.proof(idx))
+                                                for idx, desc in enumerate(descriptors)])
+
+    # Only supported by the apps built with PROFILING=1
+    def get_profiling_counters(self, reset: bool = True) -> list[ProfilingCounter]:
+        counters: list[ProfilingCounter] = list()
+        while True:
+            count, page = profiling_counters(
+                self._exchange(self._cmd_builder.get_profiling_counters(len(counters))).data)
+            counters += page
+            if (len(counters) >= count) or (len(page) == 0):
+                break
+        if reset:
+            self._exchange(self._cmd_builder.get_profiling_counters(len(counters), True))
+        return counters
+
+    # Only supported by the apps built with PROFILING=1, reset sets the high-water marks to the
+    # current usage
+    def get_memory_usage(self, reset: bool = True) -> MemoryUsage:
+        return memory_usage(self._exchange(self._cmd_builder.get_memory_usage(reset)).data)
@@ -24,6 +24,8 @@ class InsType(IntEnum):
     EIP712_SIGN = 0x0c
     GET_CHALLENGE = 0x20
     PROVIDE_DOMAIN_NAME = 0x22
+    PROVIDE_ABI_DESCRIPTOR = 0x24
+    GET_PROFILING_COUNTERS = 0xf0
     EXTERNAL_PLUGIN_SETUP = 0x12
 
 
@@ -32,12 +34,15 @@ class P1Type(IntEnum):
     PARTIAL_SEND = 0x01
     SIGN_FIRST_CHUNK = 0x00
     SIGN_SUBSQT_CHUNK = 0x80
+    ERC20_TOKEN_LIST_ROOT = 0x01
+    ERC20_TOKEN_LIST_ENTRIES = 0x02
 
 
 class P2Type(IntEnum):
     STRUCT_NAME = 0x00
     STRUCT_FIELD = 0xff
     ARRAY = 0x0f
+    STRUCT_IMPL_PACKED_FIELDS = 0xfe
     LEGACY_IMPLEM = 0x00
     NEW_IMPLEM = 0x01
     FILTERING_ACTIVATE = 0x00
@@ -46,6 +51,16 @@ class P2Type(IntEnum):
     FILTERING_TOKEN_ADDR_CHECK = 0xfd
     FILTERING_AMOUNT_FIELD = 0xfe
     FILTERING_RAW = 0xff
+    PROFILING_READ = 0x00
+    PROFILING_RESET = 0x01
+    PROFILING_MEM_READ = 0x02
+    PROFILING_MEM_RESET = 0x03
+
+
+# P2 of the struct definitions sent at once, apart from P2Type whose values they reuse
+class P2StructDefsType(IntEnum):
+    PACKED = 0x0f
+    SCHEMA_HASH = 0x01
 
 
 class CommandBuilder:
@@ -71,12 +86,12 @@ class CommandBuilder:
                                P2Type.STRUCT_NAME,
                                name.encode())
 
-    def eip712_send_struct_def_struct_field(self,
-                                            field_type: EIP712FieldType,
-                                            type_name: str,
-                                            type_size: int,
-                                            array_levels: list,
-                                            key_name: str) -> bytes:
+    def _eip712_struct_def_field_data(self,
+                                      field_type: EIP712FieldType,
+                                      type_name: str,
+                                      type_size: int,
+                                      array_levels: list,
+                                      key_name: str) -> bytes:
         data = bytearray()
         typedesc = 0
         typedesc |= (len(array_levels) > 0) << 7
@@ -96,10 +111,69 @@ class CommandBuilder:
                     data.append(level)
         data.append(len(key_name))
         data += key_name.encode()
+        return data
+
+    def eip712_send_struct_def_struct_field(self,
+                                            field_type: EIP712FieldType,
+                                            type_name: str,
+                                            type_size: int,
+                                            array_levels: list,
+                                            key_name: str) -> bytes:
         return self._serialize(InsType.EIP712_SEND_STRUCT_DEF,
                                P1Type.COMPLETE_SEND,
                                P2Type.STRUCT_FIELD,
-                               data)
+                               self._eip712_struct_def_field_data(field_type,
+                                                                  type_name,
+                                                                  type_size,
+                                                                  array_levels,
+                                                                  key_name))
+
+    def eip712_send_struct_defs_packed(self, structs: list[tuple[str, list[tuple]]]) -> list[bytes]:
+        """
+        Pack struct definitions in as few APDUs as possible
+
+        structs is a list of (name, fields), each field being the
+        (field_type, type_name, type_size, array_levels, key_name) of
+        eip712_send_struct_def_struct_field.
+        Each definition is the P2, LC and data of the APDU it replaces.
+        Raises ValueError if one of them does not fit in an APDU once packed.
+        """
+        defs = list()
+        for name, fields in structs:
+            defs.append(self._eip712_packed_def(P2Type.STRUCT_NAME, name.encode()))
+            for field in fields:
+                defs.append(self._eip712_packed_def(P2Type.STRUCT_FIELD,
+                                                    self._eip712_struct_def_field_data(*field)))
+        for definition in defs:
+            if len(definition) > 0xff:
+                raise ValueError(f"Struct definition of {len(definition) - 2} bytes too long to be "
+                                 "packed")
+        chunks = list()
+        data = bytearray()
+        for definition in defs:
+            # a definition can not be split across APDUs
+            if len(data) + len(definition) > 0xff:
+                chunks.append(data)
+                data = bytearray()
+            data += definition
+        if len(data) > 0:
+            chunks.append(data)
+        return [self._serialize(InsType.EIP712_SEND_STRUCT_DEF,
+                                P1Type.COMPLETE_SEND,
+                                P2StructDefsType.PACKED,
+                                chunk) for chunk in chunks]
+
+    def eip712_send_struct_defs_schema_hash(self, schema_hash: bytes) -> bytes:
+        return self._serialize(InsType.EIP712_SEND_STRUCT_DEF,
+                               P1Type.COMPLETE_SEND,
+                               P2StructDefsType.SCHEMA_HASH,
+                               schema_hash)
+
+    def _eip712_packed_def(self, def_type: P2Type, data: bytes) -> bytes:
+        packed = bytearray()
+        packed.append(def_type)
+        packed.append(len(data))
+        return packed + data
 
     def eip712_send_struct_impl_root_struct(self, name: str) -> bytes:
         return self._serialize(InsType.EIP712_SEND_STRUCT_IMPL,
@@ -131,6 +205,27 @@ class CommandBuilder:
             data_w_length = data_w_length[0xff:]
         return chunks
 
+    def eip712_send_struct_impl_packed_fields(self, values: list[bytes]) -> list[bytes]:
+        """
+        Pack consecutive field values in as few APDUs as possible
+
+        Each value is prefixed by its 16-bit length (network byte order)
+        and can not be split across APDUs.
+        """
+        chunks = list()
+        data = bytearray()
+        for value in values:
+            if len(data) + 2 + len(value) > 0xff:
+                chunks.append(data)
+                data = bytearray()
+            data += len(value).to_bytes(2, "big") + value
+        if len(data) > 0:
+            chunks.append(data)
+        return [self._serialize(InsType.EIP712_SEND_STRUCT_IMPL,
+                                P1Type.COMPLETE_SEND,
+                                P2Type.STRUCT_IMPL_PACKED_FIELDS,
+                                chunk) for chunk in chunks]
+
     def eip712_sign_new(self, bip32_path: str) -> bytes:
         data = pack_derivation_path(bip32_path)
         return self._serialize(InsType.EIP712_SIGN,
@@ -264,6 +359,30 @@ class CommandBuilder:
             p1 = 0
         return chunks
 
+    def provide_abi_descriptor(self, descriptor: bytes) -> list[bytes]:
+        chunks = list()
+        payload = struct.pack(">H", len(descriptor))
+        payload += descriptor
+        p1 = 1
+        while len(payload) > 0:
+            chunks.append(self._serialize(InsType.PROVIDE_ABI_DESCRIPTOR,
+                                          p1,
+                                          0x00,
+                                          payload[:0xff]))
+            payload = payload[0xff:]
+            p1 = 0
+        return chunks
+
+    def get_profiling_counters(self, first: int, reset: bool = False) -> bytes:
+        return self._serialize(InsType.GET_PROFILING_COUNTERS,
+                               first,
+                               P2Type.PROFILING_RESET if reset else P2Type.PROFILING_READ)
+
+    def get_memory_usage(self, reset: bool = False) -> bytes:
+        return self._serialize(InsType.GET_PROFILING_COUNTERS,
+                               0x00,
+                               P2Type.PROFILING_MEM_RESET if reset else P2Type.PROFILING_MEM_READ)
+
     def get_public_addr(self,
                         display: bool,
                         chaincode: bool,
@@ -358,20 +477,64 @@ class CommandBuilder:
             p1 = P1Type.SIGN_SUBSQT_CHUNK
         return chunks
 
-    def provide_erc20_token_information(self,
-                                        ticker: str,
-                                        addr: bytes,
-                                        decimals: int,
-                                        chain_id: int,
-                                        sig: bytes) -> bytes:
+    def erc20_token_descriptor(self,
+                               ticker: str,
+                               addr: bytes,
+                               decimals: int,
+                               chain_id: int) -> bytes:
         payload = bytearray()
         payload.append(len(ticker))
         payload += ticker.encode()
         payload += addr
         payload += struct.pack(">I", decimals)
         payload += struct.pack(">I", chain_id)
+        return payload
+
+    def provide_erc20_token_information(self,
+                                        ticker: str,
+                                        addr: bytes,
+                                        decimals: int,
+                                        chain_id: int,
+                                        sig: bytes) -> bytes:
+        payload = self.erc20_token_descriptor(ticker, addr, decimals, chain_id)
         payload += sig
         return self._serialize(InsType.PROVIDE_ERC20_TOKEN_INFORMATION,
                                0x00,
                                0x00,
                                payload)
+
+    def provide_erc20_token_list_root(self, root: bytes, sig: bytes) -> bytes:
+        return self._serialize(InsType.PROVIDE_ERC20_TOKEN_INFORMATION,
+                               P1Type.ERC20_TOKEN_LIST_ROOT,
+                               0x00,
+                               root + sig)
+
+    # Pack as many (descriptor, proof) entries as possible in each APDU, without exceeding the
+    # number of tokens the app keeps (5 on Nano S)
+    def provide_erc20_token_list_entries(self,
+                                         entries: list[tuple[bytes, list[bytes]]],
+                                         max_per_apdu: int = 5) -> list[bytes]:
+        chunks = list()
+        payload = bytearray()
+        count = 0
+        for desc, proof in entries:
+            entry = bytearray(desc)
+            entry.append(len(proof))
+            for node in proof:
+                entry += node
+            assert len(entry) <= 0xff
+            if (len(payload) + len(entry) > 0xff) or (count == max_per_apdu):
+                chunks.append(self._serialize(InsType.PROVIDE_ERC20_TOKEN_INFORMATION,
+                                              P1Type.ERC20_TOKEN_LIST_ENTRIES,
+                                              0x00,
+                                              payload))
+                payload = bytearray()
+                count = 0
+            payload += entry
+            count += 1
+        if count > 0:
+            chunks.append(self._serialize(InsType.PROVIDE_ERC20_TOKEN_INFORMATION,
+                                          P1Type.ERC20_TOKEN_LIST_ENTRIES,
+                                          0x00,
+                                          payload))
+        return chunks
@@ -3,12 +3,15 @@ import json
 import re
 import signal
 import sys
+import time
 import copy
 from typing import Any, Callable, Optional, Union
 import struct
 
+from ragger.error import ExceptionRAPDU
+
 from client import keychain
-from client.client import EthAppClient, EIP712FieldType
+from client.client import EthAppClient, EIP712FieldType, StatusWord
 
 
 # global variables
@@ -16,6 +19,10 @@ app_client: EthAppClient = None
 filtering_paths: dict = {}
 current_path: list[str] = list()
 sig_ctx: dict[str, Any] = {}
+# APDUs and time taken by the types definition of the last processed data
+schema_upload: dict[str, Union[int, float]] = {}
+# whether the elements of the arrays of primitives are packed
+pack_arrays: bool = False
 
 
 def default_handler():
@@ -98,7 +105,7 @@ parsing_type_functions["string"] = parse_string
 parsing_type_functions["bytes"] = parse_bytes
 
 
-def send_struct_def_field(typename, keyname):
+def parse_struct_def_field(typename):
     type_enum = None
 
     (typename, array_lvls) = get_array_levels(typename)
@@ -109,6 +116,11 @@ def send_struct_def_field(typename, keyname):
     else:
         type_enum = EIP712FieldType.CUSTOM
         typesize = None
+    return (typename, type_enum, typesize, array_lvls)
+
+
+def send_struct_def_field(typename, keyname):
+    (typename, type_enum, typesize, array_lvls) = parse_struct_def_field(typename)
 
     with app_client.eip712_send_struct_def_struct_field(type_enum,
                                                         typename,
@@ -119,6 +131,52 @@ def send_struct_def_field(typename, keyname):
     return (typename, type_enum, typesize, array_lvls)
 
 
+# Send the types definition, one APDU per struct name and per field or packed
+# Returns the number of APDUs it took
+def send_struct_defs(types, packed: bool) -> int:
+    if packed:
+        try:
+            return send_struct_defs_packed(types)
+        except ValueError:
+            # a definition too long to be packed, none was sent
+            pass
+    for key in types.keys():
+        with app_client.eip712_send_struct_def_struct_name(key):
+            pass
+        for f in types[key]:
+            (f["type"], f["enum"], f["typesize"], f["array_lvls"]) = \
+             send_struct_def_field(f["type"], f["name"])
+    return len(types) + sum(len(fields) for fields in types.values())
+
+
+def send_struct_defs_packed(types) -> int:
+    # the types are only updated once sent, for them to be sent again unpacked otherwise
+    parsed = {key: [parse_struct_def_field(f["type"]) for f in types[key]] for key in types.keys()}
+    structs = list()
+    for key in types.keys():
+        fields = list()
+        for f, (typename, type_enum, typesize, array_lvls) in zip(types[key], parsed[key]):
+            fields.append((type_enum, typename, typesize, array_lvls, f["name"]))
+        structs.append((key, fields))
+    apdus = app_client.eip712_send_struct_defs_packed(structs)
+    for key in types.keys():
+        for f, field in zip(types[key], parsed[key]):
+            (f["type"], f["enum"], f["typesize"], f["array_lvls"]) = field
+    return apdus
+
+
+# Send the schema hash instead of the types definition
+# Returns whether the app had it in its schema cache
+def send_schema_hash(types) -> bool:
+    try:
+        app_client.eip712_send_struct_defs_schema_hash(get_schema_hash(types))
+    except ExceptionRAPDU as e:
+        if e.status != StatusWord.REF_DATA_NOT_FOUND:
+            raise
+        return False
+    return True
+
+
 def encode_integer(value: Union[str | int], typesize: int) -> bytes:
     # Some are already represented as integers in the JSON, but most as strings
     if isinstance(value, str):
@@ -217,6 +275,29 @@ def send_struct_impl_field(value, field):
     disable_autonext()
 
 
+def send_struct_impl_packed_fields(data, field) -> bool:
+    # only the elements that are neither shown nor filtered can be packed
+    if not pack_arrays or len(data) < 2:
+        return False
+    if ".".join(current_path + ["[]"]) in filtering_paths.keys():
+        return False
+    values = [encoding_functions[field["enum"]](value, field["typesize"]) for value in data]
+    if any(len(value) > (0xff - 2) for value in values):
+        return False
+
+    try:
+        with app_client.eip712_send_struct_impl_packed_fields(values):
+            enable_autonext()
+    except ExceptionRAPDU as e:
+        # refused without being hashed since the fields are shown (verbose mode)
+        if e.status != StatusWord.COMMAND_NOT_ALLOWED:
+            raise
+        return False
+    finally:
+        disable_autonext()
+    return True
+
+
 def evaluate_field(structs, data, field, lvls_left, new_level=True):
     array_lvls = field["array_lvls"]
 
@@ -226,12 +307,16 @@ def evaluate_field(structs, data, field, lvls_left, new_level=True):
         with app_client.eip712_send_struct_impl_array(len(data)):
             pass
         idx = 0
-        for subdata in data:
-            current_path.append("[]")
-            if not evaluate_field(structs, subdata, field, lvls_left - 1, False):
-                return False
-            current_path.pop()
-            idx += 1
+        if lvls_left == 1 and field["enum"] != EIP712FieldType.CUSTOM and \
+           send_struct_impl_packed_fields(data, field):
+            idx = len(data)
+        else:
+            for subdata in data:
+                current_path.append("[]")
+                if not evaluate_field(structs, subdata, field, lvls_left - 1, False):
+                    return False
+                current_path.pop()
+                idx += 1
         if array_lvls[lvls_left - 1] is not None:
             if array_lvls[lvls_left - 1] != idx:
                 print("Mismatch in array size! Got %d, expected %d\n" %
@@ -375,9 +460,12 @@ def init_signature_context(types, domain):
     for i in range(8):
         sig_ctx["chainid"].append(chainid & (0xff << (i * 8)))
     sig_ctx["chainid"].reverse()
+    sig_ctx["schema_hash"] = bytearray(get_schema_hash(types))
+
+
+def get_schema_hash(types) -> bytes:
     schema_str = json.dumps(types).replace(" ", "")
-    schema_hash = hashlib.sha224(schema_str.encode())
-    sig_ctx["schema_hash"] = bytearray.fromhex(schema_hash.hexdigest())
+    return hashlib.sha224(schema_str.encode()).digest()
 
 
 def next_timeout(_signum: int, _frame):
@@ -399,10 +487,15 @@ def disable_autonext():
 def process_data(aclient: EthAppClient,
                  data_json: dict,
                  filters: Optional[dict] = None,
-                 autonext: Optional[Callable] = None) -> bool:
+                 autonext: Optional[Callable] = None,
+                 packed_schema: bool = False,
+                 cached_schema: bool = False,
+                 packed_arrays: bool = False) -> bool:
     global sig_ctx
     global app_client
     global autonext_handler
+    global schema_upload
+    global pack_arrays
 
     # deepcopy because this function modifies the dict
     data_json = copy.deepcopy(data_json)
@@ -421,19 +514,20 @@ def process_data(aclient: EthAppClient,
         init_signature_context(types, domain)
 
     # send types definition
-    for key in types.keys():
-        with app_client.eip712_send_struct_def_struct_name(key):
-            pass
-        for f in types[key]:
-            (f["type"], f["enum"], f["typesize"], f["array_lvls"]) = \
-             send_struct_def_field(f["type"], f["name"])
+    start = time.perf_counter()
+    if cached_schema and send_schema_hash(types):
+        apdus = 1
+    else:
+        apdus = send_struct_defs(types, packed_schema)
+    schema_upload = {"apdus": apdus, "seconds": time.perf_counter() - start}
 
     if filters:
         with app_client.eip712_filtering_activate():
             pass
         prepare_filtering(filters, message)
 
-    # send domain implementation
+    # send domain implementation, its fields being reviewed one by one
+    pack_arrays = False
     with app_client.eip712_send_struct_impl_root_struct(domain_typename):
         enable_autonext()
     disable_autonext()
@@ -447,6 +541,7 @@ def process_data(aclient: EthAppClient,
             send_filtering_message_info(domain["name"], len(filtering_paths))
 
     # send message implementation
+    pack_arrays = packed_arrays
     with app_client.eip712_send_struct_impl_root_struct(message_typename):
         enable_autonext()
     disable_autonext()
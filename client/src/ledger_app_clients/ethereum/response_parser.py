@@ -1,3 +1,19 @@
+from typing import NamedTuple
+
+
+class ProfilingCounter(NamedTuple):
+    name: str
+    id: int  # plugin message, 0 for the other spans
+    calls: int
+
+
+class MemoryUsage(NamedTuple):
+    size: int
+    used: int
+    high_water: int
+    tags_high_water: list[int]  # other, EIP-712 context, types & message, domain name, ABI
+
+
 def signature(data: bytes) -> tuple[bytes, bytes, bytes]:
     assert len(data) == (1 + 32 + 32)
 
@@ -50,3 +66,28 @@ def pk_addr(data: bytes, has_chaincode: bool = False):
         return None
 
     return pk, bytes.fromhex(addr.decode()), chaincode
+
+
+def profiling_counters(data: bytes) -> tuple[int, list[ProfilingCounter]]:
+    count = data[0]
+    counters = list()
+    idx = 1
+    while idx < len(data):
+        name_len = data[idx]
+        idx += 1
+        name = data[idx:idx + name_len].decode()
+        idx += name_len
+        counters.append(ProfilingCounter(name,
+                                         int.from_bytes(data[idx:idx + 2], "big"),
+                                         int.from_bytes(data[idx + 2:idx + 6], "big")))
+        idx += 6
+    return count, counters
+
+
+def memory_usage(data: bytes) -> MemoryUsage:
+    tags_count = data[6]
+    return MemoryUsage(int.from_bytes(data[0:2], "big"),
+                       int.from_bytes(data[2:4], "big"),
+                       int.from_bytes(data[4:6], "big"),
+                       [int.from_bytes(data[7 + i * 2:9 + i * 2], "big")
+                        for i in range(tags_count)])
@@ -10,6 +10,7 @@ class SettingID(Enum):
     NONCE = auto()
     VERBOSE_EIP712 = auto()
     VERBOSE_ENS = auto()
+    TOKEN_STORE = auto()
 
 
 def get_device_settings(device: str) -> list[SettingID]:
@@ -25,7 +26,8 @@ def get_device_settings(device: str) -> list[SettingID]:
             SettingID.DEBUG_DATA,
             SettingID.NONCE,
             SettingID.VERBOSE_EIP712,
-            SettingID.VERBOSE_ENS
+            SettingID.VERBOSE_ENS,
+            SettingID.TOKEN_STORE
         ]
     return []
 
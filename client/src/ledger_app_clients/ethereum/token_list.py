@@ -0,0 +1,49 @@
+import hashlib
+
+
+# Prefix of the signed token list roots
+TOKEN_LIST_MAGIC = b"ERC20 LIST"
+
+_LEAF_TAG = b"\x00"
+_NODE_TAG = b"\x01"
+
+
+def _sha256(data: bytes) -> bytes:
+    return hashlib.sha256(data).digest()
+
+
+def _hash_node(left: bytes, right: bytes) -> bytes:
+    return _sha256(_NODE_TAG + min(left, right) + max(left, right))
+
+
+# Merkle tree over ERC-20 token descriptors (as sent to the app, ticker length included)
+#
+# The pairs of nodes are hashed in ascending order so that the proofs do not need to tell on which
+# side each sibling is, an odd node being carried over to the next level as-is.
+class TokenListTree:
+    def __init__(self, descriptors: list[bytes]):
+        assert len(descriptors) > 0
+        # the ticker length is not part of the leaf, like it is not part of the signed payload
+        self._levels = [[_sha256(_LEAF_TAG + desc[1:]) for desc in descriptors]]
+        while len(self._levels[-1]) > 1:
+            level = self._levels[-1]
+            parents = list()
+            for idx in range(0, len(level), 2):
+                if (idx + 1) < len(level):
+                    parents.append(_hash_node(level[idx], level[idx + 1]))
+                else:
+                    parents.append(level[idx])
+            self._levels.append(parents)
+
+    @property
+    def root(self) -> bytes:
+        return self._levels[-1][0]
+
+    def proof(self, index: int) -> list[bytes]:
+        proof = list()
+        for level in self._levels[:-1]:
+            sibling = index ^ 1
+            if sibling < len(level):
+                proof.append(level[sibling])
+            index //= 2
+        return proof
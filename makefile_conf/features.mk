@@ -18,6 +18,19 @@ ifneq ($(SET_PLUGIN_TEST_KEY),0)
     DEFINES += HAVE_SET_PLUGIN_TEST_KEY
 endif
 
+# Use cx_math_mult for the 256-bit multiplications instead of the native implementation
+CX_MULT256 ?= 0
+ifneq ($(CX_MULT256),0)
+    DEFINES += HAVE_CX_MULT256
+endif
+
+# Count the calls of the parser, plugin messages and EIP-712 handlers, read with the
+# GET PROFILING COUNTERS debug command
+PROFILING ?= 0
+ifneq ($(PROFILING),0)
+    DEFINES += HAVE_PROFILING
+endif
+
 # NFTs
 ifneq ($(TARGET_NAME),TARGET_NANOS)
     DEFINES	+= HAVE_NFT_SUPPORT
@@ -32,9 +45,15 @@ ifneq ($(TARGET_NAME),TARGET_NANOS)
     endif
 endif
 
-# Dynamic memory allocator
+# Dynamic memory allocator, its buffer size (bytes) being set per target
 ifneq ($(TARGET_NAME),TARGET_NANOS)
     DEFINES += HAVE_DYN_MEM_ALLOC
+    ifeq ($(TARGET_NAME),TARGET_NANOX)
+        MEM_SIZE ?= 8192
+    else
+        MEM_SIZE ?= 10240
+    endif
+    DEFINES += MEM_SIZE=$(MEM_SIZE)
 endif
 
 # EIP-712
@@ -42,6 +61,55 @@ ifneq ($(TARGET_NAME),TARGET_NANOS)
     DEFINES	+= HAVE_EIP712_FULL_SUPPORT
 endif
 
+# EIP-712 struct definitions kept for the next messages of the same schema, off by default as it
+# takes EIP712_SCHEMA_CACHE_SIZE entries of RAM, in flash across sessions with
+# EIP712_SCHEMA_CACHE_NVM=1 instead
+EIP712_SCHEMA_CACHE ?= 0
+ifneq ($(EIP712_SCHEMA_CACHE),0)
+    ifneq ($(TARGET_NAME),TARGET_NANOS)
+        DEFINES += HAVE_EIP712_SCHEMA_CACHE
+        EIP712_SCHEMA_CACHE_SIZE ?= 3
+        DEFINES += EIP712_SCHEMA_CACHE_SIZE=$(EIP712_SCHEMA_CACHE_SIZE)
+        EIP712_SCHEMA_CACHE_NVM ?= 0
+        ifneq ($(EIP712_SCHEMA_CACHE_NVM),0)
+            DEFINES += HAVE_EIP712_SCHEMA_CACHE_NVM
+        endif
+    endif
+endif
+
+# Number of token/NFT descriptions kept during a transaction
+ifeq ($(TARGET_NAME),TARGET_NANOS)
+    ASSETS_CACHE_SIZE ?= 5
+else
+    ASSETS_CACHE_SIZE ?= 16
+endif
+DEFINES += MAX_ASSETS=$(ASSETS_CACHE_SIZE)
+
+# Number of successful signature verifications remembered during the session
+ifeq ($(TARGET_NAME),TARGET_NANOS)
+    SIG_CACHE_SIZE ?= 4
+else
+    SIG_CACHE_SIZE ?= 8
+endif
+DEFINES += SIG_CACHE_SIZE=$(SIG_CACHE_SIZE)
+
+# Verified tokens kept in flash across sessions
+ifneq ($(TARGET_NAME),TARGET_NANOS)
+    DEFINES += HAVE_TOKEN_STORE
+    TOKEN_STORE_SIZE ?= 32
+    DEFINES += TOKEN_STORE_SIZE=$(TOKEN_STORE_SIZE)
+endif
+
+# Clear signing of the methods described by a signed ABI descriptor
+ifneq ($(TARGET_NAME),TARGET_NANOS)
+    DEFINES += HAVE_ABI_DESCRIPTOR
+endif
+
+# Clear signing of the calls of the multicall & Safe multiSend batches
+ifneq ($(TARGET_NAME),TARGET_NANOS)
+    DEFINES += HAVE_MULTICALL
+endif
+
 # CryptoAssetsList key
 CAL_TEST_KEY ?= 0
 ifneq ($(CAL_TEST_KEY),0)
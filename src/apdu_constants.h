@@ -24,6 +24,8 @@
 #define INS_EIP712_FILTERING                0x1E
 #define INS_ENS_GET_CHALLENGE               0x20
 #define INS_ENS_PROVIDE_INFO                0x22
+#define INS_PROVIDE_ABI_DESCRIPTOR          0x24
+#define INS_GET_PROFILING_COUNTERS          0xF0
 #define P1_CONFIRM                          0x01
 #define P1_NON_CONFIRM                      0x00
 #define P2_NO_CHAINCODE                     0x00
@@ -32,6 +34,9 @@
 #define P1_MORE                             0x80
 #define P2_EIP712_LEGACY_IMPLEM             0x00
 #define P2_EIP712_FULL_IMPLEM               0x01
+#define P1_ERC20_TOKEN                      0x00
+#define P1_ERC20_TOKEN_LIST_ROOT            0x01
+#define P1_ERC20_TOKEN_LIST_ENTRIES         0x02
 
 #define COMMON_CLA 0xB0
 
@@ -42,6 +47,7 @@
 #define APDU_RESPONSE_INVALID_INS             0x6d00
 #define APDU_RESPONSE_INVALID_P1_P2           0x6b00
 #define APDU_RESPONSE_CONDITION_NOT_SATISFIED 0x6985
+#define APDU_RESPONSE_COMMAND_NOT_ALLOWED     0x6986
 #define APDU_RESPONSE_REF_DATA_NOT_FOUND      0x6a88
 #define APDU_RESPONSE_UNKNOWN                 0x6f00
 
@@ -112,6 +118,28 @@ void handlePerformPrivacyOperation(uint8_t p1,
                                    unsigned int *flags,
                                    unsigned int *tx);
 
+#ifdef HAVE_ABI_DESCRIPTOR
+
+void handleProvideAbiDescriptor(uint8_t p1,
+                                uint8_t p2,
+                                const uint8_t *workBuffer,
+                                uint8_t dataLength,
+                                unsigned int *flags,
+                                unsigned int *tx);
+
+#endif  // HAVE_ABI_DESCRIPTOR
+
+#ifdef HAVE_PROFILING
+
+void handleGetProfilingCounters(uint8_t p1,
+                                uint8_t p2,
+                                const uint8_t *workBuffer,
+                                uint8_t dataLength,
+                                unsigned int *flags,
+                                unsigned int *tx);
+
+#endif  // HAVE_PROFILING
+
 #ifdef HAVE_ETH2
 
 void handleGetEth2PublicKey(uint8_t p1,
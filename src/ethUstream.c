@@ -15,6 +15,7 @@
  *  limitations under the License.
  ********************************************************************************/
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -51,9 +52,6 @@ uint8_t readTxByte(txContext_t *context) {
     if (context->processingField) {
         context->currentFieldPos++;
     }
-    if (!(context->processingField && context->fieldSingleByte)) {
-        CX_ASSERT(cx_hash_no_throw((cx_hash_t *) context->sha3, 0, &data, 1, NULL, 0));
-    }
     return data;
 }
 
@@ -65,10 +63,6 @@ void copyTxData(txContext_t *context, uint8_t *out, uint32_t length) {
     if (out != NULL) {
         memmove(out, context->workBuffer, length);
     }
-    if (!(context->processingField && context->fieldSingleByte)) {
-        CX_ASSERT(
-            cx_hash_no_throw((cx_hash_t *) context->sha3, 0, context->workBuffer, length, NULL, 0));
-    }
     context->workBuffer += length;
     context->commandLength -= length;
     if (context->processingField) {
@@ -76,445 +70,469 @@ void copyTxData(txContext_t *context, uint8_t *out, uint32_t length) {
     }
 }
 
-static void processContent(txContext_t *context) {
-    // Keep the full length for sanity checks, move to the next field
-    if (!context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_CONTENT\n");
-        THROW(EXCEPTION);
-    }
-    context->dataLength = context->currentFieldLength;
-    context->currentField++;
-    context->processingField = false;
+// Feed everything consumed since the last call to the hash in a single call
+static void hashConsumedData(txContext_t *context) {
+    if (context->workBuffer > context->hashBuffer) {
+        CX_ASSERT(cx_hash_no_throw((cx_hash_t *) context->sha3,
+                                   0,
+                                   context->hashBuffer,
+                                   context->workBuffer - context->hashBuffer,
+                                   NULL,
+                                   0));
+    }
+    context->hashBuffer = context->workBuffer;
 }
 
-static void processAccessList(txContext_t *context) {
-    if (!context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_ACCESS_LIST\n");
-        THROW(EXCEPTION);
+#define INT256_FIELD(member)                                 \
+    {                                                        \
+        .kind = RLP_FIELD_COPY, .maxLength = MAX_INT256,     \
+        .valueOffset = offsetof(txContent_t, member.value),  \
+        .lengthOffset = offsetof(txContent_t, member.length) \
     }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, NULL, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->currentField++;
-        context->processingField = false;
-    }
-}
 
-static void processType(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_TYPE\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldLength > MAX_INT256) {
-        PRINTF("Invalid length for RLP_TYPE\n");
-        THROW(EXCEPTION);
+// Hit only by Wanchain, skipped when TX_FLAG_TYPE is not set
+#define TYPE_FIELD \
+    { .kind = RLP_FIELD_SKIP, .maxLength = MAX_INT256 }
+
+#define TO_FIELD                                                 \
+    {                                                            \
+        .kind = RLP_FIELD_COPY, .maxLength = MAX_ADDRESS,        \
+        .valueOffset = offsetof(txContent_t, destination),       \
+        .lengthOffset = offsetof(txContent_t, destinationLength) \
     }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, NULL, copySize);
+
+#define ACCESS_LIST_FIELD \
+    { .kind = RLP_FIELD_WALK_LIST, .list = RLP_LIST_ACCESS_LIST }
+
+// Blob and set code transactions can not create a contract
+#define MANDATORY_TO_FIELD                                                           \
+    {                                                                                \
+        .kind = RLP_FIELD_COPY, .flags = RLP_FIELD_FLAG_FIXED_LENGTH,                \
+        .maxLength = MAX_ADDRESS, .valueOffset = offsetof(txContent_t, destination), \
+        .lengthOffset = offsetof(txContent_t, destinationLength)                     \
     }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->currentField++;
-        context->processingField = false;
+
+static const rlpFieldDescriptor_t LEGACY_FIELDS[LEGACY_RLP_DONE] = {
+    [LEGACY_RLP_CONTENT] = {.kind = RLP_FIELD_CONTENT},
+    [LEGACY_RLP_TYPE] = TYPE_FIELD,
+    [LEGACY_RLP_NONCE] = INT256_FIELD(nonce),
+    [LEGACY_RLP_GASPRICE] = INT256_FIELD(gasprice),
+    [LEGACY_RLP_STARTGAS] = INT256_FIELD(startgas),
+    [LEGACY_RLP_TO] = TO_FIELD,
+    [LEGACY_RLP_VALUE] = INT256_FIELD(value),
+    [LEGACY_RLP_DATA] = {.kind = RLP_FIELD_DATA},
+    [LEGACY_RLP_V] = {.kind = RLP_FIELD_COPY,
+                      .flags = RLP_FIELD_FLAG_OPTIONAL,
+                      .maxLength = sizeof(((txContent_t *) NULL)->v),
+                      .valueOffset = offsetof(txContent_t, v),
+                      .lengthOffset = offsetof(txContent_t, vLength)},
+    [LEGACY_RLP_R] = {.kind = RLP_FIELD_SKIP},
+    [LEGACY_RLP_S] = {.kind = RLP_FIELD_SKIP},
+};
+
+static const rlpFieldDescriptor_t EIP2930_FIELDS[EIP2930_RLP_DONE] = {
+    [EIP2930_RLP_CONTENT] = {.kind = RLP_FIELD_CONTENT},
+    [EIP2930_RLP_TYPE] = TYPE_FIELD,
+    [EIP2930_RLP_CHAINID] = INT256_FIELD(chainID),
+    [EIP2930_RLP_NONCE] = INT256_FIELD(nonce),
+    [EIP2930_RLP_GASPRICE] = INT256_FIELD(gasprice),
+    [EIP2930_RLP_GASLIMIT] = INT256_FIELD(startgas),
+    [EIP2930_RLP_TO] = TO_FIELD,
+    [EIP2930_RLP_VALUE] = INT256_FIELD(value),
+    [EIP2930_RLP_DATA] = {.kind = RLP_FIELD_DATA},
+    [EIP2930_RLP_ACCESS_LIST] = ACCESS_LIST_FIELD,
+};
+
+static const rlpFieldDescriptor_t EIP1559_FIELDS[EIP1559_RLP_DONE] = {
+    [EIP1559_RLP_CONTENT] = {.kind = RLP_FIELD_CONTENT},
+    [EIP1559_RLP_TYPE] = TYPE_FIELD,
+    [EIP1559_RLP_CHAINID] = INT256_FIELD(chainID),
+    [EIP1559_RLP_NONCE] = INT256_FIELD(nonce),
+    [EIP1559_RLP_MAX_PRIORITY_FEE_PER_GAS] = {.kind = RLP_FIELD_SKIP},
+    // Stored as the gas price, it is what is used to compute the max fees
+    [EIP1559_RLP_MAX_FEE_PER_GAS] = INT256_FIELD(gasprice),
+    [EIP1559_RLP_GASLIMIT] = INT256_FIELD(startgas),
+    [EIP1559_RLP_TO] = TO_FIELD,
+    [EIP1559_RLP_VALUE] = INT256_FIELD(value),
+    [EIP1559_RLP_DATA] = {.kind = RLP_FIELD_DATA},
+    [EIP1559_RLP_ACCESS_LIST] = ACCESS_LIST_FIELD,
+};
+
+static const rlpFieldDescriptor_t EIP4844_FIELDS[EIP4844_RLP_DONE] = {
+    [EIP4844_RLP_CONTENT] = {.kind = RLP_FIELD_CONTENT},
+    [EIP4844_RLP_TYPE] = TYPE_FIELD,
+    [EIP4844_RLP_CHAINID] = INT256_FIELD(chainID),
+    [EIP4844_RLP_NONCE] = INT256_FIELD(nonce),
+    [EIP4844_RLP_MAX_PRIORITY_FEE_PER_GAS] = {.kind = RLP_FIELD_SKIP},
+    [EIP4844_RLP_MAX_FEE_PER_GAS] = INT256_FIELD(gasprice),
+    [EIP4844_RLP_GASLIMIT] = INT256_FIELD(startgas),
+    [EIP4844_RLP_TO] = MANDATORY_TO_FIELD,
+    [EIP4844_RLP_VALUE] = INT256_FIELD(value),
+    [EIP4844_RLP_DATA] = {.kind = RLP_FIELD_DATA},
+    [EIP4844_RLP_ACCESS_LIST] = ACCESS_LIST_FIELD,
+    [EIP4844_RLP_MAX_FEE_PER_BLOB_GAS] =
+        {.kind = RLP_FIELD_COPY,
+         .flags = RLP_FIELD_FLAG_SUMMARY,
+         .maxLength = MAX_INT256,
+         .valueOffset = offsetof(txSummary_t, maxFeePerBlobGas.value),
+         .lengthOffset = offsetof(txSummary_t, maxFeePerBlobGas.length)},
+    [EIP4844_RLP_BLOB_VERSIONED_HASHES] = {.kind = RLP_FIELD_WALK_LIST,
+                                           .list = RLP_LIST_BLOB_VERSIONED_HASHES},
+};
+
+static const rlpFieldDescriptor_t EIP7702_FIELDS[EIP7702_RLP_DONE] = {
+    [EIP7702_RLP_CONTENT] = {.kind = RLP_FIELD_CONTENT},
+    [EIP7702_RLP_TYPE] = TYPE_FIELD,
+    [EIP7702_RLP_CHAINID] = INT256_FIELD(chainID),
+    [EIP7702_RLP_NONCE] = INT256_FIELD(nonce),
+    [EIP7702_RLP_MAX_PRIORITY_FEE_PER_GAS] = {.kind = RLP_FIELD_SKIP},
+    [EIP7702_RLP_MAX_FEE_PER_GAS] = INT256_FIELD(gasprice),
+    [EIP7702_RLP_GASLIMIT] = INT256_FIELD(startgas),
+    [EIP7702_RLP_TO] = MANDATORY_TO_FIELD,
+    [EIP7702_RLP_VALUE] = INT256_FIELD(value),
+    [EIP7702_RLP_DATA] = {.kind = RLP_FIELD_DATA},
+    [EIP7702_RLP_ACCESS_LIST] = ACCESS_LIST_FIELD,
+    [EIP7702_RLP_AUTHORIZATION_LIST] = {.kind = RLP_FIELD_WALK_LIST,
+                                        .list = RLP_LIST_AUTHORIZATIONS},
+};
+
+// Resolved from the code rather than stored in a const table of pointers, so no PIC is needed
+static bool selectTxFields(txContext_t *context) {
+    switch (context->txType) {
+        case LEGACY:
+            context->fields = LEGACY_FIELDS;
+            context->fieldCount = ARRAYLEN(LEGACY_FIELDS);
+            break;
+        case EIP2930:
+            context->fields = EIP2930_FIELDS;
+            context->fieldCount = ARRAYLEN(EIP2930_FIELDS);
+            break;
+        case EIP1559:
+            context->fields = EIP1559_FIELDS;
+            context->fieldCount = ARRAYLEN(EIP1559_FIELDS);
+            break;
+        case EIP4844:
+            context->fields = EIP4844_FIELDS;
+            context->fieldCount = ARRAYLEN(EIP4844_FIELDS);
+            break;
+        case EIP7702:
+            context->fields = EIP7702_FIELDS;
+            context->fieldCount = ARRAYLEN(EIP7702_FIELDS);
+            break;
+        default:
+            PRINTF("Transaction type %d is not supported\n", context->txType);
+            return false;
     }
+    return true;
 }
 
-static void processChainID(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_CHAINID\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldLength > MAX_INT256) {
-        PRINTF("Invalid length for RLP_CHAINID\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, context->content->chainID.value, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->chainID.length = context->currentFieldLength;
-        context->currentField++;
-        context->processingField = false;
-    }
+static void nextField(txContext_t *context) {
+    context->currentField++;
+    context->processingField = false;
 }
 
-static void processNonce(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_NONCE\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldLength > MAX_INT256) {
-        PRINTF("Invalid length for RLP_NONCE\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, context->content->nonce.value, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->nonce.length = context->currentFieldLength;
-        context->currentField++;
-        context->processingField = false;
+static uint8_t *fieldDestination(txContext_t *context, const rlpFieldDescriptor_t *field) {
+    if (field->flags & RLP_FIELD_FLAG_SUMMARY) {
+        return (uint8_t *) &context->summary;
     }
+    return (uint8_t *) context->content;
 }
 
-static void processStartGas(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_STARTGAS\n");
+// Decodes the RLP header found at the current position, going through rlpBuffer when it is split
+// across two chunks. Returns false if the end of the chunk is reached before it can be decoded.
+// A self encoded single byte is not consumed, it is then read again as the item content.
+static bool readRLPHeader(txContext_t *context, uint32_t *length, bool *isList) {
+    const uint8_t *header = context->rlpBuffer;
+    bool valid;
+    uint32_t offset;
+
+    if ((context->rlpBufferPos == 0) && (context->commandLength != 0) &&
+        rlpCanDecode(context->workBuffer, context->commandLength, &valid)) {
+        // Fast path, the whole header is available : decode it in place
+        header = context->workBuffer;
+    } else {
+        // Feed the RLP buffer until the length can be decoded
+        do {
+            if (context->commandLength == 0) {
+                return false;
+            }
+            if (context->rlpBufferPos == sizeof(context->rlpBuffer)) {
+                PRINTF("RLP pre-decode logic error\n");
+                THROW(EXCEPTION);
+            }
+            context->rlpBuffer[context->rlpBufferPos++] = readTxByte(context);
+        } while (!rlpCanDecode(context->rlpBuffer, context->rlpBufferPos, &valid));
+    }
+    if (!valid) {
+        PRINTF("RLP pre-decode error\n");
         THROW(EXCEPTION);
     }
-    if (context->currentFieldLength > MAX_INT256) {
-        PRINTF("Invalid length for RLP_STARTGAS %d\n", context->currentFieldLength);
+    if (!rlpDecodeLength(header, length, &offset, isList)) {
+        PRINTF("RLP decode error\n");
         THROW(EXCEPTION);
     }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, context->content->startgas.value + context->currentFieldPos, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->startgas.length = context->currentFieldLength;
-        context->currentField++;
-        context->processingField = false;
+    if (header == context->workBuffer) {
+        copyTxData(context, NULL, offset);
     }
+    // Only multi-byte headers can be split, the buffered bytes always are the whole header
+    context->rlpBufferPos = 0;
+    return true;
 }
 
-// Alias over `processStartGas()`.
-static void processGasLimit(txContext_t *context) {
-    processStartGas(context);
-}
+// Items of an access list entry
+#define ACCESS_LIST_ADDRESS_INDEX 0
+#define ACCESS_LIST_KEYS_INDEX    1
+#define ACCESS_LIST_ENTRY_SIZE    2
+#define STORAGE_KEY_LENGTH        32
 
-static void processGasprice(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_GASPRICE\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldLength > MAX_INT256) {
-        PRINTF("Invalid length for RLP_GASPRICE\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, context->content->gasprice.value + context->currentFieldPos, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->gasprice.length = context->currentFieldLength;
-        context->currentField++;
-        context->processingField = false;
+// Position of the delegation address in an EIP-7702 authorization tuple
+#define AUTHORIZATION_ADDRESS_INDEX 1
+#define AUTHORIZATION_TUPLE_SIZE    6
+
+static void summarizeListItem(txContext_t *context, uint8_t kind, bool isList, uint32_t length) {
+    const rlpListState_t *list = &context->list;
+
+    switch (kind) {
+        case RLP_LIST_ACCESS_LIST:
+            // [[address, [storage_key, ...]], ...]
+            if (list->depth == 0) {
+                if (!isList) {
+                    PRINTF("Invalid access list entry\n");
+                    THROW(EXCEPTION);
+                }
+                context->summary.accessList.addresses++;
+            } else if (list->depth == 1) {
+                if ((list->index[1] == ACCESS_LIST_ADDRESS_INDEX)
+                        ? (isList || (length != ADDRESS_LENGTH))
+                        : !isList) {
+                    PRINTF("Invalid access list entry item\n");
+                    THROW(EXCEPTION);
+                }
+            } else {
+                if (isList || (length != STORAGE_KEY_LENGTH)) {
+                    PRINTF("Invalid storage key\n");
+                    THROW(EXCEPTION);
+                }
+                context->summary.accessList.storageKeys++;
+            }
+            break;
+        case RLP_LIST_BLOB_VERSIONED_HASHES:
+            // [hash, ...]
+            if (isList || (length != BLOB_VERSIONED_HASH_LENGTH)) {
+                PRINTF("Invalid blob versioned hash\n");
+                THROW(EXCEPTION);
+            }
+            context->summary.blobs.count++;
+            break;
+        case RLP_LIST_AUTHORIZATIONS:
+            // [[chain_id, address, nonce, y_parity, r, s], ...]
+            if (list->depth == 0) {
+                if (!isList) {
+                    PRINTF("Invalid authorization\n");
+                    THROW(EXCEPTION);
+                }
+                context->summary.authorizations.count++;
+            } else if (isList || ((list->index[1] == AUTHORIZATION_ADDRESS_INDEX) &&
+                                  (length != ADDRESS_LENGTH))) {
+                PRINTF("Invalid authorization item\n");
+                THROW(EXCEPTION);
+            }
+            break;
+        default:
+            PRINTF("Invalid list kind %d\n", kind);
+            THROW(EXCEPTION);
     }
 }
 
-static void processValue(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_VALUE\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldLength > MAX_INT256) {
-        PRINTF("Invalid length for RLP_VALUE\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, context->content->value.value + context->currentFieldPos, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->value.length = context->currentFieldLength;
-        context->currentField++;
-        context->processingField = false;
+static void summarizeListData(txContext_t *context,
+                              uint8_t kind,
+                              const uint8_t *data,
+                              uint32_t offset,
+                              uint32_t length) {
+    const rlpListState_t *list = &context->list;
+
+    switch (kind) {
+        case RLP_LIST_BLOB_VERSIONED_HASHES:
+            memmove(context->summary.blobs.last + offset, data, length);
+            if (context->summary.blobs.count == 1) {
+                memmove(context->summary.blobs.first + offset, data, length);
+            }
+            break;
+        case RLP_LIST_AUTHORIZATIONS:
+            if ((list->depth == 1) && (list->index[1] == AUTHORIZATION_ADDRESS_INDEX + 1)) {
+                memmove(context->summary.authorizations.last + offset, data, length);
+                if (context->summary.authorizations.count == 1) {
+                    memmove(context->summary.authorizations.first + offset, data, length);
+                }
+            }
+            break;
+        default:
+            break;
     }
 }
 
-static void processTo(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_TO\n");
+static void summarizeListEnd(uint8_t kind, uint8_t depth, uint32_t count) {
+    if ((kind == RLP_LIST_ACCESS_LIST) && (depth == 0) && (count != ACCESS_LIST_ENTRY_SIZE)) {
+        PRINTF("Invalid access list entry size %d\n", count);
         THROW(EXCEPTION);
     }
-    if (context->currentFieldLength > MAX_ADDRESS) {
-        PRINTF("Invalid length for RLP_TO\n");
+    if ((kind == RLP_LIST_AUTHORIZATIONS) && (depth == 0) &&
+        (count != AUTHORIZATION_TUPLE_SIZE)) {
+        PRINTF("Invalid authorization tuple size %d\n", count);
         THROW(EXCEPTION);
     }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, context->content->destination + context->currentFieldPos, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->destinationLength = context->currentFieldLength;
-        context->currentField++;
-        context->processingField = false;
-    }
 }
 
-static void processData(txContext_t *context) {
-    PRINTF("PROCESS DATA\n");
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_DATA\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        // If there is no data, set dataPresent to false.
-        if (copySize == 1 && *context->workBuffer == 0x00) {
-            context->content->dataPresent = false;
-        }
-        copyTxData(context, NULL, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        PRINTF("incrementing field\n");
-        context->currentField++;
-        context->processingField = false;
-    }
-}
+static void closeLists(txContext_t *context, uint8_t kind) {
+    rlpListState_t *list = &context->list;
 
-static void processAndDiscard(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for Discarded field\n");
-        THROW(EXCEPTION);
-    }
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        copyTxData(context, NULL, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->currentField++;
-        context->processingField = false;
+    while ((list->depth != 0) && (context->currentFieldPos == list->end[list->depth - 1])) {
+        list->depth--;
+        summarizeListEnd(kind, list->depth, list->index[list->depth + 1]);
     }
 }
 
-static void processV(txContext_t *context) {
-    if (context->currentFieldIsList) {
-        PRINTF("Invalid type for RLP_V\n");
-        THROW(EXCEPTION);
-    }
+// Walks the items of a list field as they arrive, only their summary is kept
+static void processListField(txContext_t *context, const rlpFieldDescriptor_t *field) {
+    rlpListState_t *list = &context->list;
 
-    if (context->currentFieldLength > sizeof(context->content->v)) {
-        PRINTF("Invalid length for RLP_V\n");
-        THROW(EXCEPTION);
-    }
+    if ((context->currentFieldPos == 0) && (context->rlpBufferPos == 0)) {
+        memset(list, 0, sizeof(rlpListState_t));
+    }
+    while ((context->commandLength != 0) &&
+           (context->currentFieldPos < context->currentFieldLength)) {
+        uint32_t length;
+        uint32_t limit;
+        bool isList;
 
-    if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t copySize =
-            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
-        // Make sure we do not copy more than the size of v.
-        copySize = MIN(copySize, sizeof(context->content->v));
-        copyTxData(context, context->content->v + context->currentFieldPos, copySize);
-    }
-    if (context->currentFieldPos == context->currentFieldLength) {
-        context->content->vLength = context->currentFieldLength;
-        context->currentField++;
-        context->processingField = false;
-    }
-}
-
-static bool processEIP1559Tx(txContext_t *context) {
-    switch (context->currentField) {
-        case EIP1559_RLP_CONTENT: {
-            processContent(context);
-            if ((context->processingFlags & TX_FLAG_TYPE) == 0) {
-                context->currentField++;
+        if (list->inItem) {
+            length = MIN(context->commandLength, list->itemEnd - context->currentFieldPos);
+            summarizeListData(context,
+                              field->list,
+                              context->workBuffer,
+                              context->currentFieldPos - list->itemStart,
+                              length);
+            copyTxData(context, NULL, length);
+            if (context->currentFieldPos == list->itemEnd) {
+                list->inItem = false;
+                closeLists(context, field->list);
             }
-            break;
-        }
-        // This gets hit only by Wanchain
-        case EIP1559_RLP_TYPE: {
-            processType(context);
-            break;
-        }
-        case EIP1559_RLP_CHAINID: {
-            processChainID(context);
-            break;
+            continue;
         }
-        case EIP1559_RLP_NONCE: {
-            processNonce(context);
+        if (!readRLPHeader(context, &length, &isList)) {
             break;
         }
-        case EIP1559_RLP_MAX_FEE_PER_GAS: {
-            processGasprice(context);
-            break;
+        limit = (list->depth == 0) ? context->currentFieldLength : list->end[list->depth - 1];
+        if ((context->currentFieldPos > limit) || (length > limit - context->currentFieldPos)) {
+            PRINTF("Item overflows its list\n");
+            THROW(EXCEPTION);
         }
-        case EIP1559_RLP_GASLIMIT: {
-            processGasLimit(context);
-            break;
-        }
-        case EIP1559_RLP_TO: {
-            processTo(context);
-            break;
-        }
-        case EIP1559_RLP_VALUE: {
-            processValue(context);
-            break;
+        summarizeListItem(context, field->list, isList, length);
+        list->index[list->depth]++;
+        if (isList) {
+            if (list->depth == RLP_LIST_MAX_DEPTH) {
+                PRINTF("Lists nested too deep\n");
+                THROW(EXCEPTION);
+            }
+            list->end[list->depth++] = context->currentFieldPos + length;
+            list->index[list->depth] = 0;
+        } else {
+            list->inItem = true;
+            list->itemStart = context->currentFieldPos;
+            list->itemEnd = context->currentFieldPos + length;
         }
-        case EIP1559_RLP_DATA: {
-            processData(context);
-            break;
+        if (length == 0) {
+            list->inItem = false;
+            closeLists(context, field->list);
         }
-        case EIP1559_RLP_ACCESS_LIST: {
-            processAccessList(context);
-            break;
+    }
+    if (context->currentFieldPos == context->currentFieldLength) {
+        if (context->rlpBufferPos != 0) {
+            PRINTF("Truncated list item\n");
+            THROW(EXCEPTION);
         }
-        case EIP1559_RLP_MAX_PRIORITY_FEE_PER_GAS:
-            processAndDiscard(context);
-            break;
-        default:
-            PRINTF("Invalid RLP decoder context\n");
-            return true;
+        nextField(context);
     }
-    return false;
 }
 
-static bool processEIP2930Tx(txContext_t *context) {
-    switch (context->currentField) {
-        case EIP2930_RLP_CONTENT:
-            processContent(context);
-            if ((context->processingFlags & TX_FLAG_TYPE) == 0) {
-                context->currentField++;
-            }
-            break;
-        // This gets hit only by Wanchain
-        case EIP2930_RLP_TYPE:
-            processType(context);
-            break;
-        case EIP2930_RLP_CHAINID:
-            processChainID(context);
-            break;
-        case EIP2930_RLP_NONCE:
-            processNonce(context);
-            break;
-        case EIP2930_RLP_GASPRICE:
-            processGasprice(context);
-            break;
-        case EIP2930_RLP_GASLIMIT:
-            processGasLimit(context);
-            break;
-        case EIP2930_RLP_TO:
-            processTo(context);
-            break;
-        case EIP2930_RLP_VALUE:
-            processValue(context);
-            break;
-        case EIP2930_RLP_DATA:
-            processData(context);
-            break;
-        case EIP2930_RLP_ACCESS_LIST:
-            processAccessList(context);
-            break;
-        default:
-            PRINTF("Invalid RLP decoder context\n");
-            return true;
-    }
-    return false;
-}
+static void processField(txContext_t *context, const rlpFieldDescriptor_t *field) {
+    uint8_t *value = NULL;
 
-static bool processLegacyTx(txContext_t *context) {
-    switch (context->currentField) {
-        case LEGACY_RLP_CONTENT:
-            processContent(context);
+    if (context->currentFieldIsList !=
+        ((field->kind == RLP_FIELD_CONTENT) || (field->kind == RLP_FIELD_WALK_LIST))) {
+        PRINTF("Invalid type for field %d\n", context->currentField);
+        THROW(EXCEPTION);
+    }
+    if ((field->maxLength != 0) && (context->currentFieldLength > field->maxLength)) {
+        PRINTF("Invalid length for field %d\n", context->currentField);
+        THROW(EXCEPTION);
+    }
+    if ((field->flags & RLP_FIELD_FLAG_FIXED_LENGTH) &&
+        (context->currentFieldLength != field->maxLength)) {
+        PRINTF("Invalid length for field %d\n", context->currentField);
+        THROW(EXCEPTION);
+    }
+    switch (field->kind) {
+        case RLP_FIELD_CONTENT:
+            // Keep the full length for sanity checks, move to the next field
+            context->dataLength = context->currentFieldLength;
+            nextField(context);
             if ((context->processingFlags & TX_FLAG_TYPE) == 0) {
                 context->currentField++;
             }
+            return;
+        case RLP_FIELD_COPY:
+            value = fieldDestination(context, field) + field->valueOffset;
+            value += context->currentFieldPos;
+            break;
+        case RLP_FIELD_DATA:
+            // If there is no data, set dataPresent to false.
+            if ((context->currentFieldPos == 0) && (context->currentFieldLength == 1) &&
+                (context->commandLength != 0) && (*context->workBuffer == 0x00)) {
+                context->content->dataPresent = false;
+            }
             break;
-        // This gets hit only by Wanchain
-        case LEGACY_RLP_TYPE:
-            processType(context);
-            break;
-        case LEGACY_RLP_NONCE:
-            processNonce(context);
-            break;
-        case LEGACY_RLP_GASPRICE:
-            processGasprice(context);
-            break;
-        case LEGACY_RLP_STARTGAS:
-            processStartGas(context);
-            break;
-        case LEGACY_RLP_TO:
-            processTo(context);
-            break;
-        case LEGACY_RLP_VALUE:
-            processValue(context);
-            break;
-        case LEGACY_RLP_DATA:
-            processData(context);
-            break;
-        case LEGACY_RLP_R:
-        case LEGACY_RLP_S:
-            processAndDiscard(context);
-            break;
-        case LEGACY_RLP_V:
-            processV(context);
+        case RLP_FIELD_SKIP:
             break;
+        case RLP_FIELD_WALK_LIST:
+            processListField(context, field);
+            return;
         default:
             PRINTF("Invalid RLP decoder context\n");
-            return true;
+            THROW(EXCEPTION);
+    }
+    if (context->currentFieldPos < context->currentFieldLength) {
+        uint32_t copySize =
+            MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
+        copyTxData(context, value, copySize);
+    }
+    if (context->currentFieldPos == context->currentFieldLength) {
+        if (field->kind == RLP_FIELD_COPY) {
+            *(fieldDestination(context, field) + field->lengthOffset) =
+                context->currentFieldLength;
+        }
+        nextField(context);
     }
-    return false;
 }
 
 static parserStatus_e parseRLP(txContext_t *context) {
-    bool canDecode = false;
-    uint32_t offset;
-    while (context->commandLength != 0) {
-        bool valid;
-        // Feed the RLP buffer until the length can be decoded
-        context->rlpBuffer[context->rlpBufferPos++] = readTxByte(context);
-        if (rlpCanDecode(context->rlpBuffer, context->rlpBufferPos, &valid)) {
-            // Can decode now, if valid
-            if (!valid) {
-                PRINTF("RLP pre-decode error\n");
-                return USTREAM_FAULT;
-            }
-            canDecode = true;
-            break;
-        }
-        // Cannot decode yet
-        // Sanity check
-        if (context->rlpBufferPos == sizeof(context->rlpBuffer)) {
-            PRINTF("RLP pre-decode logic error\n");
-            return USTREAM_FAULT;
-        }
-    }
-    if (!canDecode) {
+    if (!readRLPHeader(context, &context->currentFieldLength, &context->currentFieldIsList)) {
         PRINTF("Can't decode\n");
         return USTREAM_PROCESSING;
     }
-    // Ready to process this field
-    if (!rlpDecodeLength(context->rlpBuffer,
-                         &context->currentFieldLength,
-                         &offset,
-                         &context->currentFieldIsList)) {
-        PRINTF("RLP decode error\n");
-        return USTREAM_FAULT;
-    }
-    // Ready to process this field
-    if (offset == 0) {
-        // Hack for single byte, self encoded
-        context->workBuffer--;
-        context->commandLength++;
-        context->fieldSingleByte = true;
-    } else {
-        context->fieldSingleByte = false;
-    }
     context->currentFieldPos = 0;
-    context->rlpBufferPos = 0;
     context->processingField = true;
     return USTREAM_CONTINUE;
 }
 
 static parserStatus_e processTxInternal(txContext_t *context) {
+    if (!selectTxFields(context)) {
+        return USTREAM_FAULT;
+    }
     for (;;) {
         customStatus_e customStatus = CUSTOM_NOT_HANDLED;
         // EIP 155 style transaction
-        if (PARSING_IS_DONE(context)) {
+        if (context->currentField == context->fieldCount) {
             PRINTF("parsing is done\n");
             return USTREAM_FINISHED;
         }
@@ -525,9 +543,11 @@ static parserStatus_e processTxInternal(txContext_t *context) {
         // `USTREAM_FINISHED` preemptively. Case number 2 should NOT happen as it is up to
         // `ledgerjs` to correctly decrease the size of the APDU (`commandLength`) so that this
         // situation doesn't happen.
-        if ((context->txType == LEGACY && context->currentField == LEGACY_RLP_V) &&
-            (context->commandLength == 0)) {
-            context->content->vLength = 0;
+        if ((context->commandLength == 0) && !context->processingField &&
+            (context->rlpBufferPos == 0) &&
+            (context->fields[context->currentField].flags & RLP_FIELD_FLAG_OPTIONAL)) {
+            const rlpFieldDescriptor_t *field = &context->fields[context->currentField];
+            *(fieldDestination(context, field) + field->lengthOffset) = 0;
             PRINTF("finished\n");
             return USTREAM_FINISHED;
         }
@@ -560,33 +580,7 @@ static parserStatus_e processTxInternal(txContext_t *context) {
         }
         if (customStatus == CUSTOM_NOT_HANDLED) {
             PRINTF("Current field: %d\n", context->currentField);
-            switch (context->txType) {
-                bool fault;
-                case LEGACY:
-                    fault = processLegacyTx(context);
-                    if (fault) {
-                        return USTREAM_FAULT;
-                    } else {
-                        break;
-                    }
-                case EIP2930:
-                    fault = processEIP2930Tx(context);
-                    if (fault) {
-                        return USTREAM_FAULT;
-                    } else {
-                        break;
-                    }
-                case EIP1559:
-                    fault = processEIP1559Tx(context);
-                    if (fault) {
-                        return USTREAM_FAULT;
-                    } else {
-                        break;
-                    }
-                default:
-                    PRINTF("Transaction type %d is not supported\n", context->txType);
-                    return USTREAM_FAULT;
-            }
+            processField(context, &context->fields[context->currentField]);
         }
     }
     PRINTF("end of here\n");
@@ -600,9 +594,11 @@ parserStatus_e processTx(txContext_t *context,
     BEGIN_TRY {
         TRY {
             context->workBuffer = buffer;
+            context->hashBuffer = buffer;
             context->commandLength = length;
             context->processingFlags = processingFlags;
             result = processTxInternal(context);
+            hashConsumedData(context);
             PRINTF("result: %d\n", result);
         }
         CATCH_OTHER(e) {
@@ -620,6 +616,7 @@ parserStatus_e continueTx(txContext_t *context) {
     BEGIN_TRY {
         TRY {
             result = processTxInternal(context);
+            hashConsumedData(context);
         }
         CATCH_OTHER(e) {
             result = USTREAM_FAULT;
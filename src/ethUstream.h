@@ -41,11 +41,6 @@ typedef customStatus_e (*ustreamProcess_t)(struct txContext_t *context);
 // First variant of every Tx enum.
 #define RLP_NONE 0
 
-#define PARSING_IS_DONE(ctx)                                              \
-    ((ctx->txType == LEGACY && ctx->currentField == LEGACY_RLP_DONE) ||   \
-     (ctx->txType == EIP2930 && ctx->currentField == EIP2930_RLP_DONE) || \
-     (ctx->txType == EIP1559 && ctx->currentField == EIP1559_RLP_DONE))
-
 typedef enum rlpLegacyTxField_e {
     LEGACY_RLP_NONE = RLP_NONE,
     LEGACY_RLP_CONTENT,
@@ -93,6 +88,41 @@ typedef enum rlpEIP1559TxField_e {
     EIP1559_RLP_DONE
 } rlpEIP1559TxField_e;
 
+typedef enum rlpEIP4844TxField_e {
+    EIP4844_RLP_NONE = RLP_NONE,
+    EIP4844_RLP_CONTENT,
+    EIP4844_RLP_TYPE,  // For wanchain
+    EIP4844_RLP_CHAINID,
+    EIP4844_RLP_NONCE,
+    EIP4844_RLP_MAX_PRIORITY_FEE_PER_GAS,
+    EIP4844_RLP_MAX_FEE_PER_GAS,
+    EIP4844_RLP_GASLIMIT,
+    EIP4844_RLP_TO,
+    EIP4844_RLP_VALUE,
+    EIP4844_RLP_DATA,
+    EIP4844_RLP_ACCESS_LIST,
+    EIP4844_RLP_MAX_FEE_PER_BLOB_GAS,
+    EIP4844_RLP_BLOB_VERSIONED_HASHES,
+    EIP4844_RLP_DONE
+} rlpEIP4844TxField_e;
+
+typedef enum rlpEIP7702TxField_e {
+    EIP7702_RLP_NONE = RLP_NONE,
+    EIP7702_RLP_CONTENT,
+    EIP7702_RLP_TYPE,  // For wanchain
+    EIP7702_RLP_CHAINID,
+    EIP7702_RLP_NONCE,
+    EIP7702_RLP_MAX_PRIORITY_FEE_PER_GAS,
+    EIP7702_RLP_MAX_FEE_PER_GAS,
+    EIP7702_RLP_GASLIMIT,
+    EIP7702_RLP_TO,
+    EIP7702_RLP_VALUE,
+    EIP7702_RLP_DATA,
+    EIP7702_RLP_ACCESS_LIST,
+    EIP7702_RLP_AUTHORIZATION_LIST,
+    EIP7702_RLP_DONE
+} rlpEIP7702TxField_e;
+
 #define MIN_TX_TYPE 0x00
 #define MAX_TX_TYPE 0x7f
 
@@ -101,9 +131,90 @@ typedef enum rlpEIP1559TxField_e {
 typedef enum txType_e {
     EIP2930 = 0x01,
     EIP1559 = 0x02,
+    EIP4844 = 0x03,
+    EIP7702 = 0x04,
     LEGACY = 0xc0  // Legacy tx are greater than or equal to 0xc0.
 } txType_e;
 
+// How the parser handles a field of the transaction
+typedef enum rlpFieldKind_e {
+    RLP_FIELD_NONE,       // Not a valid field
+    RLP_FIELD_CONTENT,    // Outer list of the transaction
+    RLP_FIELD_COPY,       // Scalar copied into txContent_t
+    RLP_FIELD_DATA,       // Calldata, streamed through the custom processor
+    RLP_FIELD_SKIP,       // Scalar hashed but not stored
+    RLP_FIELD_WALK_LIST,  // List walked item by item to be summarized
+} rlpFieldKind_e;
+
+// Lists walked by the parser, each one has its own summary
+typedef enum rlpListKind_e {
+    RLP_LIST_NONE,
+    RLP_LIST_ACCESS_LIST,
+    RLP_LIST_BLOB_VERSIONED_HASHES,
+    RLP_LIST_AUTHORIZATIONS,
+} rlpListKind_e;
+
+// The transaction may end right before this field (pre EIP-155 legacy transactions)
+#define RLP_FIELD_FLAG_OPTIONAL 0x01
+// The value must be exactly maxLength bytes long
+#define RLP_FIELD_FLAG_FIXED_LENGTH 0x02
+// The value goes to txSummary_t instead of txContent_t
+#define RLP_FIELD_FLAG_SUMMARY 0x04
+
+// Describes one field of a transaction type, indexed by its rlp*TxField_e value
+typedef struct rlpFieldDescriptor_t {
+    uint8_t kind;  // rlpFieldKind_e
+    uint8_t flags;
+    uint8_t maxLength;      // 0 if unbounded
+    uint8_t list;           // rlpListKind_e, for RLP_FIELD_WALK_LIST
+    uint16_t valueOffset;   // Destination of the value in txContent_t
+    uint16_t lengthOffset;  // Destination of the value length in txContent_t
+} rlpFieldDescriptor_t;
+
+// Depth of the lists nested in a walked list field
+#define RLP_LIST_MAX_DEPTH 2
+
+// Position of the parser in a walked list field, positions are relative to the field
+typedef struct rlpListState_t {
+    uint32_t end[RLP_LIST_MAX_DEPTH];        // End of each open nested list
+    uint32_t index[RLP_LIST_MAX_DEPTH + 1];  // Number of items met so far at each depth
+    uint32_t itemStart;                      // Start of the string item being read
+    uint32_t itemEnd;                        // End of the string item being read
+    uint8_t depth;                           // Number of open nested lists
+    bool inItem;
+} rlpListState_t;
+
+#define BLOB_VERSIONED_HASH_LENGTH 32
+// Gas consumed by each blob (EIP-4844 GAS_PER_BLOB)
+#define GAS_PER_BLOB 0x20000
+
+typedef struct txAccessListSummary_t {
+    uint32_t addresses;
+    uint32_t storageKeys;
+} txAccessListSummary_t;
+
+typedef struct txBlobSummary_t {
+    uint32_t count;
+    uint8_t first[BLOB_VERSIONED_HASH_LENGTH];
+    uint8_t last[BLOB_VERSIONED_HASH_LENGTH];
+} txBlobSummary_t;
+
+typedef struct txAuthorizationSummary_t {
+    uint32_t count;
+    // Addresses the authorities delegate their code to
+    uint8_t first[ADDRESS_LENGTH];
+    uint8_t last[ADDRESS_LENGTH];
+} txAuthorizationSummary_t;
+
+// Transaction content that does not fit in txContent_t, lists are only summarized so their size
+// does not depend on the length of the transaction
+typedef struct txSummary_t {
+    txInt256_t maxFeePerBlobGas;
+    txAccessListSummary_t accessList;
+    txBlobSummary_t blobs;
+    txAuthorizationSummary_t authorizations;
+} txSummary_t;
+
 typedef enum parserStatus_e {
     USTREAM_PROCESSING,  // Parsing is in progress
     USTREAM_SUSPENDED,   // Parsing has been suspended
@@ -119,17 +230,24 @@ typedef struct txContext_t {
     uint32_t currentFieldPos;
     bool currentFieldIsList;
     bool processingField;
-    bool fieldSingleByte;
     uint32_t dataLength;
     uint8_t rlpBuffer[5];
     uint32_t rlpBufferPos;
     const uint8_t *workBuffer;
+    // Start of the bytes consumed from workBuffer but not hashed yet, they are hashed in one go
+    // whenever the parser yields
+    const uint8_t *hashBuffer;
     uint32_t commandLength;
     uint32_t processingFlags;
     ustreamProcess_t customProcessor;
     txContent_t *content;
     void *extra;
     uint8_t txType;
+    // Field schedule of txType, resolved every time the parser is entered
+    const rlpFieldDescriptor_t *fields;
+    uint8_t fieldCount;
+    rlpListState_t list;
+    txSummary_t summary;
 } txContext_t;
 
 void initTx(txContext_t *context,
@@ -144,3 +262,8 @@ parserStatus_e processTx(txContext_t *context,
 parserStatus_e continueTx(txContext_t *context);
 void copyTxData(txContext_t *context, uint8_t *out, uint32_t length);
 uint8_t readTxByte(txContext_t *context);
+
+static inline bool isDataField(const txContext_t *context) {
+    return (context->currentField < context->fieldCount) &&
+           (context->fields[context->currentField].kind == RLP_FIELD_DATA);
+}
@@ -1,16 +1,19 @@
 #include <string.h>
 #include "eth_plugin_handler.h"
 #include "eth_plugin_internal.h"
+#include "plugin_selectors.gen.h"
+#include "abi_decoder_plugin.h"
 #include "plugin_utils.h"
 #include "shared_context.h"
 #include "network.h"
+#include "profiling.h"
 
-void eth_plugin_prepare_init(ethPluginInitContract_t *init,
+void eth_plugin_prepare_init(ethPluginInitContractExt_t *init,
                              const uint8_t *selector,
                              uint32_t dataSize) {
-    memset((uint8_t *) init, 0, sizeof(ethPluginInitContract_t));
-    init->selector = selector;
-    init->dataSize = dataSize;
+    memset((uint8_t *) init, 0, sizeof(ethPluginInitContractExt_t));
+    init->base.selector = selector;
+    init->base.dataSize = dataSize;
 }
 
 void eth_plugin_prepare_provide_parameter(ethPluginProvideParameter_t *provideParameter,
@@ -21,6 +24,16 @@ void eth_plugin_prepare_provide_parameter(ethPluginProvideParameter_t *providePa
     provideParameter->parameterOffset = parameterOffset;
 }
 
+void eth_plugin_prepare_provide_parameters(ethPluginProvideParameters_t *provideParameters,
+                                           const uint8_t *parameters,
+                                           uint32_t parameterOffset,
+                                           uint16_t count) {
+    memset((uint8_t *) provideParameters, 0, sizeof(ethPluginProvideParameters_t));
+    provideParameters->base.parameter = parameters;
+    provideParameters->base.parameterOffset = parameterOffset;
+    provideParameters->count = count;
+}
+
 void eth_plugin_prepare_finalize(ethPluginFinalize_t *finalize) {
     memset((uint8_t *) finalize, 0, sizeof(ethPluginFinalize_t));
 }
@@ -99,38 +112,63 @@ static void eth_plugin_perform_init_default(uint8_t *contractAddress,
     dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
 }
 
+/**
+ * Find the first internal plugin selector greater than or equal to a given one
+ *
+ * Binary search in the generated \ref g_internal_plugin_selectors array, sorted by selector.
+ *
+ * @param[in] selector the selector, as a big-endian integer
+ * @return its index in the array
+ */
+static size_t find_internal_selector(uint32_t selector) {
+    size_t low = 0;
+    size_t high = g_internal_plugin_selectors_count;
+
+    while (low < high) {
+        size_t mid = low + ((high - low) / 2);
+
+        if (g_internal_plugin_selectors[mid].selector < selector) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
 static bool eth_plugin_perform_init_old_internal(uint8_t *contractAddress,
                                                  ethPluginInitContract_t *init) {
-    uint8_t i, j;
-    const uint8_t *const *selectors;
+    uint32_t selector;
 
-    // Search internal plugin list
-    for (i = 0;; i++) {
-        selectors = (const uint8_t *const *) PIC(INTERNAL_ETH_PLUGINS[i].selectors);
-        if (selectors == NULL) {
-            break;
-        }
-        for (j = 0; ((j < INTERNAL_ETH_PLUGINS[i].num_selectors) && (contractAddress != NULL));
-             j++) {
-            if (memcmp(init->selector, (const void *) PIC(selectors[j]), SELECTOR_SIZE) == 0) {
-                if ((INTERNAL_ETH_PLUGINS[i].availableCheck == NULL) ||
-                    ((PluginAvailableCheck) PIC(INTERNAL_ETH_PLUGINS[i].availableCheck))()) {
-                    strlcpy(dataContext.tokenContext.pluginName,
-                            INTERNAL_ETH_PLUGINS[i].alias,
-                            PLUGIN_ID_LENGTH);
-                    dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
-                    return true;
-                }
-            }
-        }
+    if (contractAddress == NULL) {
+        return false;
     }
+    selector = U4BE(init->selector, 0);
+    // several plugins can handle the same selector, they are sorted by priority
+    for (size_t i = find_internal_selector(selector);
+         (i < g_internal_plugin_selectors_count) &&
+         (g_internal_plugin_selectors[i].selector == selector);
+         i++) {
+        const internalEthPlugin_t *plugin =
+            &INTERNAL_ETH_PLUGINS[g_internal_plugin_selectors[i].plugin];
 
+        if ((plugin->availableCheck == NULL) ||
+            ((PluginAvailableCheck) PIC(plugin->availableCheck))()) {
+            strlcpy(dataContext.tokenContext.pluginName, plugin->alias, PLUGIN_ID_LENGTH);
+            dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
+            return true;
+        }
+    }
     return false;
 }
 
 eth_plugin_result_t eth_plugin_perform_init(uint8_t *contractAddress,
-                                            ethPluginInitContract_t *init) {
+                                            ethPluginInitContractExt_t *initExt) {
+    ethPluginInitContract_t *init = &initExt->base;
+
     dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_UNAVAILABLE;
+    dataContext.tokenContext.pluginBatchParameters = false;
+    initExt->capabilities = 0;
 
     PRINTF("Selector %.*H\n", 4, init->selector);
     switch (pluginType) {
@@ -147,6 +185,15 @@ eth_plugin_result_t eth_plugin_perform_init(uint8_t *contractAddress,
                 contractAddress = NULL;
             }
             break;
+#ifdef HAVE_ABI_DESCRIPTOR
+        case ABI_DECODER:
+            // blind signing if the descriptor is for another method
+            if ((contractAddress != NULL) &&
+                abi_descriptor_matches(contractAddress, init->selector)) {
+                contractAddress = NULL;
+            }
+            break;
+#endif  // HAVE_ABI_DESCRIPTOR
         default:
             PRINTF("Unsupported pluginType %d\n", pluginType);
             os_sched_exit(0);
@@ -175,9 +222,32 @@ eth_plugin_result_t eth_plugin_perform_init(uint8_t *contractAddress,
     }
     PRINTF("eth_plugin_init ok %s\n", dataContext.tokenContext.pluginName);
     dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
+    // the plugin announces that it handles several parameters per ETH_PLUGIN_PROVIDE_PARAMETER
+    dataContext.tokenContext.pluginBatchParameters =
+        (initExt->capabilities & ETH_PLUGIN_CAPABILITY_BATCH_PARAMETERS) != 0;
     return ETH_PLUGIN_RESULT_OK;
 }
 
+#ifdef HAVE_PROFILING
+// The plugins not looked up by alias do not set one
+static const char *get_profiling_name(const char *alias) {
+    switch (pluginType) {
+#ifdef HAVE_NFT_SUPPORT
+        case ERC721:
+            return "-erc721";
+        case ERC1155:
+            return "-erc1155";
+#endif  // HAVE_NFT_SUPPORT
+#ifdef HAVE_ABI_DESCRIPTOR
+        case ABI_DECODER:
+            return "-abi";
+#endif  // HAVE_ABI_DESCRIPTOR
+        default:
+            return alias;
+    }
+}
+#endif  // HAVE_PROFILING
+
 eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
     ethPluginSharedRW_t pluginRW;
     ethPluginSharedRO_t pluginRO;
@@ -281,6 +351,12 @@ eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
             break;
         }
 #endif  // HAVE_NFT_SUPPORT
+#ifdef HAVE_ABI_DESCRIPTOR
+        case ABI_DECODER: {
+            abi_decoder_plugin_call(method, parameter);
+            break;
+        }
+#endif  // HAVE_ABI_DESCRIPTOR
         case OLD_INTERNAL: {
             // Perform the call
             for (i = 0;; i++) {
@@ -299,6 +375,7 @@ eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
             return ETH_PLUGIN_RESULT_ERROR;
         }
     }
+    PROFILING_COUNT(get_profiling_name(alias), method);
 
     // Check the call result
     PRINTF("method: %d\n", method);
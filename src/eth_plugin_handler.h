@@ -2,18 +2,23 @@
 #define _ETH_PLUGIN_HANDLER_H_
 
 #include "eth_plugin_interface.h"
+#include "eth_plugin_interface_ext.h"
 
 #define NO_EXTRA_INFO(ctx, idx) \
     (allzeroes(&(ctx.transactionContext.extraInfo[idx]), sizeof(extraInfo_t)))
 
 #define NO_NFT_METADATA (NO_EXTRA_INFO(tmpCtx, 0))
 
-void eth_plugin_prepare_init(ethPluginInitContract_t *init,
+void eth_plugin_prepare_init(ethPluginInitContractExt_t *init,
                              const uint8_t *selector,
                              uint32_t dataSize);
 void eth_plugin_prepare_provide_parameter(ethPluginProvideParameter_t *provideParameter,
                                           uint8_t *parameter,
                                           uint32_t parameterOffset);
+void eth_plugin_prepare_provide_parameters(ethPluginProvideParameters_t *provideParameters,
+                                           const uint8_t *parameters,
+                                           uint32_t parameterOffset,
+                                           uint16_t count);
 void eth_plugin_prepare_finalize(ethPluginFinalize_t *finalize);
 void eth_plugin_prepare_provide_info(ethPluginProvideInfo_t *provideToken);
 void eth_plugin_prepare_query_contract_ID(ethQueryContractID_t *queryContractID,
@@ -29,7 +34,7 @@ void eth_plugin_prepare_query_contract_UI(ethQueryContractUI_t *queryContractUI,
                                           uint32_t msgLength);
 
 eth_plugin_result_t eth_plugin_perform_init(uint8_t *contractAddress,
-                                            ethPluginInitContract_t *init);
+                                            ethPluginInitContractExt_t *initExt);
 // NULL for cached address, or base contract address
 eth_plugin_result_t eth_plugin_call(int method, void *parameter);
 
@@ -0,0 +1,31 @@
+#ifndef _ETH_PLUGIN_INTERFACE_EXT_H_
+#define _ETH_PLUGIN_INTERFACE_EXT_H_
+
+// Additions to the plugin interface of the Ethereum plugin SDK, to be mirrored in its
+// eth_plugin_interface.h for the external plugins to use them
+//
+// Both only append fields to the SDK messages, which the plugins unaware of them never touch: no
+// new message ID nor interface version is needed.
+
+#include <stdint.h>
+#include "eth_plugin_interface.h"
+
+// Capabilities set by a plugin in ethPluginInitContractExt_t.capabilities before returning from
+// ETH_PLUGIN_INIT_CONTRACT, independent from the interface version
+
+// ETH_PLUGIN_PROVIDE_PARAMETER may give several consecutive parameters at once
+#define ETH_PLUGIN_CAPABILITY_BATCH_PARAMETERS (1 << 0)
+
+typedef struct ethPluginInitContractExt_s {
+    ethPluginInitContract_t base;
+    uint32_t capabilities;  // out, ETH_PLUGIN_CAPABILITY_*, left to 0 by the other plugins
+} ethPluginInitContractExt_t;
+
+// ETH_PLUGIN_PROVIDE_PARAMETER, base.parameter pointing to the first of count parameters of 32
+// bytes each, count being always 1 for the plugins without ETH_PLUGIN_CAPABILITY_BATCH_PARAMETERS
+typedef struct ethPluginProvideParameters_s {
+    ethPluginProvideParameter_t base;
+    uint16_t count;
+} ethPluginProvideParameters_t;
+
+#endif  // _ETH_PLUGIN_INTERFACE_EXT_H_
@@ -2,8 +2,6 @@
 #include "eth_plugin_internal.h"
 #include "plugin_utils.h"
 
-void erc20_plugin_call(int message, void* parameters);
-
 #ifdef HAVE_ETH2
 void eth2_plugin_call(int message, void* parameters);
 #endif
@@ -22,6 +20,22 @@ const uint8_t* const ETH2_SELECTORS[NUM_ETH2_SELECTORS] = {ETH2_DEPOSIT_SELECTOR
 
 #endif
 
+#ifdef HAVE_MULTICALL
+
+void multicall_plugin_call(int message, void* parameters);
+
+// multicall(bytes[]), multicall(uint256,bytes[]) and multiSend(bytes)
+static const uint8_t MULTICALL_BYTES_ARRAY_SELECTOR[SELECTOR_SIZE] = {0xac, 0x96, 0x50, 0xd8};
+static const uint8_t MULTICALL_DEADLINE_SELECTOR[SELECTOR_SIZE] = {0x5a, 0xe4, 0x01, 0xdc};
+static const uint8_t MULTISEND_SELECTOR[SELECTOR_SIZE] = {0x8d, 0x80, 0xff, 0x0a};
+
+const uint8_t* const MULTICALL_SELECTORS[NUM_MULTICALL_SELECTORS] = {
+    MULTICALL_BYTES_ARRAY_SELECTOR,
+    MULTICALL_DEADLINE_SELECTOR,
+    MULTISEND_SELECTOR};
+
+#endif
+
 // All internal alias names start with 'minus'
 
 const internalEthPlugin_t INTERNAL_ETH_PLUGINS[] = {
@@ -31,6 +45,12 @@ const internalEthPlugin_t INTERNAL_ETH_PLUGINS[] = {
 
     {NULL, ETH2_SELECTORS, NUM_ETH2_SELECTORS, "-eth2", eth2_plugin_call},
 
+#endif
+
+#ifdef HAVE_MULTICALL
+
+    {NULL, MULTICALL_SELECTORS, NUM_MULTICALL_SELECTORS, "-multi", multicall_plugin_call},
+
 #endif
 
     {NULL, NULL, 0, "", NULL}};
@@ -5,6 +5,7 @@
 #include "shared_context.h"
 #include "eth_plugin_interface.h"
 
+void erc20_plugin_call(int message, void* parameters);
 void erc721_plugin_call(int message, void* parameters);
 void erc1155_plugin_call(int message, void* parameters);
 
@@ -29,4 +30,11 @@ extern const uint8_t* const ETH2_SELECTORS[NUM_ETH2_SELECTORS];
 
 #endif
 
+#ifdef HAVE_MULTICALL
+
+#define NUM_MULTICALL_SELECTORS 3
+extern const uint8_t* const MULTICALL_SELECTORS[NUM_MULTICALL_SELECTORS];
+
+#endif
+
 extern internalEthPlugin_t const INTERNAL_ETH_PLUGINS[];
@@ -39,12 +39,12 @@ void handle_get_printable_amount(get_printable_amount_parameters_t* params,
         decimals = WEI_TO_ETHER;
     }
 
-    if (!amountToString(params->amount,
-                        params->amount_length,
-                        decimals,
-                        ticker,
-                        params->printable_amount,
-                        sizeof(params->printable_amount))) {
+    if (!amount_to_string(params->amount,
+                          params->amount_length,
+                          decimals,
+                          ticker,
+                          params->printable_amount,
+                          sizeof(params->printable_amount))) {
         memset(params->printable_amount, 0, sizeof(params->printable_amount));
     }
     return;
@@ -5,6 +5,7 @@
 #include "handle_swap_sign_transaction.h"
 #include "shared_context.h"
 #include "common_utils.h"
+#include "uint256.h"
 #include "network.h"
 #ifdef HAVE_NBGL
 #include "nbgl_use_case.h"
@@ -40,12 +41,12 @@ bool copy_transaction_parameters(create_transaction_parameters_t* sign_transacti
         PRINTF("Error while parsing config\n");
         return false;
     }
-    if (!amountToString(sign_transaction_params->amount,
-                        sign_transaction_params->amount_length,
-                        decimals,
-                        ticker,
-                        stack_data.fullAmount,
-                        sizeof(stack_data.fullAmount))) {
+    if (!amount_to_string(sign_transaction_params->amount,
+                          sign_transaction_params->amount_length,
+                          decimals,
+                          ticker,
+                          stack_data.fullAmount,
+                          sizeof(stack_data.fullAmount))) {
         return false;
     }
 
@@ -56,12 +57,12 @@ bool copy_transaction_parameters(create_transaction_parameters_t* sign_transacti
     // If the amount is a fee, its value is nominated in ETH even if we're doing an ERC20 swap
     strlcpy(ticker, get_displayable_ticker(&chain_id, config), sizeof(ticker));
     decimals = WEI_TO_ETHER;
-    if (!amountToString(sign_transaction_params->fee_amount,
-                        sign_transaction_params->fee_amount_length,
-                        decimals,
-                        ticker,
-                        stack_data.maxFee,
-                        sizeof(stack_data.maxFee))) {
+    if (!amount_to_string(sign_transaction_params->fee_amount,
+                          sign_transaction_params->fee_amount_length,
+                          decimals,
+                          ticker,
+                          stack_data.maxFee,
+                          sizeof(stack_data.maxFee))) {
         return false;
     }
 
@@ -100,6 +101,9 @@ void __attribute__((noreturn)) handle_swap_sign_transaction(const chain_config_t
         storage.initialized = 0x01;
         storage.displayNonce = 0x00;
         storage.contractDetails = 0x00;
+#ifdef HAVE_TOKEN_STORE
+        storage.tokenStore = 0x00;
+#endif
         nvm_write((void*) &N_storage, (void*) &storage, sizeof(internalStorage_t));
     }
 
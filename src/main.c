@@ -33,6 +33,8 @@
 #include "domain_name.h"
 #include "crypto_helpers.h"
 #include "manage_asset_info.h"
+#include "sig_cache.h"
+#include "profiling.h"
 
 unsigned char G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
 
@@ -257,6 +259,7 @@ void handleApdu(unsigned int *flags, unsigned int *tx) {
                         case P2_EIP712_FULL_IMPLEM:
                             *flags |= IO_ASYNCH_REPLY;
                             handle_eip712_sign(G_io_apdu_buffer);
+                            PROFILING_COUNT("eip712_sign", 0);
                             break;
 #endif  // HAVE_EIP712_FULL_SUPPORT
                         default:
@@ -291,16 +294,19 @@ void handleApdu(unsigned int *flags, unsigned int *tx) {
                 case INS_EIP712_STRUCT_DEF:
                     *flags |= IO_ASYNCH_REPLY;
                     handle_eip712_struct_def(G_io_apdu_buffer);
+                    PROFILING_COUNT("eip712_def", 0);
                     break;
 
                 case INS_EIP712_STRUCT_IMPL:
                     *flags |= IO_ASYNCH_REPLY;
                     handle_eip712_struct_impl(G_io_apdu_buffer);
+                    PROFILING_COUNT("eip712_impl", 0);
                     break;
 
                 case INS_EIP712_FILTERING:
                     *flags |= IO_ASYNCH_REPLY;
                     handle_eip712_filtering(G_io_apdu_buffer);
+                    PROFILING_COUNT("eip712_filter", 0);
                     break;
 #endif  // HAVE_EIP712_FULL_SUPPORT
 
@@ -317,6 +323,28 @@ void handleApdu(unsigned int *flags, unsigned int *tx) {
                     break;
 #endif  // HAVE_DOMAIN_NAME
 
+#ifdef HAVE_ABI_DESCRIPTOR
+                case INS_PROVIDE_ABI_DESCRIPTOR:
+                    handleProvideAbiDescriptor(G_io_apdu_buffer[OFFSET_P1],
+                                               G_io_apdu_buffer[OFFSET_P2],
+                                               G_io_apdu_buffer + OFFSET_CDATA,
+                                               G_io_apdu_buffer[OFFSET_LC],
+                                               flags,
+                                               tx);
+                    break;
+#endif  // HAVE_ABI_DESCRIPTOR
+
+#ifdef HAVE_PROFILING
+                case INS_GET_PROFILING_COUNTERS:
+                    handleGetProfilingCounters(G_io_apdu_buffer[OFFSET_P1],
+                                               G_io_apdu_buffer[OFFSET_P2],
+                                               G_io_apdu_buffer + OFFSET_CDATA,
+                                               G_io_apdu_buffer[OFFSET_LC],
+                                               flags,
+                                               tx);
+                    break;
+#endif  // HAVE_PROFILING
+
 #if 0
         case 0xFF: // return to dashboard
           goto return_to_dashboard;
@@ -534,6 +562,8 @@ __attribute__((noreturn)) void coin_main(libargs_t *args) {
     }
 
     reset_app_context();
+    // unlike the app context, kept across transactions
+    sig_cache_reset();
 
     for (;;) {
         UX_INIT();
@@ -561,6 +591,9 @@ __attribute__((noreturn)) void coin_main(libargs_t *args) {
 #endif
 #ifdef HAVE_DOMAIN_NAME
                     storage.verbose_domain_name = false;
+#endif
+#ifdef HAVE_TOKEN_STORE
+                    storage.tokenStore = false;
 #endif
                     storage.initialized = true;
                     nvm_write((void *) &N_storage, (void *) &storage, sizeof(internalStorage_t));
@@ -1,9 +1,16 @@
 #include "manage_asset_info.h"
 #include "shared_context.h"
+#include "network.h"
+#include "token_store.h"
+
+static asset_cache_stats_t g_asset_cache_stats;
 
 void forget_known_assets(void) {
     memset(tmpCtx.transactionContext.assetSet, false, MAX_ASSETS);
+    memset(tmpCtx.transactionContext.assetBuckets, 0, ASSET_BUCKETS);
     tmpCtx.transactionContext.currentAssetIndex = 0;
+    tmpCtx.transactionContext.assetUseTick = 0;
+    tmpCtx.transactionContext.tokenListRootSet = false;
 }
 
 static extraInfo_t *get_asset_info(uint8_t index) {
@@ -13,36 +20,224 @@ static extraInfo_t *get_asset_info(uint8_t index) {
     return &tmpCtx.transactionContext.extraInfo[index];
 }
 
-static bool asset_info_is_set(uint8_t index) {
+bool asset_info_is_set(uint8_t index) {
     if (index >= MAX_ASSETS) {
         return false;
     }
     return tmpCtx.transactionContext.assetSet[index];
 }
 
+// Works for ERC-20 & NFT tokens since both structs in the union have the contract address aligned
+static const uint8_t *get_asset_address(uint8_t index) {
+    return get_asset_info(index)->token.address;
+}
+
+/**
+ * Get the first bucket to probe for a given contract address
+ *
+ * Addresses are hashes, so their last bytes are already evenly distributed.
+ *
+ * @param[in] address contract address
+ * @return bucket index
+ */
+static size_t get_home_bucket(const uint8_t *address) {
+    uint32_t hash = 0;
+
+    for (uint8_t i = ADDRESS_LENGTH - sizeof(hash); i < ADDRESS_LENGTH; i++) {
+        hash = (hash << 8) | address[i];
+    }
+    return hash % ASSET_BUCKETS;
+}
+
+/**
+ * Find the bucket of a given contract address, with linear probing
+ *
+ * @param[in] address contract address
+ * @return the bucket holding this address if it is known, the empty one where it would be stored
+ * otherwise, \ref ASSET_BUCKETS if none is left
+ */
+static size_t find_bucket(const uint8_t *address) {
+    const uint8_t *buckets = tmpCtx.transactionContext.assetBuckets;
+    size_t bucket = get_home_bucket(address);
+
+    for (size_t i = 0; i < ASSET_BUCKETS; i++) {
+        uint8_t index;
+
+        if (buckets[bucket] == 0) {
+            return bucket;
+        }
+        index = buckets[bucket] - 1;
+        if (asset_info_is_set(index) &&
+            (memcmp(get_asset_address(index), address, ADDRESS_LENGTH) == 0)) {
+            return bucket;
+        }
+        bucket = (bucket + 1) % ASSET_BUCKETS;
+    }
+    return ASSET_BUCKETS;
+}
+
+/**
+ * Remove a known asset from the address index
+ *
+ * The following entries of the probing sequence are shifted back so that they can still be found.
+ *
+ * @param[in] index asset index
+ */
+static void unindex_asset(uint8_t index) {
+    uint8_t *buckets = tmpCtx.transactionContext.assetBuckets;
+    size_t hole = find_bucket(get_asset_address(index));
+    size_t next;
+
+    if ((hole == ASSET_BUCKETS) || (buckets[hole] != (index + 1))) {
+        return;
+    }
+    buckets[hole] = 0;
+    next = (hole + 1) % ASSET_BUCKETS;
+    for (size_t i = 0; (i < ASSET_BUCKETS) && (buckets[next] != 0); i++) {
+        if (asset_info_is_set(buckets[next] - 1)) {
+            size_t home = get_home_bucket(get_asset_address(buckets[next] - 1));
+
+            // the entry can move back unless its home bucket lies between the hole and itself
+            if (((next + ASSET_BUCKETS - home) % ASSET_BUCKETS) >=
+                ((next + ASSET_BUCKETS - hole) % ASSET_BUCKETS)) {
+                buckets[hole] = buckets[next];
+                buckets[next] = 0;
+                hole = next;
+            }
+        }
+        next = (next + 1) % ASSET_BUCKETS;
+    }
+}
+
+static void touch_asset(uint8_t index) {
+    if (++tmpCtx.transactionContext.assetUseTick == 0) {
+        // wrapped around, start the usage order over
+        memset(tmpCtx.transactionContext.assetLastUse, 0, sizeof(uint16_t) * MAX_ASSETS);
+        tmpCtx.transactionContext.assetUseTick = 1;
+    }
+    tmpCtx.transactionContext.assetLastUse[index] = tmpCtx.transactionContext.assetUseTick;
+}
+
+void evict_asset_info(uint8_t index) {
+    if (!asset_info_is_set(index)) {
+        return;
+    }
+    PRINTF("Evicting asset at index %d\n", index);
+    unindex_asset(index);
+    tmpCtx.transactionContext.assetSet[index] = false;
+    g_asset_cache_stats.evictions += 1;
+}
+
 extraInfo_t *get_asset_info_by_addr(const uint8_t *contractAddress) {
-    // Works for ERC-20 & NFT tokens since both structs in the union have the
-    // contract address aligned
+    size_t bucket = find_bucket(contractAddress);
+    uint8_t index;
+
+    if ((bucket == ASSET_BUCKETS) || (tmpCtx.transactionContext.assetBuckets[bucket] == 0)) {
+        g_asset_cache_stats.misses += 1;
+        return NULL;
+    }
+    index = tmpCtx.transactionContext.assetBuckets[bucket] - 1;
+    PRINTF("Token found at index %d\n", index);
+    g_asset_cache_stats.hits += 1;
+    touch_asset(index);
+    return get_asset_info(index);
+}
+
+/**
+ * Pick the slot where the next asset will be provisioned
+ *
+ * The first free slot is used, if none is left the least recently used asset is evicted.
+ *
+ * @return asset index
+ */
+static uint8_t pick_asset_slot(void) {
+    uint8_t victim = 0;
+
     for (uint8_t i = 0; i < MAX_ASSETS; i++) {
-        extraInfo_t *currentItem = get_asset_info(i);
-        if (asset_info_is_set(i) &&
-            (memcmp(currentItem->token.address, contractAddress, ADDRESS_LENGTH) == 0)) {
-            PRINTF("Token found at index %d\n", i);
-            return currentItem;
+        if (!asset_info_is_set(i)) {
+            return i;
+        }
+        if (tmpCtx.transactionContext.assetLastUse[i] <
+            tmpCtx.transactionContext.assetLastUse[victim]) {
+            victim = i;
         }
     }
-
-    return NULL;
+    evict_asset_info(victim);
+    return victim;
 }
 
+/**
+ * Get the asset being provisioned
+ *
+ * It is kept apart from the known ones, never overwritten before the new one has been verified.
+ *
+ * @return the asset to fill
+ */
 extraInfo_t *get_current_asset_info(void) {
-    return get_asset_info(tmpCtx.transactionContext.currentAssetIndex);
+    extraInfo_t *pending = &tmpCtx.transactionContext.pendingAsset;
+
+    memset(pending, 0, sizeof(*pending));
+    return pending;
 }
 
+/**
+ * Store the asset being provisioned, once verified
+ *
+ * A new description of an already known asset replaces it, otherwise it takes the first free slot
+ * or the one of the least recently used asset. Its index is then \ref currentAssetIndex.
+ */
 void validate_current_asset_info(void) {
-    // mark it as set
-    tmpCtx.transactionContext.assetSet[tmpCtx.transactionContext.currentAssetIndex] = true;
-    // increment index
-    tmpCtx.transactionContext.currentAssetIndex =
-        (tmpCtx.transactionContext.currentAssetIndex + 1) % MAX_ASSETS;
+    const extraInfo_t *pending = &tmpCtx.transactionContext.pendingAsset;
+    size_t bucket;
+    uint8_t index;
+
+    bucket = find_bucket(pending->token.address);
+    if ((bucket != ASSET_BUCKETS) && (tmpCtx.transactionContext.assetBuckets[bucket] != 0)) {
+        index = tmpCtx.transactionContext.assetBuckets[bucket] - 1;
+        evict_asset_info(index);
+    } else {
+        index = pick_asset_slot();
+    }
+    bucket = find_bucket(pending->token.address);
+    if (bucket == ASSET_BUCKETS) {
+        return;
+    }
+    memmove(get_asset_info(index), pending, sizeof(*pending));
+    tmpCtx.transactionContext.assetBuckets[bucket] = index + 1;
+    tmpCtx.transactionContext.assetSet[index] = true;
+    tmpCtx.transactionContext.currentAssetIndex = index;
+    touch_asset(index);
+}
+
+const asset_cache_stats_t *get_asset_cache_stats(void) {
+    return &g_asset_cache_stats;
+}
+
+void reset_asset_cache_stats(void) {
+    memset(&g_asset_cache_stats, 0, sizeof(g_asset_cache_stats));
+}
+
+#ifdef HAVE_TOKEN_STORE
+/**
+ * Load a token verified in a previous session, as if it had just been provisioned
+ *
+ * It may evict a known asset, so it is only meant to be used while finalizing a transaction.
+ *
+ * @param[in] chain_id chain ID the token has been verified for
+ * @param[in] contractAddress contract address
+ * @return the token information, \ref NULL if it is not stored
+ */
+extraInfo_t *load_stored_asset_info(uint64_t chain_id, const uint8_t *contractAddress) {
+    const tokenDefinition_t *stored = token_store_lookup(chain_id, contractAddress);
+    extraInfo_t *info;
+
+    if (stored == NULL) {
+        return NULL;
+    }
+    PRINTF("Token found in the store\n");
+    info = get_current_asset_info();
+    memmove(&info->token, stored, sizeof(info->token));
+    validate_current_asset_info();
+    return get_asset_info(tmpCtx.transactionContext.currentAssetIndex);
 }
+#endif  // HAVE_TOKEN_STORE
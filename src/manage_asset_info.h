@@ -2,7 +2,20 @@
 #include "common_utils.h"
 #include "asset_info.h"
 
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+} asset_cache_stats_t;
+
 void forget_known_assets(void);
+bool asset_info_is_set(uint8_t index);
 extraInfo_t *get_asset_info_by_addr(const uint8_t *contractAddress);
 extraInfo_t *get_current_asset_info(void);
 void validate_current_asset_info(void);
+void evict_asset_info(uint8_t index);
+const asset_cache_stats_t *get_asset_cache_stats(void);
+void reset_asset_cache_stats(void);
+#ifdef HAVE_TOKEN_STORE
+extraInfo_t *load_stored_asset_info(uint64_t chain_id, const uint8_t *contractAddress);
+#endif
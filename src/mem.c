@@ -4,23 +4,128 @@
  * The two functions alloc & dealloc use the buffer as a simple stack.
  * Especially useful when an unpredictable amount of data will be received and have to be stored
  * during the transaction but discarded right after.
+ *
+ * A mark taken before temporary allocations releases all of them at once, whatever their sizes.
+ *
+ * In the builds made with PROFILING=1, the high-water mark of the buffer is tracked, overall and
+ * per subsystem (tag) the allocations are accounted to. Since the buffer is a stack, the bytes of
+ * a tag form runs, the allocations made under the same tag being merged into the last run.
  */
 
 #ifdef HAVE_DYN_MEM_ALLOC
 
 #include <stdint.h>
+#include <string.h>
+#include "os.h"
 #include "mem.h"
 
-#define SIZE_MEM_BUFFER 8192
-
-static uint8_t mem_buffer[SIZE_MEM_BUFFER];
+static uint8_t mem_buffer[MEM_SIZE];
 static size_t mem_idx;
 
+#ifdef HAVE_PROFILING
+
+// Runs of allocations of a different tag, the extra ones being accounted to the last one
+#define MEM_MAX_RUNS 16
+
+_Static_assert(MEM_SIZE <= UINT16_MAX, "memory usage reported on 16 bits");
+
+typedef struct {
+    uint16_t start;
+    uint8_t tag;
+} mem_run_t;
+
+static mem_run_t mem_runs[MEM_MAX_RUNS];
+static uint8_t mem_runs_count;
+static uint16_t mem_tags_used[MEM_TAGS_COUNT];
+static e_mem_tag mem_tag;
+static mem_stats_t mem_stats;
+
+void mem_set_tag(e_mem_tag tag) {
+    mem_tag = tag;
+}
+
+static void stats_init(void) {
+    mem_runs_count = 0;
+    memset(mem_tags_used, 0, sizeof(mem_tags_used));
+    mem_tag = MEM_TAG_OTHER;
+    mem_stats.used = 0;
+}
+
+/**
+ * Account an allocation to the current tag
+ *
+ * @param[in] size allocation size in bytes, already taken from the buffer
+ */
+static void stats_alloc(size_t size) {
+    mem_run_t *run = (mem_runs_count > 0) ? &mem_runs[mem_runs_count - 1] : NULL;
+
+    if (size == 0) {
+        return;
+    }
+    if (((run == NULL) || (run->tag != mem_tag)) && (mem_runs_count < MEM_MAX_RUNS)) {
+        run = &mem_runs[mem_runs_count++];
+        run->start = mem_idx - size;
+        run->tag = mem_tag;
+    }
+    mem_tags_used[run->tag] += size;
+    if (mem_tags_used[run->tag] > mem_stats.tags_high_water[run->tag]) {
+        mem_stats.tags_high_water[run->tag] = mem_tags_used[run->tag];
+    }
+    mem_stats.used = mem_idx;
+    if (mem_stats.used > mem_stats.high_water) {
+        mem_stats.high_water = mem_stats.used;
+    }
+}
+
+/**
+ * Give back the released bytes of the runs above the new top of the buffer
+ *
+ * @param[in] idx new index in the buffer
+ */
+static void stats_dealloc(size_t idx) {
+    size_t end = mem_idx;
+
+    while (mem_runs_count > 0) {
+        mem_run_t *run = &mem_runs[mem_runs_count - 1];
+
+        if (run->start < idx) {
+            mem_tags_used[run->tag] -= end - idx;
+            break;
+        }
+        mem_tags_used[run->tag] -= end - run->start;
+        end = run->start;
+        mem_runs_count -= 1;
+    }
+    mem_stats.used = idx;
+}
+
+/**
+ * Get the memory usage, current & highest since the last reset of the statistics
+ *
+ * @return the statistics
+ */
+const mem_stats_t *mem_get_stats(void) {
+    return &mem_stats;
+}
+
+/**
+ * Reset the high-water marks to the current usage
+ */
+void mem_reset_stats(void) {
+    mem_stats.high_water = mem_stats.used;
+    memcpy(mem_stats.tags_high_water, mem_tags_used, sizeof(mem_stats.tags_high_water));
+}
+
+#endif  // HAVE_PROFILING
+
 /**
  * Initializes the memory buffer index
  */
 void mem_init(void) {
     mem_idx = 0;
+#ifdef HAVE_PROFILING
+    stats_init();
+#endif
 }
 
 /**
@@ -40,11 +145,18 @@ void mem_reset(void) {
  * @return Allocated memory pointer; \ref NULL if not enough space left.
  */
 void *mem_alloc(size_t size) {
-    if ((mem_idx + size) > SIZE_MEM_BUFFER)  // Buffer exceeded
+    if ((mem_idx + size) > MEM_SIZE)  // Buffer exceeded
     {
+        PRINTF("Memory exhausted, %u bytes requested with %u/%u used\n",
+               (unsigned int) size,
+               (unsigned int) mem_idx,
+               MEM_SIZE);
         return NULL;
     }
     mem_idx += size;
+#ifdef HAVE_PROFILING
+    stats_alloc(size);
+#endif
     return &mem_buffer[mem_idx - size];
 }
 
@@ -54,12 +166,41 @@ void *mem_alloc(size_t size) {
  * @param[in] size Requested deallocation size in bytes
  */
 void mem_dealloc(size_t size) {
-    if (size > mem_idx)  // More than is already allocated
-    {
-        mem_idx = 0;
-    } else {
-        mem_idx -= size;
+    size_t idx = (size > mem_idx) ? 0 : (mem_idx - size);  // 0 if more than is allocated
+
+#ifdef HAVE_PROFILING
+    stats_dealloc(idx);
+#endif
+    mem_idx = idx;
+}
+
+/**
+ * Mark the current top of the memory buffer
+ *
+ * @return the mark, to give to \ref mem_release
+ */
+mem_mark_t mem_mark(void) {
+    return mem_idx;
+}
+
+/**
+ * De-allocates everything allocated since a mark was taken
+ *
+ * @param[in] mark the mark
+ */
+void mem_release(mem_mark_t mark) {
+    if (mark < mem_idx) {
+        mem_dealloc(mem_idx - mark);
     }
 }
 
+/**
+ * Get the size left in the memory buffer
+ *
+ * @return number of bytes that can still be allocated
+ */
+size_t mem_available(void) {
+    return MEM_SIZE - mem_idx;
+}
+
 #endif  // HAVE_DYN_MEM_ALLOC
@@ -4,11 +4,55 @@
 #ifdef HAVE_DYN_MEM_ALLOC
 
 #include <stdlib.h>
+#include <stdint.h>
+
+// Size of the memory buffer, set at build time per target
+#ifndef MEM_SIZE
+#define MEM_SIZE 8192
+#endif
+
+// Position in the memory buffer, everything allocated after it being released at once
+typedef size_t mem_mark_t;
+
+// Subsystems the allocations are accounted to
+typedef enum {
+    MEM_TAG_OTHER = 0,
+    MEM_TAG_EIP712_CONTEXT,  // EIP-712 contexts, type names, path & UI
+    MEM_TAG_EIP712_TYPES,    // EIP-712 struct definitions
+    MEM_TAG_EIP712_MESSAGE,  // EIP-712 structs index, hash contexts & field values
+    MEM_TAG_DOMAIN_NAME,
+    MEM_TAG_ABI_DESCRIPTOR,
+    MEM_TAGS_COUNT
+} e_mem_tag;
 
 void mem_init(void);
 void mem_reset(void);
 void *mem_alloc(size_t size);
 void mem_dealloc(size_t size);
+mem_mark_t mem_mark(void);
+void mem_release(mem_mark_t mark);
+size_t mem_available(void);
+
+#ifdef HAVE_PROFILING
+
+typedef struct {
+    uint16_t used;
+    uint16_t high_water;
+    uint16_t tags_high_water[MEM_TAGS_COUNT];
+} mem_stats_t;
+
+void mem_set_tag(e_mem_tag tag);
+const mem_stats_t *mem_get_stats(void);
+void mem_reset_stats(void);
+
+// Account the next allocations to a subsystem
+#define MEM_SET_TAG(tag) mem_set_tag(tag)
+
+#else
+
+#define MEM_SET_TAG(tag)
+
+#endif  // HAVE_PROFILING
 
 #endif  // HAVE_DYN_MEM_ALLOC
 
@@ -3,12 +3,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "chainConfig.h"
+#include "networks.gen.h"
 
 #define UNSUPPORTED_CHAIN_ID_MSG(id)                                              \
     do {                                                                          \
         PRINTF("Unsupported chain ID: %u (app: %u)\n", id, chainConfig->chainId); \
     } while (0)
 
+const network_info_t *get_network_from_chain_id(const uint64_t *chain_id);
 const char *get_network_name_from_chain_id(const uint64_t *chain_id);
 const char *get_network_ticker_from_chain_id(const uint64_t *chain_id);
 
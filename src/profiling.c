@@ -0,0 +1,70 @@
+#ifdef HAVE_PROFILING
+
+#include <string.h>
+#include "os.h"
+#include "profiling.h"
+
+/*
+ * Cumulative call counts of the parser, plugin messages and EIP-712 handlers
+ *
+ * Only in the builds made with PROFILING=1, read & reset with the GET PROFILING COUNTERS command.
+ * A call is identified by a name and an id, the plugin alias and the message for the plugin
+ * calls, the calls without a free counter being dropped until the next reset.
+ *
+ * No elapsed time is counted: the SEPROXYHAL ticker event (every 100 ms) is the only clock of the
+ * apps, and it is only delivered while waiting for an APDU, never during a call.
+ */
+static profiling_counter_t g_counters[PROFILING_MAX_COUNTERS];
+static uint8_t g_counters_count;
+
+static profiling_counter_t *get_counter(const char *name, uint16_t id) {
+    profiling_counter_t *counter;
+
+    for (uint8_t i = 0; i < g_counters_count; i++) {
+        counter = &g_counters[i];
+        if ((counter->id == id) && (strncmp(counter->name, name, sizeof(counter->name) - 1) == 0)) {
+            return counter;
+        }
+    }
+    if (g_counters_count == PROFILING_MAX_COUNTERS) {
+        PRINTF("No profiling counter left for %s/%d\n", name, id);
+        return NULL;
+    }
+    counter = &g_counters[g_counters_count++];
+    strlcpy(counter->name, name, sizeof(counter->name));
+    counter->id = id;
+    counter->calls = 0;
+    return counter;
+}
+
+/**
+ * Count a call
+ *
+ * @param[in] name name of the call
+ * @param[in] id id of the call
+ */
+void profiling_count(const char *name, uint16_t id) {
+    profiling_counter_t *counter = get_counter(name, id);
+
+    if (counter != NULL) {
+        counter->calls += 1;
+    }
+}
+
+uint8_t profiling_counters_count(void) {
+    return g_counters_count;
+}
+
+const profiling_counter_t *profiling_get_counter(uint8_t index) {
+    if (index >= g_counters_count) {
+        return NULL;
+    }
+    return &g_counters[index];
+}
+
+void profiling_reset(void) {
+    memset(g_counters, 0, sizeof(g_counters));
+    g_counters_count = 0;
+}
+
+#endif  // HAVE_PROFILING
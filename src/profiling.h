@@ -0,0 +1,37 @@
+#ifndef PROFILING_H_
+#define PROFILING_H_
+
+#ifdef HAVE_PROFILING
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Distinct (name, id) pairs counted between two resets
+#ifndef PROFILING_MAX_COUNTERS
+#define PROFILING_MAX_COUNTERS 24
+#endif
+
+// Longer names (plugin aliases) are truncated
+#define PROFILING_NAME_LENGTH 16
+
+typedef struct {
+    char name[PROFILING_NAME_LENGTH];
+    uint16_t id;  // plugin message, 0 for the other spans
+    uint32_t calls;
+} profiling_counter_t;
+
+void profiling_count(const char *name, uint16_t id);
+uint8_t profiling_counters_count(void);
+const profiling_counter_t *profiling_get_counter(uint8_t index);
+void profiling_reset(void);
+
+// Count a call, the apps having no clock finer than the 100 ms ticker event
+#define PROFILING_COUNT(name, id) profiling_count(name, id)
+
+#else
+
+#define PROFILING_COUNT(name, id)
+
+#endif  // HAVE_PROFILING
+
+#endif  // PROFILING_H_
@@ -29,7 +29,7 @@
 
 #include "rlp_utils.h"
 
-bool rlpCanDecode(uint8_t *buffer, uint32_t bufferLength, bool *valid) {
+bool rlpCanDecode(const uint8_t *buffer, uint32_t bufferLength, bool *valid) {
     if (*buffer <= 0x7f) {
     } else if (*buffer <= 0xb7) {
     } else if (*buffer <= 0xbf) {
@@ -54,7 +54,7 @@ bool rlpCanDecode(uint8_t *buffer, uint32_t bufferLength, bool *valid) {
     return true;
 }
 
-bool rlpDecodeLength(uint8_t *buffer, uint32_t *fieldLength, uint32_t *offset, bool *list) {
+bool rlpDecodeLength(const uint8_t *buffer, uint32_t *fieldLength, uint32_t *offset, bool *list) {
     if (*buffer <= 0x7f) {
         *offset = 0;
         *fieldLength = 1;
@@ -32,6 +32,13 @@
  * string
  * @return true if the RLP header is consistent
  */
-bool rlpDecodeLength(uint8_t *buffer, uint32_t *fieldLength, uint32_t *offset, bool *list);
+bool rlpDecodeLength(const uint8_t *buffer, uint32_t *fieldLength, uint32_t *offset, bool *list);
 
-bool rlpCanDecode(uint8_t *buffer, uint32_t bufferLength, bool *valid);
+/**
+ * @brief Check whether enough bytes are available to decode an RLP header
+ * @param [in] buffer buffer starting with the RLP header
+ * @param [in] bufferLength number of bytes available in the buffer
+ * @param [out] valid false if the header can never be decoded
+ * @return true if the header can be decoded (or is invalid), false if more bytes are needed
+ */
+bool rlpCanDecode(const uint8_t *buffer, uint32_t bufferLength, bool *valid);
@@ -10,6 +10,7 @@
 #include "tx_content.h"
 #include "chainConfig.h"
 #include "asset_info.h"
+#include "uint256.h"
 #ifdef HAVE_NBGL
 #include "nbgl_types.h"
 #endif
@@ -22,7 +23,12 @@
 
 #define N_storage (*(volatile internalStorage_t *) PIC(&N_storage_real))
 
+// Number of token/NFT descriptions kept during a transaction, set at build time
+#ifndef MAX_ASSETS
 #define MAX_ASSETS 5
+#endif
+// Buckets of the address index of these descriptions
+#define ASSET_BUCKETS (2 * MAX_ASSETS)
 
 typedef struct bip32_path_t {
     uint8_t length;
@@ -39,6 +45,9 @@ typedef struct internalStorage_t {
 #ifdef HAVE_DOMAIN_NAME
     bool verbose_domain_name;
 #endif  // HAVE_DOMAIN_NAME
+#ifdef HAVE_TOKEN_STORE
+    bool tokenStore;
+#endif  // HAVE_TOKEN_STORE
     bool initialized;
 } internalStorage_t;
 
@@ -66,6 +75,8 @@ typedef struct tokenContext_t {
     };
 
     uint8_t pluginStatus;
+    // the plugin gets several parameters per ETH_PLUGIN_PROVIDE_PARAMETER
+    bool pluginBatchParameters;
 
 } tokenContext_t;
 
@@ -83,9 +94,19 @@ typedef struct transactionContext_t {
     uint8_t hash[INT256_LENGTH];
     union extraInfo_t extraInfo[MAX_ASSETS];
     bool assetSet[MAX_ASSETS];
-    uint8_t currentAssetIndex;
+    // asset being provisioned, only stored in the cache once verified
+    union extraInfo_t pendingAsset;
+    uint8_t currentAssetIndex;  // where the last verified asset was stored
+    uint8_t assetBuckets[ASSET_BUCKETS];  // asset index + 1, 0 if empty
+    uint16_t assetLastUse[MAX_ASSETS];
+    uint16_t assetUseTick;
+    // verified root of a batch of token descriptors
+    uint8_t tokenListRoot[INT256_LENGTH];
+    bool tokenListRootSet;
 } transactionContext_t;
 
+_Static_assert(MAX_ASSETS < UINT8_MAX, "Asset indexes must fit in a byte");
+
 typedef struct messageSigningContext_t {
     bip32_path_t bip32;
     uint8_t hash[INT256_LENGTH];
@@ -128,9 +149,11 @@ typedef enum {
 
 typedef struct txStringProperties_s {
     char fullAddress[43];
-    char fullAmount[79];  // 2^256 is 78 digits long
-    char maxFee[50];
+    char fullAmount[AMOUNT256_STRING_SIZE(MAX_TICKER_LEN - 1)];
+    char maxFee[AMOUNT256_STRING_SIZE(MAX_TICKER_LEN - 1)];
     char nonce[8];  // 10M tx per account ought to be enough for everybody
+    char listCount[11];  // Blobs or authorizations of the transaction, up to 2^32
+    char accessList[40];  // "<addresses> addresses, <storage keys> keys"
     char network_name[NETWORK_STRING_MAX_SIZE + 1];
 } txStringProperties_t;
 
@@ -165,10 +188,11 @@ extern bool G_called_from_swap;
 extern bool G_swap_response_ready;
 
 typedef enum {
-    EXTERNAL,     //  External plugin, set by setExternalPlugin.
-    ERC721,       // Specific ERC721 internal plugin, set by setPlugin.
-    ERC1155,      // Specific ERC1155 internal plugin, set by setPlugin
-    OLD_INTERNAL  // Old internal plugin, not set by any command.
+    EXTERNAL,      //  External plugin, set by setExternalPlugin.
+    ERC721,        // Specific ERC721 internal plugin, set by setPlugin.
+    ERC1155,       // Specific ERC1155 internal plugin, set by setPlugin
+    OLD_INTERNAL,  // Old internal plugin, not set by any command.
+    ABI_DECODER    // Generic internal plugin, set by provideAbiDescriptor
 } pluginType_t;
 
 extern pluginType_t pluginType;
@@ -0,0 +1,159 @@
+#include <string.h>
+#include "cx.h"
+#include "common_utils.h"
+#include "sig_cache.h"
+
+/*
+ * Signature verifications which succeeded during this session
+ *
+ * The clients provide the same signed descriptors (tokens, NFTs, plugins, EIP-712 filters...)
+ * again for every transaction, a known one does not need another ECDSA verification.
+ *
+ * Invalidation policy:
+ * - only successful verifications are stored, a failure is always verified again
+ * - an entry covers the public key, the signed hash and the signature all at once
+ * - the least recently used entry is evicted when the cache is full
+ * - the cache only lives in RAM and is emptied when the app starts
+ */
+static struct {
+    uint8_t digest[SIG_CACHE_SIZE][INT256_LENGTH];
+    uint16_t last_use[SIG_CACHE_SIZE];  // 0 = empty
+    uint16_t use_tick;
+} g_sig_cache;
+
+static sig_cache_stats_t g_sig_cache_stats;
+
+_Static_assert(SIG_CACHE_SIZE > 0, "The signature cache needs at least one entry");
+
+/**
+ * Compute the cache digest of a signature verification
+ *
+ * @param[in] raw_key public key
+ * @param[in] raw_key_len public key length
+ * @param[in] hash signed hash
+ * @param[in] hash_len signed hash length
+ * @param[in] sig signature
+ * @param[in] sig_len signature length
+ * @param[out] digest the computed digest
+ * @return whether it was successful
+ */
+static bool sig_cache_digest(const uint8_t *raw_key,
+                             size_t raw_key_len,
+                             const uint8_t *hash,
+                             size_t hash_len,
+                             const uint8_t *sig,
+                             size_t sig_len,
+                             uint8_t *digest) {
+    cx_sha256_t hash_ctx;
+    uint8_t len;
+
+    if (cx_sha256_init_no_throw(&hash_ctx) != CX_OK) {
+        return false;
+    }
+    // length prefixes keep the three fields from being shifted into each other
+    len = raw_key_len;
+    if ((cx_hash_no_throw((cx_hash_t *) &hash_ctx, 0, &len, 1, NULL, 0) != CX_OK) ||
+        (cx_hash_no_throw((cx_hash_t *) &hash_ctx, 0, raw_key, raw_key_len, NULL, 0) != CX_OK)) {
+        return false;
+    }
+    len = hash_len;
+    if ((cx_hash_no_throw((cx_hash_t *) &hash_ctx, 0, &len, 1, NULL, 0) != CX_OK) ||
+        (cx_hash_no_throw((cx_hash_t *) &hash_ctx, 0, hash, hash_len, NULL, 0) != CX_OK)) {
+        return false;
+    }
+    return cx_hash_no_throw((cx_hash_t *) &hash_ctx,
+                            CX_LAST,
+                            sig,
+                            sig_len,
+                            digest,
+                            INT256_LENGTH) == CX_OK;
+}
+
+static void touch_entry(uint8_t index) {
+    if (++g_sig_cache.use_tick == 0) {
+        // wrapped around, keep the entries but start the usage order over
+        for (uint8_t i = 0; i < SIG_CACHE_SIZE; i++) {
+            if (g_sig_cache.last_use[i] != 0) {
+                g_sig_cache.last_use[i] = 1;
+            }
+        }
+        g_sig_cache.use_tick = 2;
+    }
+    g_sig_cache.last_use[index] = g_sig_cache.use_tick;
+}
+
+static void insert_entry(const uint8_t *digest) {
+    uint8_t victim = 0;
+
+    for (uint8_t i = 0; i < SIG_CACHE_SIZE; i++) {
+        if (g_sig_cache.last_use[i] < g_sig_cache.last_use[victim]) {
+            victim = i;
+        }
+    }
+    if (g_sig_cache.last_use[victim] != 0) {
+        g_sig_cache_stats.evictions += 1;
+    }
+    memcpy(g_sig_cache.digest[victim], digest, INT256_LENGTH);
+    touch_entry(victim);
+}
+
+/**
+ * Verify an ECDSA signature, unless the very same verification already succeeded
+ *
+ * @param[in] raw_key secp256k1 public key
+ * @param[in] raw_key_len public key length
+ * @param[in] hash signed hash
+ * @param[in] hash_len signed hash length
+ * @param[in] sig DER-encoded signature
+ * @param[in] sig_len signature length
+ * @return whether the signature is valid
+ */
+bool sig_cache_verify(const uint8_t *raw_key,
+                      size_t raw_key_len,
+                      const uint8_t *hash,
+                      size_t hash_len,
+                      const uint8_t *sig,
+                      size_t sig_len) {
+    uint8_t digest[INT256_LENGTH];
+    cx_ecfp_public_key_t key;
+    bool cacheable;
+
+    cacheable = sig_cache_digest(raw_key, raw_key_len, hash, hash_len, sig, sig_len, digest);
+    if (cacheable) {
+        for (uint8_t i = 0; i < SIG_CACHE_SIZE; i++) {
+            if ((g_sig_cache.last_use[i] != 0) &&
+                (memcmp(g_sig_cache.digest[i], digest, sizeof(digest)) == 0)) {
+                g_sig_cache_stats.hits += 1;
+                touch_entry(i);
+                return true;
+            }
+        }
+    }
+    g_sig_cache_stats.misses += 1;
+
+    if (cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1, raw_key, raw_key_len, &key) != CX_OK) {
+        return false;
+    }
+    if (!cx_ecdsa_verify_no_throw(&key, hash, hash_len, sig, sig_len)) {
+        return false;
+    }
+    if (cacheable) {
+        insert_entry(digest);
+    }
+    return true;
+}
+
+/**
+ * Forget every cached signature verification
+ */
+void sig_cache_reset(void) {
+    memset(&g_sig_cache, 0, sizeof(g_sig_cache));
+}
+
+const sig_cache_stats_t *get_sig_cache_stats(void) {
+    return &g_sig_cache_stats;
+}
+
+void reset_sig_cache_stats(void) {
+    memset(&g_sig_cache_stats, 0, sizeof(g_sig_cache_stats));
+}
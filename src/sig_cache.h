@@ -0,0 +1,28 @@
+#ifndef SIG_CACHE_H_
+#define SIG_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SIG_CACHE_SIZE
+#define SIG_CACHE_SIZE 8
+#endif
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+} sig_cache_stats_t;
+
+bool sig_cache_verify(const uint8_t *raw_key,
+                      size_t raw_key_len,
+                      const uint8_t *hash,
+                      size_t hash_len,
+                      const uint8_t *sig,
+                      size_t sig_len);
+void sig_cache_reset(void);
+const sig_cache_stats_t *get_sig_cache_stats(void);
+void reset_sig_cache_stats(void);
+
+#endif  // SIG_CACHE_H_
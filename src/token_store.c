@@ -0,0 +1,164 @@
+#ifdef HAVE_TOKEN_STORE
+
+#include <string.h>
+#include "os_pic.h"
+#include "shared_context.h"
+#include "token_store.h"
+
+/*
+ * Tokens verified in previous sessions
+ *
+ * Every token successfully provisioned is kept, keyed by (chain ID, address), so that an ERC-20
+ * transaction can still be clear-signed when the app has just been opened.
+ *
+ * To spare the flash:
+ * - new tokens are buffered in RAM and only written at the end of the transaction, or once
+ *   TOKEN_STORE_BATCH of them are waiting
+ * - a token already stored as-is is never written again
+ * - new tokens overwrite the slots in turn instead of always the same ones
+ * - clearing the store only bumps its generation, the entries of an older one are ignored
+ */
+const token_store_t N_token_store_real;
+
+#define N_token_store (*(volatile token_store_t *) PIC(&N_token_store_real))
+
+static token_store_entry_t g_pending[TOKEN_STORE_BATCH];
+static uint8_t g_pending_count;
+
+bool token_store_enabled(void) {
+    return N_storage.tokenStore;
+}
+
+static bool entry_matches(const token_store_entry_t *entry,
+                          uint64_t chain_id,
+                          const uint8_t *address) {
+    return (entry->chain_id == chain_id) &&
+           (memcmp(entry->token.address, address, ADDRESS_LENGTH) == 0);
+}
+
+/**
+ * Find the flash entry of a given token
+ *
+ * @param[in] chain_id chain ID
+ * @param[in] address contract address
+ * @return the slot of the token, \ref TOKEN_STORE_SIZE if it is not stored
+ */
+static uint8_t find_stored(uint64_t chain_id, const uint8_t *address) {
+    const token_store_t *store = (const token_store_t *) &N_token_store;
+
+    if (store->generation == 0) {
+        return TOKEN_STORE_SIZE;
+    }
+    for (uint8_t i = 0; i < TOKEN_STORE_SIZE; i++) {
+        const token_store_entry_t *entry = &store->entries[i];
+
+        if ((entry->generation == store->generation) &&
+            entry_matches(entry, chain_id, address)) {
+            return i;
+        }
+    }
+    return TOKEN_STORE_SIZE;
+}
+
+void token_store_add(uint64_t chain_id, const tokenDefinition_t *token) {
+    const token_store_t *store = (const token_store_t *) &N_token_store;
+    token_store_entry_t *pending = NULL;
+    uint8_t slot;
+
+    if (!token_store_enabled()) {
+        return;
+    }
+    slot = find_stored(chain_id, token->address);
+    if ((slot < TOKEN_STORE_SIZE) &&
+        (memcmp((const void *) &store->entries[slot].token, token, sizeof(*token)) == 0)) {
+        // already known, nothing to write
+        return;
+    }
+    for (uint8_t i = 0; i < g_pending_count; i++) {
+        if (entry_matches(&g_pending[i], chain_id, token->address)) {
+            pending = &g_pending[i];
+            break;
+        }
+    }
+    if (pending == NULL) {
+        if (g_pending_count == TOKEN_STORE_BATCH) {
+            token_store_flush();
+        }
+        pending = &g_pending[g_pending_count++];
+    }
+    pending->chain_id = chain_id;
+    memcpy(&pending->token, token, sizeof(pending->token));
+}
+
+const tokenDefinition_t *token_store_lookup(uint64_t chain_id, const uint8_t *address) {
+    uint8_t slot;
+
+    if (!token_store_enabled()) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < g_pending_count; i++) {
+        if (entry_matches(&g_pending[i], chain_id, address)) {
+            return &g_pending[i].token;
+        }
+    }
+    slot = find_stored(chain_id, address);
+    if (slot == TOKEN_STORE_SIZE) {
+        return NULL;
+    }
+    return (const tokenDefinition_t *) &N_token_store.entries[slot].token;
+}
+
+/**
+ * Start a new generation of the store, which invalidates all of its entries
+ *
+ * It would take billions of them to wrap around.
+ */
+static void new_generation(void) {
+    uint32_t generation = N_token_store.generation + 1;
+
+    nvm_write((void *) &N_token_store.generation, (void *) &generation, sizeof(generation));
+}
+
+/**
+ * Write the buffered tokens to flash
+ *
+ * A token already stored is updated in place, a new one takes the next slot in turn.
+ */
+void token_store_flush(void) {
+    const token_store_t *store = (const token_store_t *) &N_token_store;
+    uint8_t next;
+
+    if (g_pending_count == 0) {
+        return;
+    }
+    if (store->generation == 0) {
+        new_generation();
+    }
+    next = store->next;
+    for (uint8_t i = 0; i < g_pending_count; i++) {
+        uint8_t slot = find_stored(g_pending[i].chain_id, g_pending[i].token.address);
+
+        if (slot == TOKEN_STORE_SIZE) {
+            slot = next;
+            next = (next + 1) % TOKEN_STORE_SIZE;
+        }
+        g_pending[i].generation = store->generation;
+        nvm_write((void *) &N_token_store.entries[slot],
+                  (void *) &g_pending[i],
+                  sizeof(g_pending[i]));
+    }
+    if (next != store->next) {
+        nvm_write((void *) &N_token_store.next, (void *) &next, sizeof(next));
+    }
+    g_pending_count = 0;
+}
+
+/**
+ * Forget every stored token, including the ones not written yet
+ */
+void token_store_clear(void) {
+    g_pending_count = 0;
+    new_generation();
+}
+
+#endif  // HAVE_TOKEN_STORE
@@ -0,0 +1,38 @@
+#ifndef TOKEN_STORE_H_
+#define TOKEN_STORE_H_
+
+#ifdef HAVE_TOKEN_STORE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "asset_info.h"
+
+// Number of verified tokens kept in flash, set at build time
+#ifndef TOKEN_STORE_SIZE
+#define TOKEN_STORE_SIZE 32
+#endif
+
+// Number of verified tokens buffered in RAM before they are written to flash
+#define TOKEN_STORE_BATCH 4
+
+typedef struct {
+    uint32_t generation;  // only valid when equal to the one of the store
+    uint64_t chain_id;
+    tokenDefinition_t token;
+} token_store_entry_t;
+
+typedef struct {
+    uint32_t generation;  // 0 = never used
+    uint8_t next;         // slot overwritten by the next new token
+    token_store_entry_t entries[TOKEN_STORE_SIZE];
+} token_store_t;
+
+bool token_store_enabled(void);
+void token_store_add(uint64_t chain_id, const tokenDefinition_t *token);
+const tokenDefinition_t *token_store_lookup(uint64_t chain_id, const uint8_t *address);
+void token_store_flush(void);
+void token_store_clear(void);
+
+#endif  // HAVE_TOKEN_STORE
+
+#endif  // TOKEN_STORE_H_
@@ -186,66 +186,29 @@ void divmod128(const uint128_t *const l,
                const uint128_t *const r,
                uint128_t *const retDiv,
                uint128_t *const retMod) {
-    uint128_t copyd, adder, resDiv, resMod;
-    uint128_t one;
-    UPPER(one) = 0;
-    LOWER(one) = 1;
-    uint32_t diffBits = bits128(l) - bits128(r);
-    clear128(&resDiv);
-    copy128(&resMod, l);
-    if (gt128(r, l)) {
-        copy128(retMod, l);
-        clear128(retDiv);
-    } else {
-        shiftl128(r, diffBits, &copyd);
-        shiftl128(&one, diffBits, &adder);
-        if (gt128(&copyd, &resMod)) {
-            shiftr128(&copyd, 1, &copyd);
-            shiftr128(&adder, 1, &adder);
-        }
-        while (gte128(&resMod, r)) {
-            if (gte128(&resMod, &copyd)) {
-                sub128(&resMod, &copyd, &resMod);
-                or128(&resDiv, &adder, &resDiv);
-            }
-            shiftr128(&copyd, 1, &copyd);
-            shiftr128(&adder, 1, &adder);
-        }
-        copy128(retDiv, &resDiv);
-        copy128(retMod, &resMod);
-    }
+    const uint64_t lLimbs[2] = {LOWER_P(l), UPPER_P(l)};
+    const uint64_t rLimbs[2] = {LOWER_P(r), UPPER_P(r)};
+    uint32_t dividend[4], divisor[4], quotient[4], remainder[4];
+    uint64_t limbs[2];
+    limbs_to_digits(lLimbs, 2, dividend);
+    limbs_to_digits(rLimbs, 2, divisor);
+    divmod_digits(dividend, divisor, 4, quotient, remainder);
+    digits_to_limbs(quotient, 2, limbs);
+    LOWER_P(retDiv) = limbs[0];
+    UPPER_P(retDiv) = limbs[1];
+    digits_to_limbs(remainder, 2, limbs);
+    LOWER_P(retMod) = limbs[0];
+    UPPER_P(retMod) = limbs[1];
 }
 
 bool tostring128(const uint128_t *const number,
                  uint32_t baseParam,
                  char *const out,
                  uint32_t outLength) {
-    uint128_t rDiv;
-    uint128_t rMod;
-    uint128_t base;
-    copy128(&rDiv, number);
-    clear128(&rMod);
-    clear128(&base);
-    LOWER(base) = baseParam;
-    uint32_t offset = 0;
-    if ((baseParam < 2) || (baseParam > 16)) {
-        return false;
-    }
-    do {
-        if (offset > (outLength - 1)) {
-            return false;
-        }
-        divmod128(&rDiv, &base, &rDiv, &rMod);
-        out[offset++] = HEXDIGITS[(uint8_t) LOWER(rMod)];
-    } while (!zero128(&rDiv));
-
-    if (offset > (outLength - 1)) {
-        return false;
-    }
-
-    out[offset] = '\0';
-    reverseString(out, offset);
-    return true;
+    const uint64_t limbs[2] = {LOWER_P(number), UPPER_P(number)};
+    uint32_t digits[4];
+    limbs_to_digits(limbs, 2, digits);
+    return tostring_digits(digits, 4, baseParam, out, outLength);
 }
 
 /**
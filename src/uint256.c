@@ -162,9 +162,51 @@ void or256(const uint256_t *const number1,
     or128(&LOWER_P(number1), &LOWER_P(number2), &LOWER_P(target));
 }
 
+static void to_digits256(const uint256_t *const number, uint32_t *const digits) {
+    const uint64_t limbs[4] = {LOWER(LOWER_P(number)),
+                               UPPER(LOWER_P(number)),
+                               LOWER(UPPER_P(number)),
+                               UPPER(UPPER_P(number))};
+    limbs_to_digits(limbs, 4, digits);
+}
+
+static void from_digits256(const uint32_t *const digits, uint256_t *const number) {
+    uint64_t limbs[4];
+    digits_to_limbs(digits, 4, limbs);
+    LOWER(LOWER_P(number)) = limbs[0];
+    UPPER(LOWER_P(number)) = limbs[1];
+    LOWER(UPPER_P(number)) = limbs[2];
+    UPPER(UPPER_P(number)) = limbs[3];
+}
+
+/**
+ * Multiply two uint256_t, the result being truncated to 256 bits
+ *
+ * Backed by cx_math_mult when HAVE_CX_MULT256 is defined, by a native multiplication otherwise.
+ */
 void mul256(const uint256_t *const number1,
             const uint256_t *const number2,
             uint256_t *const target) {
+#ifdef HAVE_CX_MULT256
+    mul256_cx(number1, number2, target);
+#else
+    mul256_native(number1, number2, target);
+#endif
+}
+
+void mul256_native(const uint256_t *const number1,
+                   const uint256_t *const number2,
+                   uint256_t *const target) {
+    uint32_t num1[8], num2[8], result[8];
+    to_digits256(number1, num1);
+    to_digits256(number2, num2);
+    mul_digits(num1, num2, 8, result, 8);
+    from_digits256(result, target);
+}
+
+void mul256_cx(const uint256_t *const number1,
+               const uint256_t *const number2,
+               uint256_t *const target) {
     uint8_t num1[INT256_LENGTH], num2[INT256_LENGTH], result[INT256_LENGTH * 2];
     memset(&result, 0, sizeof(result));
     for (uint8_t i = 0; i < 4; i++) {
@@ -177,63 +219,89 @@ void mul256(const uint256_t *const number1,
     }
 }
 
+/**
+ * Multiply two uint256_t into a 512-bit result
+ *
+ * @param[in] number1 the first factor
+ * @param[in] number2 the second factor
+ * @param[out] high the 256 most significant bits of the product
+ * @param[out] low the 256 least significant bits of the product
+ */
+void mul256_full(const uint256_t *const number1,
+                 const uint256_t *const number2,
+                 uint256_t *const high,
+                 uint256_t *const low) {
+    uint32_t num1[8], num2[8], result[16];
+    to_digits256(number1, num1);
+    to_digits256(number2, num2);
+    mul_digits(num1, num2, 8, result, 16);
+    from_digits256(result, low);
+    from_digits256(result + 8, high);
+}
+
+/**
+ * Multiply two uint256_t
+ *
+ * @param[in] number1 the first factor
+ * @param[in] number2 the second factor
+ * @param[out] target the product, left untouched on overflow
+ * @return false if the product does not fit in 256 bits
+ */
+bool mul256_checked(const uint256_t *const number1,
+                    const uint256_t *const number2,
+                    uint256_t *const target) {
+    uint256_t high, low;
+    mul256_full(number1, number2, &high, &low);
+    if (!zero256(&high)) {
+        return false;
+    }
+    copy256(target, &low);
+    return true;
+}
+
+/**
+ * Add two uint256_t
+ *
+ * @param[in] number1 the first term
+ * @param[in] number2 the second term
+ * @param[out] target the sum, left untouched on overflow
+ * @return false if the sum does not fit in 256 bits
+ */
+bool add256_checked(const uint256_t *const number1,
+                    const uint256_t *const number2,
+                    uint256_t *const target) {
+    uint256_t sum;
+    add256(number1, number2, &sum);
+    if (gt256(number1, &sum)) {
+        return false;
+    }
+    copy256(target, &sum);
+    return true;
+}
+
 void divmod256(const uint256_t *const l,
                const uint256_t *const r,
                uint256_t *const retDiv,
                uint256_t *const retMod) {
-    uint256_t copyd, adder, resDiv, resMod;
-    uint256_t one;
-    clear256(&one);
-    UPPER(LOWER(one)) = 0;
-    LOWER(LOWER(one)) = 1;
-    uint32_t diffBits = bits256(l) - bits256(r);
-    clear256(&resDiv);
-    copy256(&resMod, l);
-    if (gt256(r, l)) {
-        copy256(retMod, l);
-        clear256(retDiv);
-    } else {
-        shiftl256(r, diffBits, &copyd);
-        shiftl256(&one, diffBits, &adder);
-        if (gt256(&copyd, &resMod)) {
-            shiftr256(&copyd, 1, &copyd);
-            shiftr256(&adder, 1, &adder);
-        }
-        while (gte256(&resMod, r)) {
-            if (gte256(&resMod, &copyd)) {
-                sub256(&resMod, &copyd, &resMod);
-                or256(&resDiv, &adder, &resDiv);
-            }
-            shiftr256(&copyd, 1, &copyd);
-            shiftr256(&adder, 1, &adder);
-        }
-        copy256(retDiv, &resDiv);
-        copy256(retMod, &resMod);
-    }
+    uint32_t dividend[8], divisor[8], quotient[8], remainder[8];
+    to_digits256(l, dividend);
+    to_digits256(r, divisor);
+    divmod_digits(dividend, divisor, 8, quotient, remainder);
+    from_digits256(quotient, retDiv);
+    from_digits256(remainder, retMod);
 }
 
 bool tostring256(const uint256_t *const number,
                  uint32_t baseParam,
                  char *const out,
                  uint32_t outLength) {
-    uint256_t rDiv;
-    uint256_t rMod;
-    uint256_t base;
-    copy256(&rDiv, number);
-    clear256(&rMod);
-    clear256(&base);
-    UPPER(LOWER(base)) = 0;
-    LOWER(LOWER(base)) = baseParam;
-    uint32_t offset = 0;
+    uint32_t digits[8];
     if ((outLength == 0) || (baseParam < 2) || (baseParam > 16)) {
         return false;
     }
-    do {
-        divmod256(&rDiv, &base, &rDiv, &rMod);
-        out[offset++] = HEXDIGITS[(uint8_t) LOWER(LOWER(rMod))];
-    } while (!zero256(&rDiv) && (offset < outLength));
-
-    if (offset == outLength) {  // destination buffer too small
+    to_digits256(number, digits);
+    if (!tostring_digits(digits, 8, baseParam, out, outLength)) {
+        // destination buffer too small
         if (outLength > 3) {
             strlcpy(out, "...", outLength);
         } else {
@@ -241,9 +309,6 @@ bool tostring256(const uint256_t *const number,
         }
         return false;
     }
-
-    out[offset] = '\0';
-    reverseString(out, offset);
     return true;
 }
 
@@ -293,3 +358,106 @@ void convertUint256BE(const uint8_t *const data, uint32_t length, uint256_t *con
     memmove(tmp + sizeof(tmp) - length, data, length);
     readu256BE(tmp, target);
 }
+
+/**
+ * Format a uint256_t as a fixed-point decimal amount, prefixed by a ticker
+ *
+ * The trailing zeros of the fractional part are dropped (e.g. 1500000000000000000 with 18 decimals
+ * and the "ETH" ticker gives "ETH 1.5"). The digits are formatted in a scratch buffer, so the
+ * output buffer only has to hold the result, see AMOUNT256_STRING_SIZE.
+ *
+ * @param[in] amount the raw amount
+ * @param[in] decimals the number of decimals of the amount
+ * @param[in] ticker the ticker, followed by a space in the output unless empty (may be NULL)
+ * @param[out] out the output buffer
+ * @param[in] out_size the size of the output buffer
+ * @return false if the output buffer is too small, in which case it is left empty
+ */
+bool amount256_to_string(const uint256_t *const amount,
+                         uint8_t decimals,
+                         const char *const ticker,
+                         char *const out,
+                         size_t out_size) {
+    uint32_t digits[8];
+    char str[UINT256_DIGITS + 1];
+    size_t ticker_length = 0;
+    size_t length;
+    size_t amount_length;
+    size_t offset = 0;
+
+    if (out_size == 0) {
+        return false;
+    }
+    out[0] = '\0';
+    to_digits256(amount, digits);
+    if (!tostring_digits(digits, 8, 10, str, sizeof(str))) {
+        return false;
+    }
+    length = strlen(str);
+    if (zero256(amount)) {
+        decimals = 0;
+    }
+    while ((decimals > 0) && (str[length - 1] == '0')) {
+        length -= 1;
+        decimals -= 1;
+    }
+    if (length > decimals) {
+        // integer part, then decimal point & fractional part if any
+        amount_length = length + ((decimals > 0) ? 1 : 0);
+    } else {
+        // "0.", then the leading zeros of the fractional part
+        amount_length = 2 + decimals;
+    }
+    if ((ticker != NULL) && (ticker[0] != '\0')) {
+        ticker_length = strlen(ticker);
+        offset = ticker_length + 1;
+    }
+    if ((offset + amount_length + 1) > out_size) {
+        return false;
+    }
+    if (ticker_length > 0) {
+        memcpy(out, ticker, ticker_length);
+        out[ticker_length] = ' ';
+    }
+    if (length > decimals) {
+        memcpy(out + offset, str, length - decimals);
+        offset += length - decimals;
+        if (decimals > 0) {
+            out[offset++] = '.';
+            memcpy(out + offset, str + length - decimals, decimals);
+            offset += decimals;
+        }
+    } else {
+        out[offset++] = '0';
+        out[offset++] = '.';
+        memset(out + offset, '0', decimals - length);
+        offset += decimals - length;
+        memcpy(out + offset, str, length);
+        offset += length;
+    }
+    out[offset] = '\0';
+    return true;
+}
+
+/**
+ * Format a big-endian amount as a fixed-point decimal amount, prefixed by a ticker
+ *
+ * @param[in] amount the raw big-endian amount
+ * @param[in] amount_size the size of the amount, at most 32 bytes
+ * @see amount256_to_string for the other parameters
+ * @return false if the amount is too large or the output buffer too small
+ */
+bool amount_to_string(const uint8_t *const amount,
+                      uint8_t amount_size,
+                      uint8_t decimals,
+                      const char *const ticker,
+                      char *const out,
+                      size_t out_size) {
+    uint256_t value;
+
+    if (amount_size > INT256_LENGTH) {
+        return false;
+    }
+    convertUint256BE(amount, amount_size, &value);
+    return amount256_to_string(&value, decimals, ticker, out, out_size);
+}
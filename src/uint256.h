@@ -22,12 +22,20 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "uint128.h"
 
 typedef struct uint256_t {
     uint128_t elements[2];
 } uint256_t;
 
+// Decimal digits of the largest uint256_t
+#define UINT256_DIGITS 78
+
+// Output size of amount256_to_string for any amount of less than UINT256_DIGITS decimals, with a
+// ticker of at most ticker_length characters: ticker, space, digits, decimal point and terminator
+#define AMOUNT256_STRING_SIZE(ticker_length) ((ticker_length) + 1 + UINT256_DIGITS + 1 + 1)
+
 void readu256BE(const uint8_t *const buffer, uint256_t *const target);
 bool zero256(const uint256_t *const number);
 void copy256(uint256_t *const target, const uint256_t *const number);
@@ -48,6 +56,22 @@ void or256(const uint256_t *const number1, const uint256_t *const number2, uint2
 void mul256(const uint256_t *const number1,
             const uint256_t *const number2,
             uint256_t *const target);
+void mul256_native(const uint256_t *const number1,
+                   const uint256_t *const number2,
+                   uint256_t *const target);
+void mul256_cx(const uint256_t *const number1,
+               const uint256_t *const number2,
+               uint256_t *const target);
+void mul256_full(const uint256_t *const number1,
+                 const uint256_t *const number2,
+                 uint256_t *const high,
+                 uint256_t *const low);
+bool mul256_checked(const uint256_t *const number1,
+                    const uint256_t *const number2,
+                    uint256_t *const target);
+bool add256_checked(const uint256_t *const number1,
+                    const uint256_t *const number2,
+                    uint256_t *const target);
 void divmod256(const uint256_t *const l,
                const uint256_t *const r,
                uint256_t *const div,
@@ -58,5 +82,18 @@ bool tostring256_signed(const uint256_t *const number,
                         char *const out,
                         uint32_t out_length);
 void convertUint256BE(const uint8_t *const data, uint32_t length, uint256_t *const target);
+// Returns false, leaving out empty, when the formatted amount does not fit in out_size (always
+// enough from AMOUNT256_STRING_SIZE), only the formatted amount being written to out
+bool amount256_to_string(const uint256_t *const amount,
+                         uint8_t decimals,
+                         const char *const ticker,
+                         char *const out,
+                         size_t out_size);
+bool amount_to_string(const uint8_t *const amount,
+                      uint8_t amount_size,
+                      uint8_t decimals,
+                      const char *const ticker,
+                      char *const out,
+                      size_t out_size);
 
 #endif  // _UINT256_H_
@@ -18,6 +18,7 @@
 // Adapted from https://github.com/calccrypto/uint256_t
 
 #include "uint_common.h"
+#include "common_utils.h"  // HEXDIGITS
 
 void write_u64_be(uint8_t *const buffer, uint64_t value) {
     buffer[0] = ((value >> 56) & 0xff);
@@ -58,3 +59,246 @@ void reverseString(char *const str, uint32_t length) {
         str[j] = c;
     }
 }
+
+/**
+ * Split 64-bit limbs into 32-bit digits, both being little-endian
+ *
+ * @param[in] limbs the limbs, least significant first
+ * @param[in] count the number of limbs
+ * @param[out] digits the 2 * count digits
+ */
+void limbs_to_digits(const uint64_t *const limbs, uint32_t count, uint32_t *const digits) {
+    for (uint32_t i = 0; i < count; i++) {
+        digits[2 * i] = (uint32_t) limbs[i];
+        digits[2 * i + 1] = (uint32_t) (limbs[i] >> UINT_DIGIT_BITS);
+    }
+}
+
+/**
+ * Join 32-bit digits into 64-bit limbs, both being little-endian
+ *
+ * @param[in] digits the 2 * count digits, least significant first
+ * @param[in] count the number of limbs
+ * @param[out] limbs the limbs
+ */
+void digits_to_limbs(const uint32_t *const digits, uint32_t count, uint64_t *const limbs) {
+    for (uint32_t i = 0; i < count; i++) {
+        limbs[i] = ((uint64_t) digits[2 * i + 1] << UINT_DIGIT_BITS) | digits[2 * i];
+    }
+}
+
+/**
+ * Schoolbook multiplication of two numbers of the same number of digits
+ *
+ * Only the productLength least significant digits of the product are computed, length of them
+ * give the truncated product and 2 * length the full one.
+ *
+ * @param[in] number1 the first factor
+ * @param[in] number2 the second factor
+ * @param[in] length the number of digits of the factors
+ * @param[out] product the product, must not overlap with the factors
+ * @param[in] productLength the number of digits of the product, at most 2 * length
+ */
+void mul_digits(const uint32_t *const number1,
+                const uint32_t *const number2,
+                uint32_t length,
+                uint32_t *const product,
+                uint32_t productLength) {
+    memset(product, 0, productLength * sizeof(uint32_t));
+    for (uint32_t i = 0; (i < length) && (i < productLength); i++) {
+        uint64_t carry = 0;
+
+        if (number1[i] == 0) {
+            continue;
+        }
+        for (uint32_t j = 0; (j < length) && ((i + j) < productLength); j++) {
+            // Can not overflow : (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1
+            uint64_t t = (uint64_t) number1[i] * number2[j] + product[i + j] + carry;
+            product[i + j] = (uint32_t) t;
+            carry = t >> UINT_DIGIT_BITS;
+        }
+        if ((i + length) < productLength) {
+            product[i + length] = (uint32_t) carry;
+        }
+    }
+}
+
+static uint32_t significant_digits(const uint32_t *const number, uint32_t length) {
+    while ((length > 0) && (number[length - 1] == 0)) {
+        length--;
+    }
+    return length;
+}
+
+static uint32_t leading_zeros(uint32_t digit) {
+    uint32_t count = 0;
+
+    while ((digit & 0x80000000) == 0) {
+        digit <<= 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Long division of two numbers of the same number of digits
+ *
+ * Single digit divisors take a fast path, the general case is Knuth's algorithm D (The Art of
+ * Computer Programming, vol. 2, 4.3.1). A division by zero gives a quotient of zero and the
+ * dividend as remainder.
+ *
+ * @param[in] dividend the dividend
+ * @param[in] divisor the divisor
+ * @param[in] length the number of digits of every operand, at most UINT_MAX_DIGITS
+ * @param[out] quotient the quotient, must not overlap with the inputs
+ * @param[out] remainder the remainder, must not overlap with the inputs
+ */
+void divmod_digits(const uint32_t *const dividend,
+                   const uint32_t *const divisor,
+                   uint32_t length,
+                   uint32_t *const quotient,
+                   uint32_t *const remainder) {
+    uint32_t un[UINT_MAX_DIGITS + 1];
+    uint32_t vn[UINT_MAX_DIGITS];
+    uint32_t m = significant_digits(dividend, length);
+    uint32_t n = significant_digits(divisor, length);
+    uint32_t shift;
+
+    memset(quotient, 0, length * sizeof(uint32_t));
+    memset(remainder, 0, length * sizeof(uint32_t));
+    if ((n == 0) || (m < n)) {
+        memmove(remainder, dividend, length * sizeof(uint32_t));
+        return;
+    }
+    if (n == 1) {
+        uint64_t rem = 0;
+
+        for (uint32_t i = m; i-- > 0;) {
+            uint64_t current = (rem << UINT_DIGIT_BITS) | dividend[i];
+            quotient[i] = (uint32_t) (current / divisor[0]);
+            rem = current - (uint64_t) quotient[i] * divisor[0];
+        }
+        remainder[0] = (uint32_t) rem;
+        return;
+    }
+
+    // Normalize so that the most significant digit of the divisor has its top bit set, it keeps
+    // the estimated quotient digits at most 2 above the actual ones
+    shift = leading_zeros(divisor[n - 1]);
+    for (uint32_t i = n - 1; i > 0; i--) {
+        vn[i] = (divisor[i] << shift) |
+                (shift ? (divisor[i - 1] >> (UINT_DIGIT_BITS - shift)) : 0);
+    }
+    vn[0] = divisor[0] << shift;
+    un[m] = shift ? (dividend[m - 1] >> (UINT_DIGIT_BITS - shift)) : 0;
+    for (uint32_t i = m - 1; i > 0; i--) {
+        un[i] = (dividend[i] << shift) |
+                (shift ? (dividend[i - 1] >> (UINT_DIGIT_BITS - shift)) : 0);
+    }
+    un[0] = dividend[0] << shift;
+
+    for (uint32_t j = m - n + 1; j-- > 0;) {
+        uint64_t numerator = ((uint64_t) un[j + n] << UINT_DIGIT_BITS) | un[j + n - 1];
+        uint64_t qhat = numerator / vn[n - 1];
+        uint64_t rhat = numerator - qhat * vn[n - 1];
+        int64_t borrow = 0;
+        int64_t t;
+
+        // Estimate the quotient digit from the top two digits
+        while (((qhat >> UINT_DIGIT_BITS) != 0) ||
+               ((qhat * vn[n - 2]) > ((rhat << UINT_DIGIT_BITS) | un[j + n - 2]))) {
+            qhat -= 1;
+            rhat += vn[n - 1];
+            if ((rhat >> UINT_DIGIT_BITS) != 0) {
+                break;
+            }
+        }
+        // Multiply and subtract
+        for (uint32_t i = 0; i < n; i++) {
+            uint64_t product = qhat * vn[i];
+
+            t = (int64_t) un[i + j] - borrow - (int64_t) (product & 0xFFFFFFFF);
+            un[i + j] = (uint32_t) t;
+            borrow = (int64_t) (product >> UINT_DIGIT_BITS) - (t >> UINT_DIGIT_BITS);
+        }
+        t = (int64_t) un[j + n] - borrow;
+        un[j + n] = (uint32_t) t;
+        quotient[j] = (uint32_t) qhat;
+        if (t < 0) {
+            // The estimate was one too large, add the divisor back
+            uint64_t carry = 0;
+
+            quotient[j] -= 1;
+            for (uint32_t i = 0; i < n; i++) {
+                uint64_t sum = (uint64_t) un[i + j] + vn[i] + carry;
+                un[i + j] = (uint32_t) sum;
+                carry = sum >> UINT_DIGIT_BITS;
+            }
+            un[j + n] += (uint32_t) carry;
+        }
+    }
+
+    // Unnormalize the remainder
+    for (uint32_t i = 0; i < n; i++) {
+        remainder[i] =
+            (un[i] >> shift) | (shift ? (un[i + 1] << (UINT_DIGIT_BITS - shift)) : 0);
+    }
+}
+
+/**
+ * Format a number in the given base
+ *
+ * Every division peels off as many digits as fit in 64 bits (19 in base 10), which are then
+ * extracted from the 64-bit remainder.
+ *
+ * @param[in] number the number
+ * @param[in] length the number of digits of the number, at most UINT_MAX_DIGITS
+ * @param[in] base the radix used in formatting, between 2 and 16
+ * @param[out] out the output buffer
+ * @param[in] outLength the length of the output buffer
+ * @return whether the formatting was successful or not (invalid base or buffer too small)
+ */
+bool tostring_digits(const uint32_t *const number,
+                     uint32_t length,
+                     uint32_t base,
+                     char *const out,
+                     uint32_t outLength) {
+    uint32_t dividend[UINT_MAX_DIGITS];
+    uint32_t divisor[UINT_MAX_DIGITS] = {0};
+    uint32_t quotient[UINT_MAX_DIGITS];
+    uint32_t remainder[UINT_MAX_DIGITS];
+    uint64_t chunk = base;
+    uint32_t chunkDigits = 1;
+    uint32_t offset = 0;
+    bool last;
+
+    if ((base < 2) || (base > 16) || (outLength == 0) || (length > UINT_MAX_DIGITS)) {
+        return false;
+    }
+    while (chunk <= (UINT64_MAX / base)) {
+        chunk *= base;
+        chunkDigits++;
+    }
+    limbs_to_digits(&chunk, 1, divisor);
+    memmove(dividend, number, length * sizeof(uint32_t));
+    do {
+        uint64_t rem;
+
+        divmod_digits(dividend, divisor, length, quotient, remainder);
+        digits_to_limbs(remainder, 1, &rem);
+        last = (significant_digits(quotient, length) == 0);
+        // Digits are produced least significant first, only the last chunk is not zero-padded
+        for (uint32_t i = 0; (i < chunkDigits) && (!last || (rem != 0) || (i == 0)); i++) {
+            if (offset >= (outLength - 1)) {
+                return false;
+            }
+            out[offset++] = HEXDIGITS[rem % base];
+            rem /= base;
+        }
+        memmove(dividend, quotient, length * sizeof(uint32_t));
+    } while (!last);
+
+    out[offset] = '\0';
+    reverseString(out, offset);
+    return true;
+}
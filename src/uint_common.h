@@ -20,6 +20,7 @@
 #ifndef _UINT_COMMON_H_
 #define _UINT_COMMON_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -35,4 +36,27 @@ void read_u64_be(const uint8_t *const in, uint64_t *const out);
 uint64_t readUint64BE(const uint8_t *const buffer);
 void reverseString(char *const str, uint32_t length);
 
+// Numbers are handled by the division engine as little-endian arrays of 32-bit digits, so that
+// every intermediate product fits in 64 bits
+#define UINT_DIGIT_BITS  32
+#define UINT_MAX_DIGITS  8  // 256 bits
+
+void limbs_to_digits(const uint64_t *const limbs, uint32_t count, uint32_t *const digits);
+void digits_to_limbs(const uint32_t *const digits, uint32_t count, uint64_t *const limbs);
+void mul_digits(const uint32_t *const number1,
+                const uint32_t *const number2,
+                uint32_t length,
+                uint32_t *const product,
+                uint32_t productLength);
+void divmod_digits(const uint32_t *const dividend,
+                   const uint32_t *const divisor,
+                   uint32_t length,
+                   uint32_t *const quotient,
+                   uint32_t *const remainder);
+bool tostring_digits(const uint32_t *const number,
+                     uint32_t length,
+                     uint32_t base,
+                     char *const out,
+                     uint32_t outLength);
+
 #endif  //_UINT_COMMON_H_
@@ -2,6 +2,7 @@
 #include "ui_callbacks.h"
 #include "common_ui.h"
 #include "common_utils.h"
+#include "token_store.h"
 
 #define ENABLED_STR   "Enabled"
 #define DISABLED_STR  "Disabled"
@@ -14,6 +15,7 @@
 #define SETTING_DISPLAY_NONCE_STATE       (strings.common.fullAmount + (BUF_INCREMENT * 2))
 #define SETTING_VERBOSE_EIP712_STATE      (strings.common.fullAmount + (BUF_INCREMENT * 3))
 #define SETTING_VERBOSE_DOMAIN_NAME_STATE (strings.common.fullAmount + (BUF_INCREMENT * 4))
+#define SETTING_TOKEN_STORE_STATE         (strings.common.fullAmount + (BUF_INCREMENT * 5))
 
 #define BOOL_TO_STATE_STR(b) (b ? ENABLED_STR : DISABLED_STR)
 
@@ -27,6 +29,9 @@ static void switch_settings_verbose_eip712(void);
 #ifdef HAVE_DOMAIN_NAME
 static void switch_settings_verbose_domain_name(void);
 #endif  // HAVE_DOMAIN_NAME
+#ifdef HAVE_TOKEN_STORE
+static void switch_settings_token_store(void);
+#endif  // HAVE_TOKEN_STORE
 
 //////////////////////////////////////////////////////////////////////
 // clang-format off
@@ -157,6 +162,19 @@ UX_STEP_CB(
     });
 #endif // HAVE_DOMAIN_NAME
 
+#ifdef HAVE_TOKEN_STORE
+UX_STEP_CB(
+    ux_settings_flow_token_store_step,
+    bnnn,
+    switch_settings_token_store(),
+    {
+      "Remember tokens",
+      "Keep verified tokens",
+      "across sessions",
+      SETTING_TOKEN_STORE_STATE
+    });
+#endif // HAVE_TOKEN_STORE
+
 
 UX_STEP_CB(
     ux_settings_flow_back_step,
@@ -178,6 +196,9 @@ UX_FLOW(ux_settings_flow,
 #ifdef HAVE_DOMAIN_NAME
         &ux_settings_flow_verbose_domain_name_step,
 #endif  // HAVE_DOMAIN_NAME
+#ifdef HAVE_TOKEN_STORE
+        &ux_settings_flow_token_store_step,
+#endif  // HAVE_TOKEN_STORE
         &ux_settings_flow_back_step);
 
 static void display_settings(const ux_flow_step_t* const start_step) {
@@ -196,6 +217,9 @@ static void display_settings(const ux_flow_step_t* const start_step) {
             BOOL_TO_STATE_STR(N_storage.verbose_domain_name),
             BUF_INCREMENT);
 #endif  // HAVE_DOMAIN_NAME
+#ifdef HAVE_TOKEN_STORE
+    strlcpy(SETTING_TOKEN_STORE_STATE, BOOL_TO_STATE_STR(N_storage.tokenStore), BUF_INCREMENT);
+#endif  // HAVE_TOKEN_STORE
 
     ux_flow_init(0, ux_settings_flow, start_step);
 }
@@ -230,6 +254,16 @@ static void switch_settings_verbose_domain_name(void) {
 }
 #endif  // HAVE_DOMAIN_NAME
 
+#ifdef HAVE_TOKEN_STORE
+static void switch_settings_token_store(void) {
+    // turning it off forgets the tokens
+    if (N_storage.tokenStore) {
+        token_store_clear();
+    }
+    toggle_setting(&N_storage.tokenStore, &ux_settings_flow_token_store_step);
+}
+#endif  // HAVE_TOKEN_STORE
+
 //////////////////////////////////////////////////////////////////////
 // clang-format off
 #ifdef TARGET_NANOS
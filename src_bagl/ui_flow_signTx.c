@@ -192,6 +192,30 @@ UX_STEP_NOCB(
       .text = strings.common.nonce,
     });
 
+UX_STEP_NOCB(
+    ux_approval_access_list_step,
+    bnnn_paging,
+    {
+      .title = "Access list",
+      .text = strings.common.accessList,
+    });
+
+UX_STEP_NOCB(
+    ux_approval_blobs_step,
+    bnnn_paging,
+    {
+      .title = "Blobs",
+      .text = strings.common.listCount,
+    });
+
+UX_STEP_NOCB(
+    ux_approval_authorizations_step,
+    bnnn_paging,
+    {
+      .title = "Authorizations",
+      .text = strings.common.listCount,
+    });
+
 UX_STEP_NOCB(ux_approval_blind_signing_warning_step,
     pbb,
     {
@@ -235,6 +259,15 @@ void ux_approve_tx(bool fromPlugin) {
 #endif  // HAVE_DOMAIN_NAME
     }
 
+    if (txContext.summary.accessList.addresses != 0) {
+        ux_approval_tx_flow[step++] = &ux_approval_access_list_step;
+    }
+    if (txContext.txType == EIP4844) {
+        ux_approval_tx_flow[step++] = &ux_approval_blobs_step;
+    } else if (txContext.txType == EIP7702) {
+        ux_approval_tx_flow[step++] = &ux_approval_authorizations_step;
+    }
+
     if (N_storage.displayNonce) {
         ux_approval_tx_flow[step++] = &ux_approval_nonce_step;
     }
@@ -0,0 +1,182 @@
+#ifdef HAVE_PROFILING
+
+#include <string.h>
+#include "shared_context.h"
+#include "apdu_constants.h"
+#include "profiling.h"
+#include "mem.h"
+#include "manage_asset_info.h"
+#include "sig_cache.h"
+
+#define P2_PROFILING_READ      0x00
+#define P2_PROFILING_RESET     0x01
+#define P2_PROFILING_MEM_READ  0x02
+#define P2_PROFILING_MEM_RESET 0x03
+
+// Room left for the status word
+#define MAX_RESPONSE_SIZE (sizeof(G_io_apdu_buffer) - 2)
+
+// Cache statistics, reported after the profiling counters
+#define CACHE_COUNTERS_COUNT 6
+
+/**
+ * Write a counter to the response
+ *
+ * name length (1) | name | id (2) | calls (4)
+ *
+ * @param[in] counter the counter
+ * @param[in] offset offset in the response
+ * @return the offset after the counter, 0 if it does not fit
+ */
+static uint16_t write_counter(const profiling_counter_t *counter, uint16_t offset) {
+    uint8_t name_length = strlen(counter->name);
+
+    if ((offset + 1 + name_length + 2 + 4) > MAX_RESPONSE_SIZE) {
+        return 0;
+    }
+    G_io_apdu_buffer[offset++] = name_length;
+    memcpy(G_io_apdu_buffer + offset, counter->name, name_length);
+    offset += name_length;
+    U2BE_ENCODE(G_io_apdu_buffer, offset, counter->id);
+    offset += 2;
+    U4BE_ENCODE(G_io_apdu_buffer, offset, counter->calls);
+    offset += 4;
+    return offset;
+}
+
+/**
+ * Get a cache statistic as a counter
+ *
+ * @param[in] index index among the cache statistics
+ * @param[out] counter the counter
+ * @return whether there is such a statistic
+ */
+static bool get_cache_counter(uint8_t index, profiling_counter_t *counter) {
+    const asset_cache_stats_t *assets = get_asset_cache_stats();
+    const sig_cache_stats_t *sigs = get_sig_cache_stats();
+    const char *name;
+    uint32_t value;
+
+    switch (index) {
+        case 0:
+            name = "asset_hits";
+            value = assets->hits;
+            break;
+        case 1:
+            name = "asset_misses";
+            value = assets->misses;
+            break;
+        case 2:
+            name = "asset_evictions";
+            value = assets->evictions;
+            break;
+        case 3:
+            name = "sig_hits";
+            value = sigs->hits;
+            break;
+        case 4:
+            name = "sig_misses";
+            value = sigs->misses;
+            break;
+        case 5:
+            name = "sig_evictions";
+            value = sigs->evictions;
+            break;
+        default:
+            return false;
+    }
+    strlcpy(counter->name, name, sizeof(counter->name));
+    counter->id = 0;
+    counter->calls = value;
+    return true;
+}
+
+#ifdef HAVE_DYN_MEM_ALLOC
+/**
+ * Write the usage of the dynamic memory to the response
+ *
+ * size (2) | used (2) | high water (2) | tags count (1) | high water of each tag (2)
+ *
+ * @return the response length
+ */
+static uint16_t write_mem_stats(void) {
+    const mem_stats_t *stats = mem_get_stats();
+    uint16_t offset = 0;
+
+    U2BE_ENCODE(G_io_apdu_buffer, offset, MEM_SIZE);
+    offset += 2;
+    U2BE_ENCODE(G_io_apdu_buffer, offset, stats->used);
+    offset += 2;
+    U2BE_ENCODE(G_io_apdu_buffer, offset, stats->high_water);
+    offset += 2;
+    G_io_apdu_buffer[offset++] = MEM_TAGS_COUNT;
+    for (uint8_t tag = 0; tag < MEM_TAGS_COUNT; tag++) {
+        U2BE_ENCODE(G_io_apdu_buffer, offset, stats->tags_high_water[tag]);
+        offset += 2;
+    }
+    return offset;
+}
+#endif  // HAVE_DYN_MEM_ALLOC
+
+/**
+ * Read the profiling counters, as many as fit in the response from the given one
+ *
+ * counters count (1) | counters from the index in P1
+ *
+ * the statistics of the asset & signature caches following the profiling counters
+ *
+ * or the usage of the dynamic memory
+ */
+void handleGetProfilingCounters(uint8_t p1,
+                                uint8_t p2,
+                                const uint8_t *workBuffer,
+                                uint8_t dataLength,
+                                unsigned int *flags,
+                                unsigned int *tx) {
+    const profiling_counter_t *counter;
+    profiling_counter_t cache_counter;
+    uint8_t count = profiling_counters_count();
+    uint16_t offset = 0;
+
+    UNUSED(workBuffer);
+    UNUSED(dataLength);
+    UNUSED(flags);
+#ifdef HAVE_DYN_MEM_ALLOC
+    if ((p2 == P2_PROFILING_MEM_READ) || (p2 == P2_PROFILING_MEM_RESET)) {
+        *tx = write_mem_stats();
+        if (p2 == P2_PROFILING_MEM_RESET) {
+            mem_reset_stats();
+        }
+        THROW(APDU_RESPONSE_OK);
+    }
+#endif  // HAVE_DYN_MEM_ALLOC
+    if ((p2 != P2_PROFILING_READ) && (p2 != P2_PROFILING_RESET)) {
+        THROW(APDU_RESPONSE_INVALID_P1_P2);
+    }
+    G_io_apdu_buffer[offset++] = count + CACHE_COUNTERS_COUNT;
+    for (uint8_t i = p1; i < (count + CACHE_COUNTERS_COUNT); i++) {
+        uint16_t next;
+
+        if (i < count) {
+            counter = profiling_get_counter(i);
+        } else if (get_cache_counter(i - count, &cache_counter)) {
+            counter = &cache_counter;
+        } else {
+            break;
+        }
+        next = write_counter(counter, offset);
+        if (next == 0) {
+            break;
+        }
+        offset = next;
+    }
+    if (p2 == P2_PROFILING_RESET) {
+        profiling_reset();
+        reset_asset_cache_stats();
+        reset_sig_cache_stats();
+    }
+    *tx = offset;
+    THROW(APDU_RESPONSE_OK);
+}
+
+#endif  // HAVE_PROFILING
@@ -0,0 +1,57 @@
+#ifdef HAVE_ABI_DESCRIPTOR
+
+#ifndef ABI_DESCRIPTOR_H_
+#define ABI_DESCRIPTOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "asset_info.h"
+#include "common_utils.h"
+#include "plugin_utils.h"
+
+#define ABI_MAX_PARAMS   8
+#define ABI_NAME_LENGTH  21
+#define ABI_LABEL_LENGTH 21
+
+// Types of the parameters of a contract method
+typedef enum {
+    ABI_TYPE_ADDRESS = 0x00,
+    ABI_TYPE_UINT,         // uint<M>, shown as an amount if it has decimals or a unit
+    ABI_TYPE_INT,          // int<M>
+    ABI_TYPE_BOOL,         // bool
+    ABI_TYPE_FIXED_BYTES,  // bytes<M>
+    ABI_TYPE_BYTES,        // bytes
+    ABI_TYPE_STRING,       // string
+    ABI_TYPES_COUNT
+} abi_type_e;
+
+// Set on the type of a parameter for a dynamic array (T[]) of it, only for the static types
+#define ABI_TYPE_ARRAY_FLAG 0x80
+
+typedef struct {
+    uint8_t type;  // abi_type_e, with ABI_TYPE_ARRAY_FLAG for an array
+    uint8_t size;   // decimals of the integers, length of the fixed-size byte arrays
+    uint8_t width;  // bytes of the integers (M / 8 of uint<M> / int<M>), 0 for the other types
+    char unit[MAX_TICKER_LEN];
+    char label[ABI_LABEL_LENGTH];
+} abi_param_t;
+
+typedef struct {
+    bool valid;
+    uint64_t chain_id;
+    uint8_t address[ADDRESS_LENGTH];
+    uint8_t selector[SELECTOR_SIZE];
+    char name[ABI_NAME_LENGTH];
+    char method[ABI_NAME_LENGTH];
+    uint8_t params_count;
+    abi_param_t params[ABI_MAX_PARAMS];
+} abi_descriptor_t;
+
+extern abi_descriptor_t g_abi_descriptor;
+
+bool abi_descriptor_matches(const uint8_t *address, const uint8_t *selector);
+bool abi_param_is_dynamic(const abi_param_t *param);
+
+#endif  // ABI_DESCRIPTOR_H_
+
+#endif  // HAVE_ABI_DESCRIPTOR
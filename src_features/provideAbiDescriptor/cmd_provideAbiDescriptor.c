@@ -0,0 +1,277 @@
+#ifdef HAVE_ABI_DESCRIPTOR
+
+#include <string.h>
+#include <ctype.h>
+#include "shared_context.h"
+#include "apdu_constants.h"
+#include "abi_descriptor.h"
+#include "mem.h"
+#include "network.h"
+#include "public_keys.h"
+#include "sig_cache.h"
+
+#define P1_FIRST_CHUNK     0x01
+#define P1_FOLLOWING_CHUNK 0x00
+
+#define ABI_DESCRIPTOR_VERSION 0x01
+
+#define CHAIN_ID_SIZE         8
+#define SIGNATURE_LENGTH_SIZE 1
+
+// r & s are stripped of their leading zero bytes, cx_ecdsa_verify checks the encoding itself
+#define MIN_DER_SIG_SIZE 8
+#define MAX_DER_SIG_SIZE 72
+
+// Prefix of the signed descriptors, so that no other signed payload can be mistaken for one
+static const char ABI_DESCRIPTOR_MAGIC[] = "ABI DESCRIPTOR";
+
+typedef struct {
+    uint8_t *buf;
+    uint16_t size;
+    uint16_t expected_size;
+} abi_payload_t;
+
+static abi_payload_t g_abi_payload;
+abi_descriptor_t g_abi_descriptor;
+
+bool abi_param_is_dynamic(const abi_param_t *param) {
+    return ((param->type & ABI_TYPE_ARRAY_FLAG) != 0) || (param->type == ABI_TYPE_BYTES) ||
+           (param->type == ABI_TYPE_STRING);
+}
+
+bool abi_descriptor_matches(const uint8_t *address, const uint8_t *selector) {
+    return g_abi_descriptor.valid &&
+           (memcmp(g_abi_descriptor.address, address, ADDRESS_LENGTH) == 0) &&
+           (memcmp(g_abi_descriptor.selector, selector, SELECTOR_SIZE) == 0);
+}
+
+static void free_payload(void) {
+    mem_dealloc(g_abi_payload.expected_size);
+    memset(&g_abi_payload, 0, sizeof(g_abi_payload));
+}
+
+/**
+ * Parse a length-prefixed string of the descriptor
+ *
+ * @param[in] buffer the descriptor
+ * @param[in] size the descriptor size
+ * @param[in,out] offset the offset of the string
+ * @param[out] out the null-terminated string
+ * @param[in] out_size the size of the output buffer
+ * @return whether it was successful
+ */
+static bool parse_string(const uint8_t *buffer,
+                         size_t size,
+                         size_t *offset,
+                         char *out,
+                         size_t out_size) {
+    uint8_t length;
+
+    if (*offset >= size) {
+        return false;
+    }
+    length = buffer[(*offset)++];
+    if ((length >= out_size) || ((*offset + length) > size)) {
+        PRINTF("Invalid string length %d\n", length);
+        return false;
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        if (!isprint(buffer[*offset + i])) {
+            return false;
+        }
+    }
+    memcpy(out, buffer + *offset, length);
+    out[length] = '\0';
+    *offset += length;
+    return true;
+}
+
+static bool parse_param(const uint8_t *buffer, size_t size, size_t *offset, abi_param_t *param) {
+    uint8_t type;
+
+    if ((*offset + 3) > size) {
+        return false;
+    }
+    param->type = buffer[(*offset)++];
+    param->size = buffer[(*offset)++];
+    param->width = buffer[(*offset)++];
+    type = param->type & ~ABI_TYPE_ARRAY_FLAG;
+    if (type >= ABI_TYPES_COUNT) {
+        PRINTF("Unknown parameter type 0x%02x\n", param->type);
+        return false;
+    }
+    // only the arrays of static types are supported
+    if ((param->type & ABI_TYPE_ARRAY_FLAG) &&
+        ((type == ABI_TYPE_BYTES) || (type == ABI_TYPE_STRING))) {
+        PRINTF("Unsupported array of dynamic type\n");
+        return false;
+    }
+    if ((type == ABI_TYPE_FIXED_BYTES) && ((param->size == 0) || (param->size > INT256_LENGTH))) {
+        PRINTF("Invalid fixed-size byte array length %d\n", param->size);
+        return false;
+    }
+    if ((type == ABI_TYPE_UINT) || (type == ABI_TYPE_INT)) {
+        if ((param->width == 0) || (param->width > INT256_LENGTH)) {
+            PRINTF("Invalid integer width %d\n", param->width);
+            return false;
+        }
+    } else if (param->width != 0) {
+        PRINTF("Unexpected width for parameter type 0x%02x\n", param->type);
+        return false;
+    }
+    return parse_string(buffer, size, offset, param->unit, sizeof(param->unit)) &&
+           parse_string(buffer, size, offset, param->label, sizeof(param->label));
+}
+
+/**
+ * Parse the received descriptor and verify its signature
+ *
+ * @param[in] buffer the descriptor
+ * @param[in] size the descriptor size
+ * @return whether it was successful
+ */
+static bool parse_descriptor(const uint8_t *buffer, size_t size) {
+    abi_descriptor_t *desc = &g_abi_descriptor;
+    size_t offset = 0;
+    size_t payload_size;
+    uint8_t sig_length;
+    uint8_t hash[INT256_LENGTH];
+    cx_sha256_t sha256;
+
+    if ((size < (1 + CHAIN_ID_SIZE + ADDRESS_LENGTH + SELECTOR_SIZE)) ||
+        (buffer[offset] != ABI_DESCRIPTOR_VERSION)) {
+        PRINTF("Unsupported descriptor\n");
+        return false;
+    }
+    offset += 1;
+    desc->chain_id = u64_from_BE(buffer + offset, CHAIN_ID_SIZE);
+    if (!app_compatible_with_chain_id(&desc->chain_id)) {
+        UNSUPPORTED_CHAIN_ID_MSG(desc->chain_id);
+        return false;
+    }
+    offset += CHAIN_ID_SIZE;
+    memcpy(desc->address, buffer + offset, ADDRESS_LENGTH);
+    offset += ADDRESS_LENGTH;
+    memcpy(desc->selector, buffer + offset, SELECTOR_SIZE);
+    offset += SELECTOR_SIZE;
+    if (!parse_string(buffer, size, &offset, desc->name, sizeof(desc->name)) ||
+        !parse_string(buffer, size, &offset, desc->method, sizeof(desc->method))) {
+        return false;
+    }
+    if (offset >= size) {
+        return false;
+    }
+    desc->params_count = buffer[offset++];
+    if (desc->params_count > ABI_MAX_PARAMS) {
+        PRINTF("Too many parameters: %d\n", desc->params_count);
+        return false;
+    }
+    for (uint8_t i = 0; i < desc->params_count; i++) {
+        if (!parse_param(buffer, size, &offset, &desc->params[i])) {
+            return false;
+        }
+    }
+
+    payload_size = offset;
+    if ((offset + SIGNATURE_LENGTH_SIZE) > size) {
+        return false;
+    }
+    sig_length = buffer[offset++];
+    if ((sig_length < MIN_DER_SIG_SIZE) || (sig_length > MAX_DER_SIG_SIZE) ||
+        ((offset + sig_length) != size)) {
+        PRINTF("Invalid signature length %d\n", sig_length);
+        return false;
+    }
+    cx_sha256_init(&sha256);
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &sha256,
+                               0,
+                               (const uint8_t *) ABI_DESCRIPTOR_MAGIC,
+                               sizeof(ABI_DESCRIPTOR_MAGIC) - 1,
+                               NULL,
+                               0));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &sha256,
+                               CX_LAST,
+                               buffer,
+                               payload_size,
+                               hash,
+                               sizeof(hash)));
+    if (!sig_cache_verify(LEDGER_SIGNATURE_PUBLIC_KEY,
+                          sizeof(LEDGER_SIGNATURE_PUBLIC_KEY),
+                          hash,
+                          sizeof(hash),
+                          (unsigned char *) (buffer + offset),
+                          sig_length)) {
+#ifndef HAVE_BYPASS_SIGNATURES
+        PRINTF("Invalid ABI descriptor signature\n");
+        return false;
+#endif
+    }
+    return true;
+}
+
+void handleProvideAbiDescriptor(uint8_t p1,
+                                uint8_t p2,
+                                const uint8_t *workBuffer,
+                                uint8_t dataLength,
+                                unsigned int *flags,
+                                unsigned int *tx) {
+    UNUSED(p2);
+    UNUSED(flags);
+    UNUSED(tx);
+
+    switch (p1) {
+        case P1_FIRST_CHUNK:
+            // a new descriptor replaces the previous one, even if it gets rejected
+            g_abi_descriptor.valid = false;
+            if (g_abi_payload.buf != NULL) {
+                free_payload();
+            }
+            if (dataLength < sizeof(g_abi_payload.expected_size)) {
+                THROW(0x6A80);
+            }
+            g_abi_payload.expected_size = U2BE(workBuffer, 0);
+            MEM_SET_TAG(MEM_TAG_ABI_DESCRIPTOR);
+            if ((g_abi_payload.buf = mem_alloc(g_abi_payload.expected_size)) == NULL) {
+                g_abi_payload.expected_size = 0;
+                THROW(APDU_RESPONSE_INSUFFICIENT_MEMORY);
+            }
+            workBuffer += sizeof(g_abi_payload.expected_size);
+            dataLength -= sizeof(g_abi_payload.expected_size);
+            break;
+        case P1_FOLLOWING_CHUNK:
+            if (g_abi_payload.buf == NULL) {
+                THROW(APDU_RESPONSE_INVALID_P1_P2);
+            }
+            break;
+        default:
+            THROW(APDU_RESPONSE_INVALID_P1_P2);
+    }
+
+    if ((g_abi_payload.size + dataLength) > g_abi_payload.expected_size) {
+        PRINTF("ABI descriptor size mismatch\n");
+        free_payload();
+        THROW(0x6A80);
+    }
+    memcpy(g_abi_payload.buf + g_abi_payload.size, workBuffer, dataLength);
+    g_abi_payload.size += dataLength;
+
+    if (g_abi_payload.size == g_abi_payload.expected_size) {
+        bool valid = parse_descriptor(g_abi_payload.buf, g_abi_payload.size);
+
+        free_payload();
+        if (!valid) {
+            memset(&g_abi_descriptor, 0, sizeof(g_abi_descriptor));
+            THROW(0x6A80);
+        }
+        PRINTF("ABI descriptor: %s %s, %d parameters\n",
+               g_abi_descriptor.name,
+               g_abi_descriptor.method,
+               g_abi_descriptor.params_count);
+        g_abi_descriptor.valid = true;
+        pluginType = ABI_DECODER;
+        strlcpy(dataContext.tokenContext.pluginName, "ABI", PLUGIN_ID_LENGTH);
+    }
+    THROW(0x9000);
+}
+
+#endif  // HAVE_ABI_DESCRIPTOR
@@ -12,6 +12,7 @@
 #include "hash_bytes.h"
 #include "network.h"
 #include "public_keys.h"
+#include "sig_cache.h"
 
 #define P1_FIRST_CHUNK     0x01
 #define P1_FOLLOWING_CHUNK 0x00
@@ -364,7 +365,8 @@ static bool handle_address(const s_tlv_data *data,
  */
 static bool verify_signature(const s_sig_ctx *sig_ctx) {
     uint8_t hash[INT256_LENGTH];
-    cx_ecfp_public_key_t verif_key;
+    const uint8_t *key;
+    size_t key_size;
     cx_err_t error = CX_INTERNAL_ERROR;
 
     CX_CHECK(
@@ -375,20 +377,19 @@ static bool verify_signature(const s_sig_ctx *sig_ctx) {
 #else
         case KEY_ID_PROD:
 #endif
-            CX_CHECK(cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1,
-                                                      DOMAIN_NAME_PUB_KEY,
-                                                      sizeof(DOMAIN_NAME_PUB_KEY),
-                                                      &verif_key));
+            key = DOMAIN_NAME_PUB_KEY;
+            key_size = sizeof(DOMAIN_NAME_PUB_KEY);
             break;
         default:
             PRINTF("Error: Unknown metadata key ID %u\n", sig_ctx->key_id);
             return false;
     }
-    if (!cx_ecdsa_verify_no_throw(&verif_key,
-                                  hash,
-                                  sizeof(hash),
-                                  sig_ctx->input_sig,
-                                  sig_ctx->input_sig_size)) {
+    if (!sig_cache_verify(key,
+                          key_size,
+                          hash,
+                          sizeof(hash),
+                          sig_ctx->input_sig,
+                          sig_ctx->input_sig_size)) {
         PRINTF("Domain name signature verification failed!\n");
 #ifndef HAVE_BYPASS_SIGNATURES
         return false;
@@ -607,6 +608,7 @@ static bool parse_tlv(const s_tlv_payload *payload,
  * @return whether it was successful
  */
 static bool alloc_payload(s_tlv_payload *payload, uint16_t size) {
+    MEM_SET_TAG(MEM_TAG_DOMAIN_NAME);
     if ((payload->buf = mem_alloc(size)) == NULL) {
         apdu_response_code = APDU_RESPONSE_INSUFFICIENT_MEMORY;
         return false;
@@ -6,6 +6,8 @@
 #include "extra_tokens.h"
 #include "network.h"
 #include "manage_asset_info.h"
+#include "sig_cache.h"
+#include "token_store.h"
 
 #ifdef HAVE_CONTRACT_NAME_IN_DESCRIPTOR
 
@@ -23,7 +25,6 @@ void handleProvideErc20TokenInformation(uint8_t p1,
     uint32_t chainId;
     uint8_t hash[INT256_LENGTH];
     cx_sha256_t sha256;
-    cx_ecfp_public_key_t tokenKey;
 
     cx_sha256_init(&sha256);
 
@@ -77,112 +78,335 @@ void handleProvideErc20TokenInformation(uint8_t p1,
     }
     offset += 4;
     dataLength -= 4;
-    cx_ecfp_init_public_key(CX_CURVE_256K1,
-                            LEDGER_SIGNATURE_PUBLIC_KEY,
-                            sizeof(LEDGER_SIGNATURE_PUBLIC_KEY),
-                            &tokenKey);
-    if (!cx_ecdsa_verify(&tokenKey,
-                         CX_LAST,
-                         CX_SHA256,
-                         hash,
-                         32,
-                         workBuffer + offset,
-                         dataLength)) {
+    if (!sig_cache_verify(LEDGER_SIGNATURE_PUBLIC_KEY,
+                          sizeof(LEDGER_SIGNATURE_PUBLIC_KEY),
+                          hash,
+                          32,
+                          workBuffer + offset,
+                          dataLength)) {
 #ifndef HAVE_BYPASS_SIGNATURES
         PRINTF("Invalid token signature\n");
         THROW(0x6A80);
 #endif
     }
+#ifdef HAVE_TOKEN_STORE
+    token_store_add(chainId, token);
+#endif
     validate_current_asset_info();
     THROW(0x9000);
 }
 
 #else
 
-void handleProvideErc20TokenInformation(uint8_t p1,
-                                        uint8_t p2,
-                                        const uint8_t *workBuffer,
-                                        uint8_t dataLength,
-                                        unsigned int *flags,
-                                        unsigned int *tx) {
-    UNUSED(p1);
-    UNUSED(p2);
-    UNUSED(flags);
-    UNUSED(tx);
-    uint32_t offset = 0;
-    uint8_t tickerLength;
-    uint64_t chain_id;
-    uint8_t hash[INT256_LENGTH];
-    cx_ecfp_public_key_t tokenKey;
+// Fixed part of a token descriptor: address, decimals and chain ID
+#define TOKEN_DESCRIPTOR_FIXED_LENGTH (ADDRESS_LENGTH + sizeof(uint32_t) + sizeof(uint32_t))
+// Shortest token list entry: empty ticker and proof
+#define MAX_TOKEN_LIST_ENTRIES (255 / (1 + TOKEN_DESCRIPTOR_FIXED_LENGTH + 1))
 
-    tokenDefinition_t *token = &get_current_asset_info()->token;
+#define TOKEN_LIST_LEAF_TAG 0x00
+#define TOKEN_LIST_NODE_TAG 0x01
 
-    PRINTF("Provisioning currentAssetIndex %d\n", tmpCtx.transactionContext.currentAssetIndex);
+// Prefix of the signed token list roots, long enough for them not to be mistaken for a token
+// descriptor (at most 11 + 28 bytes)
+static const char TOKEN_LIST_MAGIC[] = "ERC20 LIST";
 
-    if (dataLength < 1) {
+#ifdef HAVE_TOKENS_EXTRA_LIST
+/**
+ * Override a token with its entry of the built-in extra list, if it has one
+ *
+ * @param[in,out] token the token
+ * @return whether it is in the extra list
+ */
+static bool apply_tokens_extra_list(tokenDefinition_t *token) {
+    tokenDefinition_t *currentToken;
+
+    for (uint32_t index = 0; index < NUM_TOKENS_EXTRA; index++) {
+        currentToken = (tokenDefinition_t *) PIC(&TOKENS_EXTRA[index]);
+        if (memcmp(currentToken->address, token->address, 20) == 0) {
+            strcpy((char *) token->ticker, (char *) currentToken->ticker);
+            token->decimals = currentToken->decimals;
+            PRINTF("Descriptor whitelisted\n");
+            return true;
+        }
+    }
+    return false;
+}
+#endif  // HAVE_TOKENS_EXTRA_LIST
+
+/**
+ * Parse a token descriptor: ticker length, ticker, address, decimals and chain ID
+ *
+ * @param[in] buffer the descriptor
+ * @param[in] length the length of the buffer
+ * @param[out] token the parsed token
+ * @param[out] chain_id the chain ID of the token
+ * @return the length of the descriptor
+ */
+static uint8_t parse_token_descriptor(const uint8_t *buffer,
+                                      uint8_t length,
+                                      tokenDefinition_t *token,
+                                      uint64_t *chain_id) {
+    uint8_t offset = 0;
+    uint8_t tickerLength;
+    uint32_t decimals;
+
+    if (length < 1) {
         THROW(0x6A80);
     }
-    tickerLength = workBuffer[offset++];
-    dataLength--;
+    tickerLength = buffer[offset++];
     if ((tickerLength + 1) > sizeof(token->ticker)) {
         THROW(0x6A80);
     }
-    if (dataLength < tickerLength + 20 + 4 + 4) {
+    if ((length - offset) < (tickerLength + TOKEN_DESCRIPTOR_FIXED_LENGTH)) {
         THROW(0x6A80);
     }
-    cx_hash_sha256(workBuffer + offset, tickerLength + 20 + 4 + 4, hash, 32);
-    memmove(token->ticker, workBuffer + offset, tickerLength);
+    memmove(token->ticker, buffer + offset, tickerLength);
     token->ticker[tickerLength] = '\0';
     offset += tickerLength;
-    dataLength -= tickerLength;
-    memmove(token->address, workBuffer + offset, 20);
-    offset += 20;
-    dataLength -= 20;
-    // TODO: 4 bytes for this is overkill
-    token->decimals = U4BE(workBuffer, offset);
+    memmove(token->address, buffer + offset, ADDRESS_LENGTH);
+    offset += ADDRESS_LENGTH;
+    // 4 bytes in the signed descriptor, more than the token can hold
+    decimals = U4BE(buffer, offset);
+    if (decimals > UINT8_MAX) {
+        PRINTF("Invalid token decimals %u\n", decimals);
+        THROW(0x6A80);
+    }
+    token->decimals = decimals;
     offset += 4;
-    dataLength -= 4;
-    // TODO: Handle 64-bit long chain IDs
-    chain_id = U4BE(workBuffer, offset);
-    if (!app_compatible_with_chain_id(&chain_id)) {
-        UNSUPPORTED_CHAIN_ID_MSG(chain_id);
+    // also 4 bytes in the signed descriptor, no token of a chain with a longer ID can be provided
+    *chain_id = U4BE(buffer, offset);
+    if (!app_compatible_with_chain_id(chain_id)) {
+        UNSUPPORTED_CHAIN_ID_MSG(*chain_id);
         THROW(0x6A80);
     }
     offset += 4;
-    dataLength -= 4;
+    return offset;
+}
 
-#ifdef HAVE_TOKENS_EXTRA_LIST
-    tokenDefinition_t *currentToken = NULL;
-    uint32_t index;
-    for (index = 0; index < NUM_TOKENS_EXTRA; index++) {
-        currentToken = (tokenDefinition_t *) PIC(&TOKENS_EXTRA[index]);
-        if (memcmp(currentToken->address, token->address, 20) == 0) {
-            strcpy((char *) token->ticker, (char *) currentToken->ticker);
-            token->decimals = currentToken->decimals;
-            break;
-        }
+static void verify_cal_signature(const uint8_t *hash,
+                                 const uint8_t *signature,
+                                 uint8_t signatureLength) {
+    if (!sig_cache_verify(LEDGER_SIGNATURE_PUBLIC_KEY,
+                          sizeof(LEDGER_SIGNATURE_PUBLIC_KEY),
+                          hash,
+                          INT256_LENGTH,
+                          signature,
+                          signatureLength)) {
+#ifndef HAVE_BYPASS_SIGNATURES
+        PRINTF("Invalid token signature\n");
+        THROW(0x6A80);
+#endif
     }
-    if (index < NUM_TOKENS_EXTRA) {
-        PRINTF("Descriptor whitelisted\n");
-    } else
+}
+
+static void provide_token(const uint8_t *workBuffer, uint8_t dataLength) {
+    uint8_t offset;
+    uint8_t hash[INT256_LENGTH];
+    uint64_t chain_id;
+
+    tokenDefinition_t *token = &get_current_asset_info()->token;
+
+    offset = parse_token_descriptor(workBuffer, dataLength, token, &chain_id);
+    // the ticker length is not signed
+    cx_hash_sha256(workBuffer + 1, offset - 1, hash, sizeof(hash));
+
+#ifdef HAVE_TOKENS_EXTRA_LIST
+    if (!apply_tokens_extra_list(token))
 #endif
     {
-        CX_ASSERT(cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1,
-                                                   LEDGER_SIGNATURE_PUBLIC_KEY,
-                                                   sizeof(LEDGER_SIGNATURE_PUBLIC_KEY),
-                                                   &tokenKey));
-        if (!cx_ecdsa_verify_no_throw(&tokenKey, hash, 32, workBuffer + offset, dataLength)) {
-#ifndef HAVE_BYPASS_SIGNATURES
-            PRINTF("Invalid token signature\n");
-            THROW(0x6A80);
+        verify_cal_signature(hash, workBuffer + offset, dataLength - offset);
+#ifdef HAVE_TOKEN_STORE
+        token_store_add(chain_id, token);
 #endif
-        }
     }
 
-    G_io_apdu_buffer[0] = tmpCtx.transactionContext.currentAssetIndex;
     validate_current_asset_info();
+    G_io_apdu_buffer[0] = tmpCtx.transactionContext.currentAssetIndex;
     U2BE_ENCODE(G_io_apdu_buffer, 1, APDU_RESPONSE_OK);
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 3);
 }
 
+/**
+ * Hash a node of a token list Merkle tree
+ *
+ * @param[in] tag \ref TOKEN_LIST_LEAF_TAG or \ref TOKEN_LIST_NODE_TAG
+ * @param[in] data1 first part of the node
+ * @param[in] length1 length of the first part
+ * @param[in] data2 second part of the node
+ * @param[in] length2 length of the second part
+ * @param[out] hash the node hash
+ */
+static void token_list_hash(uint8_t tag,
+                            const uint8_t *data1,
+                            size_t length1,
+                            const uint8_t *data2,
+                            size_t length2,
+                            uint8_t *hash) {
+    cx_sha256_t sha256;
+
+    cx_sha256_init(&sha256);
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &sha256, 0, &tag, sizeof(tag), NULL, 0));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &sha256, 0, data1, length1, NULL, 0));
+    CX_ASSERT(
+        cx_hash_no_throw((cx_hash_t *) &sha256, CX_LAST, data2, length2, hash, INT256_LENGTH));
+}
+
+static void provide_token_list_root(const uint8_t *workBuffer, uint8_t dataLength) {
+    uint8_t hash[INT256_LENGTH];
+    cx_sha256_t sha256;
+
+    tmpCtx.transactionContext.tokenListRootSet = false;
+    if (dataLength <= INT256_LENGTH) {
+        THROW(0x6A80);
+    }
+    cx_sha256_init(&sha256);
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &sha256,
+                               0,
+                               (const uint8_t *) TOKEN_LIST_MAGIC,
+                               sizeof(TOKEN_LIST_MAGIC) - 1,
+                               NULL,
+                               0));
+    CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &sha256,
+                               CX_LAST,
+                               workBuffer,
+                               INT256_LENGTH,
+                               hash,
+                               sizeof(hash)));
+    verify_cal_signature(hash, workBuffer + INT256_LENGTH, dataLength - INT256_LENGTH);
+    memmove(tmpCtx.transactionContext.tokenListRoot, workBuffer, INT256_LENGTH);
+    tmpCtx.transactionContext.tokenListRootSet = true;
+    U2BE_ENCODE(G_io_apdu_buffer, 0, APDU_RESPONSE_OK);
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
+}
+
+/**
+ * Check the inclusion proof of a token list entry
+ *
+ * Each proof element is the sibling of the current node, the two being hashed in ascending order.
+ *
+ * @param[in] leaf the leaf hash
+ * @param[in] buffer the proof, prefixed by its number of elements
+ * @param[in] length the length of the buffer
+ * @return the length of the proof
+ */
+static uint8_t verify_token_list_proof(const uint8_t *leaf, const uint8_t *buffer, uint8_t length) {
+    uint8_t hash[INT256_LENGTH];
+    uint8_t offset = 0;
+    uint8_t proofLength;
+
+    if (length < 1) {
+        THROW(0x6A80);
+    }
+    proofLength = buffer[offset++];
+    if ((length - offset) < (proofLength * INT256_LENGTH)) {
+        THROW(0x6A80);
+    }
+    memmove(hash, leaf, sizeof(hash));
+    for (uint8_t i = 0; i < proofLength; i++) {
+        const uint8_t *sibling = buffer + offset;
+        uint8_t parent[INT256_LENGTH];
+
+        if (memcmp(hash, sibling, INT256_LENGTH) <= 0) {
+            token_list_hash(TOKEN_LIST_NODE_TAG,
+                            hash,
+                            INT256_LENGTH,
+                            sibling,
+                            INT256_LENGTH,
+                            parent);
+        } else {
+            token_list_hash(TOKEN_LIST_NODE_TAG,
+                            sibling,
+                            INT256_LENGTH,
+                            hash,
+                            INT256_LENGTH,
+                            parent);
+        }
+        memmove(hash, parent, sizeof(hash));
+        offset += INT256_LENGTH;
+    }
+    if (memcmp(hash, tmpCtx.transactionContext.tokenListRoot, INT256_LENGTH) != 0) {
+        PRINTF("Token not in the signed list\n");
+        THROW(0x6A80);
+    }
+    return offset;
+}
+
+static void provide_token_list_entries(const uint8_t *workBuffer, uint8_t dataLength) {
+    tokenDefinition_t tokens[MIN(MAX_TOKEN_LIST_ENTRIES, MAX_ASSETS)];
+    uint64_t chain_ids[ARRAYLEN(tokens)];
+    uint8_t count = 0;
+    uint8_t offset = 0;
+
+    if (!tmpCtx.transactionContext.tokenListRootSet) {
+        PRINTF("No token list root provided\n");
+        THROW(APDU_RESPONSE_CONDITION_NOT_SATISFIED);
+    }
+    // every entry is checked before any of them is stored
+    while (offset < dataLength) {
+        uint8_t leaf[INT256_LENGTH];
+        uint8_t descriptorLength;
+
+        if (count == ARRAYLEN(tokens)) {
+            THROW(0x6A80);
+        }
+        descriptorLength = parse_token_descriptor(workBuffer + offset,
+                                                  dataLength - offset,
+                                                  &tokens[count],
+                                                  &chain_ids[count]);
+        token_list_hash(TOKEN_LIST_LEAF_TAG,
+                        workBuffer + offset + 1,
+                        descriptorLength - 1,
+                        NULL,
+                        0,
+                        leaf);
+        offset += descriptorLength;
+        offset += verify_token_list_proof(leaf, workBuffer + offset, dataLength - offset);
+        count += 1;
+    }
+    if (count == 0) {
+        THROW(0x6A80);
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+#ifdef HAVE_TOKENS_EXTRA_LIST
+        if (!apply_tokens_extra_list(&tokens[i]))
+#endif
+        {
+#ifdef HAVE_TOKEN_STORE
+            token_store_add(chain_ids[i], &tokens[i]);
+#endif
+        }
+        memmove(&get_current_asset_info()->token, &tokens[i], sizeof(tokens[i]));
+        validate_current_asset_info();
+        G_io_apdu_buffer[i] = tmpCtx.transactionContext.currentAssetIndex;
+    }
+    U2BE_ENCODE(G_io_apdu_buffer, count, APDU_RESPONSE_OK);
+    io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, count + 2);
+}
+
+void handleProvideErc20TokenInformation(uint8_t p1,
+                                        uint8_t p2,
+                                        const uint8_t *workBuffer,
+                                        uint8_t dataLength,
+                                        unsigned int *flags,
+                                        unsigned int *tx) {
+    UNUSED(p2);
+    UNUSED(flags);
+    UNUSED(tx);
+
+    switch (p1) {
+        case P1_ERC20_TOKEN:
+            provide_token(workBuffer, dataLength);
+            break;
+        case P1_ERC20_TOKEN_LIST_ROOT:
+            provide_token_list_root(workBuffer, dataLength);
+            break;
+        case P1_ERC20_TOKEN_LIST_ENTRIES:
+            provide_token_list_entries(workBuffer, dataLength);
+            break;
+        default:
+            THROW(APDU_RESPONSE_INVALID_P1_P2);
+    }
+}
+
 #endif
@@ -9,6 +9,7 @@
 #include "network.h"
 #include "public_keys.h"
 #include "manage_asset_info.h"
+#include "sig_cache.h"
 
 #define TYPE_SIZE        1
 #define VERSION_SIZE     1
@@ -50,7 +51,6 @@ void handleProvideNFTInformation(uint8_t p1,
     UNUSED(tx);
     UNUSED(flags);
     uint8_t hash[INT256_LENGTH];
-    cx_ecfp_public_key_t nftKey;
     PRINTF("In handle provide NFTInformation\n");
 
     if ((pluginType != ERC721) && (pluginType != ERC1155)) {
@@ -59,8 +59,6 @@ void handleProvideNFTInformation(uint8_t p1,
     }
     nftInfo_t *nft = &get_current_asset_info()->nft;
 
-    PRINTF("Provisioning currentAssetIndex %d\n", tmpCtx.transactionContext.currentAssetIndex);
-
     size_t offset = 0;
 
     if (dataLength <= HEADER_SIZE) {
@@ -187,20 +185,20 @@ void handleProvideNFTInformation(uint8_t p1,
         THROW(APDU_RESPONSE_INVALID_DATA);
     }
 
-    CX_ASSERT(cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1, rawKey, rawKeyLen, &nftKey));
-    if (!cx_ecdsa_verify_no_throw(&nftKey,
-                                  hash,
-                                  sizeof(hash),
-                                  (uint8_t *) workBuffer + offset,
-                                  signatureLen)) {
+    if (!sig_cache_verify(rawKey,
+                          rawKeyLen,
+                          hash,
+                          sizeof(hash),
+                          (uint8_t *) workBuffer + offset,
+                          signatureLen)) {
 #ifndef HAVE_BYPASS_SIGNATURES
         PRINTF("Invalid NFT signature\n");
         THROW(APDU_RESPONSE_INVALID_DATA);
 #endif
     }
 
-    G_io_apdu_buffer[0] = tmpCtx.transactionContext.currentAssetIndex;
     validate_current_asset_info();
+    G_io_apdu_buffer[0] = tmpCtx.transactionContext.currentAssetIndex;
     U2BE_ENCODE(G_io_apdu_buffer, 1, APDU_RESPONSE_OK);
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 3);
 }
@@ -9,6 +9,7 @@
 #include "os_io_seproxyhal.h"
 #include "network.h"
 #include "public_keys.h"
+#include "sig_cache.h"
 
 // Supported internal plugins
 #define ERC721_STR  "ERC721"
@@ -82,7 +83,6 @@ void handleSetPlugin(uint8_t p1,
     UNUSED(flags);
     PRINTF("Handling set Plugin\n");
     uint8_t hash[INT256_LENGTH] = {0};
-    cx_ecfp_public_key_t pluginKey = {0};
     tokenContext_t *tokenContext = &dataContext.tokenContext;
 
     size_t offset = 0;
@@ -219,12 +219,12 @@ void handleSetPlugin(uint8_t p1,
         THROW(0x6a80);
     }
 
-    CX_ASSERT(cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1, rawKey, rawKeyLen, &pluginKey));
-    if (!cx_ecdsa_verify_no_throw(&pluginKey,
-                                  hash,
-                                  sizeof(hash),
-                                  (unsigned char *) (workBuffer + offset),
-                                  signatureLen)) {
+    if (!sig_cache_verify(rawKey,
+                          rawKeyLen,
+                          hash,
+                          sizeof(hash),
+                          (unsigned char *) (workBuffer + offset),
+                          signatureLen)) {
 #ifndef HAVE_BYPASS_SIGNATURES
         PRINTF("Invalid NFT signature\n");
         THROW(0x6A80);
@@ -11,10 +11,13 @@
 #include "ui_logic.h"
 #include "typed_data.h"
 #include "schema_hash.h"
+#include "schema_cache.h"
 #include "filtering.h"
 #include "common_712.h"
 #include "common_ui.h"  // ui_idle
+#include "ui_callbacks.h"  // io_seproxyhal_send_status
 #include "manage_asset_info.h"
+#include "mem.h"
 
 // APDUs P1
 #define P1_COMPLETE 0x00
@@ -22,9 +25,12 @@
 
 // APDUs P2
 #define P2_DEF_NAME               0x00
+#define P2_DEF_SCHEMA_HASH        0x01
+#define P2_DEF_PACKED             0x0F
 #define P2_DEF_FIELD              0xFF
 #define P2_IMPL_NAME              P2_DEF_NAME
 #define P2_IMPL_ARRAY             0x0F
+#define P2_IMPL_PACKED_FIELDS     0xFE
 #define P2_IMPL_FIELD             P2_DEF_FIELD
 #define P2_FILT_ACTIVATE          0x00
 #define P2_FILT_MESSAGE_INFO      0x0F
@@ -60,6 +66,59 @@ void handle_eip712_return_code(bool success) {
     }
 }
 
+/**
+ * Set packed struct definitions
+ *
+ * They are the concatenation of the P2, LC & data of the struct definition APDUs they replace,
+ * none of them being split across APDUs.
+ *
+ * @param[in] length data length
+ * @param[in] data the packed definitions
+ * @return whether it was successful
+ */
+static bool set_packed_struct_defs(uint8_t length, const uint8_t *const data) {
+    uint8_t data_idx = 0;
+    uint8_t def_type;
+    uint8_t def_length;
+    bool ret;
+
+    if (length == 0) {
+        apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+        return false;
+    }
+    while (data_idx < length) {
+        if ((data_idx + 2) > length)  // check buffer bound
+        {
+            apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+            return false;
+        }
+        def_type = data[data_idx++];
+        def_length = data[data_idx++];
+        if ((data_idx + def_length) > length)  // check buffer bound
+        {
+            apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+            return false;
+        }
+        switch (def_type) {
+            case P2_DEF_NAME:
+                ret = set_struct_name(def_length, &data[data_idx]);
+                break;
+            case P2_DEF_FIELD:
+                ret = set_struct_field(def_length, &data[data_idx]);
+                break;
+            default:
+                PRINTF("Unknown packed struct definition type 0x%x\n", def_type);
+                apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+                ret = false;
+        }
+        if (!ret) {
+            return false;
+        }
+        data_idx += def_length;
+    }
+    return true;
+}
+
 /**
  * Process the EIP712 struct definition command
  *
@@ -76,6 +135,7 @@ bool handle_eip712_struct_def(const uint8_t *const apdu_buf) {
     if (struct_state == DEFINED) {
         ret = false;
     }
+    MEM_SET_TAG(MEM_TAG_EIP712_TYPES);
 
     if (ret) {
         switch (apdu_buf[OFFSET_P2]) {
@@ -85,6 +145,18 @@ bool handle_eip712_struct_def(const uint8_t *const apdu_buf) {
             case P2_DEF_FIELD:
                 ret = set_struct_field(apdu_buf[OFFSET_LC], &apdu_buf[OFFSET_CDATA]);
                 break;
+            case P2_DEF_PACKED:
+                ret = set_packed_struct_defs(apdu_buf[OFFSET_LC], &apdu_buf[OFFSET_CDATA]);
+                break;
+            case P2_DEF_SCHEMA_HASH:
+#ifdef HAVE_EIP712_SCHEMA_CACHE
+                ret = schema_cache_load(&apdu_buf[OFFSET_CDATA], apdu_buf[OFFSET_LC]);
+#else
+                // never cached, the struct definitions have to be sent
+                apdu_response_code = APDU_RESPONSE_REF_DATA_NOT_FOUND;
+                ret = false;
+#endif
+                break;
             default:
                 PRINTF("Unknown P2 0x%x for APDU 0x%x\n",
                        apdu_buf[OFFSET_P2],
@@ -106,15 +178,25 @@ bool handle_eip712_struct_def(const uint8_t *const apdu_buf) {
 bool handle_eip712_struct_impl(const uint8_t *const apdu_buf) {
     bool ret = false;
     bool reply_apdu = true;
+#ifdef HAVE_EIP712_SCHEMA_CACHE
+    bool defined = (struct_state == DEFINED);
+#endif
 
     if (eip712_context == NULL) {
         apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
     } else {
+        MEM_SET_TAG(MEM_TAG_EIP712_MESSAGE);
         switch (apdu_buf[OFFSET_P2]) {
             case P2_IMPL_NAME:
                 // set root type
                 ret = path_set_root((char *) &apdu_buf[OFFSET_CDATA], apdu_buf[OFFSET_LC]);
                 if (ret) {
+#ifdef HAVE_EIP712_SCHEMA_CACHE
+                    if (!defined) {
+                        // the struct definitions are now complete
+                        schema_cache_add();
+                    }
+#endif
                     if (N_storage.verbose_eip712) {
                         ui_712_review_struct(path_get_root());
                         reply_apdu = false;
@@ -129,6 +211,15 @@ bool handle_eip712_struct_impl(const uint8_t *const apdu_buf) {
                     reply_apdu = false;
                 }
                 break;
+            case P2_IMPL_PACKED_FIELDS:
+                if ((ret = field_hash_packed(&apdu_buf[OFFSET_CDATA], apdu_buf[OFFSET_LC]))) {
+                    reply_apdu = false;
+                } else if (apdu_response_code == APDU_RESPONSE_COMMAND_NOT_ALLOWED) {
+                    // refused before hashing anything, the message can still be sent unpacked
+                    io_seproxyhal_send_status(apdu_response_code);
+                    reply_apdu = false;
+                }
+                break;
             case P2_IMPL_ARRAY:
                 ret = path_new_array_depth(&apdu_buf[OFFSET_CDATA], apdu_buf[OFFSET_LC]);
                 break;
@@ -164,6 +255,7 @@ bool handle_eip712_filtering(const uint8_t *const apdu_buf) {
         handle_eip712_return_code(true);
         return true;
     }
+    MEM_SET_TAG(MEM_TAG_EIP712_MESSAGE);
     switch (apdu_buf[OFFSET_P2]) {
         case P2_FILT_ACTIVATE:
             if (!N_storage.verbose_eip712) {
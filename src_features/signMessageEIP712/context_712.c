@@ -25,6 +25,7 @@ s_eip712_context *eip712_context = NULL;
 bool eip712_context_init(void) {
     // init global variables
     mem_init();
+    MEM_SET_TAG(MEM_TAG_EIP712_CONTEXT);
 
     if ((eip712_context = MEM_ALLOC_AND_ALIGN_TYPE(*eip712_context)) == NULL) {
         apdu_response_code = APDU_RESPONSE_INSUFFICIENT_MEMORY;
@@ -55,6 +56,9 @@ bool eip712_context_init(void) {
     // Since they are optional, they might not be provided by the JSON data
     explicit_bzero(eip712_context->contract_addr, sizeof(eip712_context->contract_addr));
     eip712_context->chain_id = 0;
+#ifdef HAVE_EIP712_SCHEMA_CACHE
+    eip712_context->schema_cached = false;
+#endif
 
     struct_state = NOT_INITIALIZED;
 
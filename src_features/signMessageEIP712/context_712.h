@@ -10,6 +10,9 @@ typedef struct {
     uint8_t contract_addr[ADDRESS_LENGTH];
     uint64_t chain_id;
     uint8_t schema_hash[224 / 8];
+#ifdef HAVE_EIP712_SCHEMA_CACHE
+    bool schema_cached;  // struct definitions loaded from the schema cache
+#endif
 } s_eip712_context;
 
 extern s_eip712_context *eip712_context;
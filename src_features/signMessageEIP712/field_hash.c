@@ -107,10 +107,6 @@ static const uint8_t *field_hash_finalize_static(const void *const field_ptr,
             PRINTF("Unknown solidity type!\n");
     }
 
-    if (value == NULL) {
-        return NULL;
-    }
-    ui_712_new_field(field_ptr, data, data_length);
     return value;
 }
 
@@ -215,6 +211,7 @@ static bool field_hash_finalize(const void *const field_ptr,
         if ((value = field_hash_finalize_static(field_ptr, data, data_length)) == NULL) {
             return false;
         }
+        ui_712_new_field(field_ptr, data, data_length);
     } else {
         if ((value = field_hash_finalize_dynamic()) == NULL) {
             return false;
@@ -291,4 +288,99 @@ bool field_hash(const uint8_t *data, uint8_t data_length, bool partial) {
     return true;
 }
 
+/**
+ * Hash a complete field value without involving the UI
+ *
+ * @param[in] field_ptr pointer to the struct field definition
+ * @param[in] data the field value
+ * @param[in] data_length the value length
+ * @return whether the data hashing was successful or not
+ */
+static bool field_hash_unformatted(const void *const field_ptr,
+                                   const uint8_t *const data,
+                                   uint8_t data_length) {
+    const uint8_t *value;
+    e_type field_type;
+    cx_err_t error = CX_INTERNAL_ERROR;
+
+    field_type = struct_field_type(field_ptr);
+    if (IS_DYN(field_type)) {
+        CX_CHECK(cx_keccak_init_no_throw(&global_sha3, 256));
+        hash_nbytes(data, data_length, (cx_hash_t *) &global_sha3);
+        value = field_hash_finalize_dynamic();
+    } else {
+        value = field_hash_finalize_static(field_ptr, data, data_length);
+    }
+    if (value == NULL) {
+        return false;
+    }
+    field_hash_feed_parent(field_type, value);
+    if (path_get_root_type() == ROOT_DOMAIN) {
+        if (field_hash_domain_special_fields(field_ptr, data, data_length) == false) {
+            return false;
+        }
+    }
+    path_advance(true);
+    return true;
+end:
+    return false;
+}
+
+/**
+ * Hash packed field values
+ *
+ * Consecutive fields (typically the elements of an array of a primitive type), each one complete
+ * and prefixed by its 2-byte length. None of them is shown nor has a filter, they are hashed in a
+ * loop and only the last one gets a response.
+ *
+ * If the first field has to be shown (verbose mode...), nothing is hashed and the values are
+ * refused with APDU_RESPONSE_COMMAND_NOT_ALLOWED, for the client to send them one by one.
+ *
+ * @param[in] data the packed values
+ * @param[in] data_length their total length
+ * @return whether the data hashing was successful or not
+ */
+bool field_hash_packed(const uint8_t *data, uint8_t data_length) {
+    const void *field_ptr;
+    uint8_t data_idx = 0;
+    uint16_t value_length;
+
+    if ((fh == NULL) || (fh->state != FHS_IDLE)) {
+        apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
+        return false;
+    }
+    if (data_length == 0) {
+        apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+        return false;
+    }
+    while (data_idx < data_length) {
+        if ((field_ptr = path_get_field()) == NULL) {
+            apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
+            return false;
+        }
+        if ((data_idx + sizeof(value_length)) > data_length) {  // check buffer bound
+            apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+            return false;
+        }
+        value_length = U2BE(data, data_idx);
+        data_idx += sizeof(value_length);
+        if ((data_idx + value_length) > data_length) {  // check buffer bound
+            apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+            return false;
+        }
+        if (!ui_712_skip_field()) {
+            if (data_idx == sizeof(value_length)) {  // nothing hashed yet
+                apdu_response_code = APDU_RESPONSE_COMMAND_NOT_ALLOWED;
+            }
+            return false;
+        }
+        if (!field_hash_unformatted(field_ptr, &data[data_idx], value_length)) {
+            return false;
+        }
+        data_idx += value_length;
+    }
+    ui_712_next_field();
+    return true;
+}
+
 #endif  // HAVE_EIP712_FULL_SUPPORT
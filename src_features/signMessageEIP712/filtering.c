@@ -5,11 +5,13 @@
 #include "ethUstream.h"      // INT256_LENGTH
 #include "apdu_constants.h"  // APDU return codes
 #include "public_keys.h"
+#include "sig_cache.h"
 #include "context_712.h"
 #include "commands_712.h"
 #include "typed_data.h"
 #include "path.h"
 #include "ui_logic.h"
+#include "manage_asset_info.h"  // asset_info_is_set
 
 #define FILT_MAGIC_MESSAGE_INFO      183
 #define FILT_MAGIC_AMOUNT_JOIN_TOKEN 11
@@ -91,17 +93,17 @@ static bool sig_verif_start(cx_sha256_t *hash_ctx, uint8_t magic) {
  */
 static bool sig_verif_end(cx_sha256_t *hash_ctx, const uint8_t *sig, uint8_t sig_length) {
     uint8_t hash[INT256_LENGTH];
-    cx_ecfp_public_key_t verifying_key;
     cx_err_t error = CX_INTERNAL_ERROR;
 
     // Finalize hash
     CX_CHECK(cx_hash_no_throw((cx_hash_t *) hash_ctx, CX_LAST, NULL, 0, hash, INT256_LENGTH));
 
-    CX_CHECK(cx_ecfp_init_public_key_no_throw(CX_CURVE_256K1,
-                                              LEDGER_SIGNATURE_PUBLIC_KEY,
-                                              sizeof(LEDGER_SIGNATURE_PUBLIC_KEY),
-                                              &verifying_key));
-    if (!cx_ecdsa_verify_no_throw(&verifying_key, hash, sizeof(hash), sig, sig_length)) {
+    if (!sig_cache_verify(LEDGER_SIGNATURE_PUBLIC_KEY,
+                          sizeof(LEDGER_SIGNATURE_PUBLIC_KEY),
+                          hash,
+                          sizeof(hash),
+                          sig,
+                          sig_length)) {
 #ifndef HAVE_BYPASS_SIGNATURES
         PRINTF("Invalid EIP-712 filtering signature\n");
         apdu_response_code = APDU_RESPONSE_INVALID_DATA;
@@ -124,7 +126,7 @@ static bool check_token_index(uint8_t idx) {
         PRINTF("Error: token index out of range (%u)\n", idx);
         return false;
     }
-    if (!tmpCtx.transactionContext.assetSet[idx]) {
+    if (!asset_info_is_set(idx)) {
         PRINTF("Error: token not set (%u)\n", idx);
         return false;
     }
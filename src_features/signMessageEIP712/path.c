@@ -23,44 +23,17 @@ static s_path *path_struct = NULL;
  * @return the field which the first Nth depths points to
  */
 static const void *get_nth_field(uint8_t *const fields_count_ptr, uint8_t n) {
-    const void *struct_ptr = NULL;
-    const void *field_ptr = NULL;
-    const char *typename;
-    uint8_t length;
-    uint8_t fields_count;
-
     if (path_struct == NULL) {
         return NULL;
     }
-
-    struct_ptr = path_struct->root_struct;
-
-    if (n > path_struct->depth_count)  // sanity check
+    if ((n == 0) || (n > path_struct->depth_count))  // sanity check
     {
         return NULL;
     }
-    for (uint8_t depth = 0; depth < n; ++depth) {
-        field_ptr = get_struct_fields_array(struct_ptr, &fields_count);
-
-        if (fields_count_ptr != NULL) {
-            *fields_count_ptr = fields_count;
-        }
-        // check if the index at this depth makes sense
-        if (path_struct->depths[depth] > fields_count) {
-            return NULL;
-        }
-
-        for (uint8_t index = 0; index < path_struct->depths[depth]; ++index) {
-            field_ptr = get_next_struct_field(field_ptr);
-        }
-        if (struct_field_type(field_ptr) == TYPE_CUSTOM) {
-            typename = get_struct_field_typename(field_ptr, &length);
-            if ((struct_ptr = get_structn(typename, length)) == NULL) {
-                return NULL;
-            }
-        }
+    if (fields_count_ptr != NULL) {
+        *fields_count_ptr = path_struct->fields_counts[n - 1];
     }
-    return field_ptr;
+    return path_struct->fields[n - 1];
 }
 
 /**
@@ -95,6 +68,10 @@ const void *path_get_nth_field_to_last(uint8_t n) {
     const void *field_ptr;
     const void *struct_ptr = NULL;
 
+    if ((n > 0) && (n < path_struct->depth_count)) {
+        // struct of the field, already resolved at the next depth
+        return path_struct->structs[path_struct->depth_count - n];
+    }
     field_ptr = get_nth_field(NULL, path_struct->depth_count - n);
     if (field_ptr != NULL) {
         typename = get_struct_field_typename(field_ptr, &typename_len);
@@ -113,18 +90,27 @@ const void *path_get_field(void) {
 }
 
 /**
- * Go down (add) a depth level.
+ * Go down (add) a depth level, pointing to the first field of the given struct.
  *
+ * @param[in] struct_ptr the struct of the new depth level
  * @return whether the push was successful
  */
-static bool path_depth_list_push(void) {
+static bool path_depth_list_push(const void *const struct_ptr) {
+    uint8_t depth;
+
     if (path_struct == NULL) {
         return false;
     }
     if (path_struct->depth_count == MAX_PATH_DEPTH) {
         return false;
     }
-    path_struct->depths[path_struct->depth_count] = 0;
+    depth = path_struct->depth_count;
+    if ((path_struct->fields[depth] =
+             get_struct_fields_array(struct_ptr, &path_struct->fields_counts[depth])) == NULL) {
+        return false;
+    }
+    path_struct->structs[depth] = struct_ptr;
+    path_struct->depths[depth] = 0;
     path_struct->depth_count += 1;
     return true;
 }
@@ -342,7 +328,7 @@ static bool path_update(bool skip_if_array, bool stop_at_array) {
         //       an empty array of structs in which case we don't want to show it but the
         //       size is only known later
         // ui_712_queue_struct_to_review();
-        path_depth_list_push();
+        path_depth_list_push(struct_ptr);
     }
     return true;
 }
@@ -362,6 +348,11 @@ bool path_set_root(const char *const struct_name, uint8_t name_length) {
         return false;
     }
 
+    // all the structs are defined by now, index them before the first hashing context
+    if ((struct_state != DEFINED) && !typed_data_build_index()) {
+        return false;
+    }
+
     path_struct->root_struct = get_structn(struct_name, name_length);
 
     if (path_struct->root_struct == NULL) {
@@ -385,7 +376,7 @@ bool path_set_root(const char *const struct_name, uint8_t name_length) {
 
     // init depth, at 0 : empty path
     path_struct->depth_count = 0;
-    path_depth_list_push();
+    path_depth_list_push(path_struct->root_struct);
 
     // init array levels at 0
     path_struct->array_depth_count = 0;
@@ -541,8 +532,12 @@ static bool path_advance_in_struct(void) {
     }
     if (path_struct->depth_count > 0) {
         *depth += 1;
-        ui_712_notify_filter_change();
         end_reached = (*depth == fields_count);
+        if (!end_reached) {
+            path_struct->fields[path_struct->depth_count - 1] =
+                get_next_struct_field(path_struct->fields[path_struct->depth_count - 1]);
+        }
+        ui_712_notify_filter_change();
     }
     if (end_reached) {
         path_depth_list_pop();
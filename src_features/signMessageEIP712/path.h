@@ -20,6 +20,10 @@ typedef enum { ROOT_DOMAIN, ROOT_MESSAGE } e_root_type;
 typedef struct {
     uint8_t depth_count;
     uint8_t depths[MAX_PATH_DEPTH];
+    // resolved at each depth : the struct, its number of fields & the field pointed to
+    const void *structs[MAX_PATH_DEPTH];
+    uint8_t fields_counts[MAX_PATH_DEPTH];
+    const void *fields[MAX_PATH_DEPTH];
     uint8_t array_depth_count;
     s_array_depth array_depths[MAX_ARRAY_DEPTH];
     const void *root_struct;
@@ -0,0 +1,130 @@
+#ifdef HAVE_EIP712_SCHEMA_CACHE
+
+#include <string.h>
+#include "os.h"
+#include "schema_cache.h"
+#include "schema_hash.h"
+#include "typed_data.h"
+#include "apdu_constants.h"  // APDU response codes
+
+/*
+ * Struct definitions of the previous EIP-712 messages
+ *
+ * Once the definitions of a message are complete, their in-memory form is kept keyed by the
+ * schema hash, so that a client signing another message of the same schema can send its hash
+ * instead of all the definitions. New schemas overwrite the slots in turn.
+ *
+ * Kept in RAM for the app session, or in flash across sessions in the builds made with
+ * EIP712_SCHEMA_CACHE_NVM=1, a schema already stored being never written again.
+ */
+#ifdef HAVE_EIP712_SCHEMA_CACHE_NVM
+const schema_cache_t N_schema_cache_real;
+
+static const schema_cache_t *get_cache(void) {
+    return (const schema_cache_t *) PIC(&N_schema_cache_real);
+}
+
+static void cache_write(const void *dst, const void *src, size_t size) {
+    nvm_write((void *) dst, (void *) src, size);
+}
+#else
+static schema_cache_t g_schema_cache;
+
+static const schema_cache_t *get_cache(void) {
+    return &g_schema_cache;
+}
+
+static void cache_write(const void *dst, const void *src, size_t size) {
+    memcpy((void *) dst, src, size);
+}
+#endif
+
+/**
+ * Find the entry of a given schema
+ *
+ * @param[in] schema_hash schema hash
+ * @return the entry, NULL if the schema is not cached
+ */
+static const schema_cache_entry_t *find_entry(const uint8_t *schema_hash) {
+    const schema_cache_t *cache = get_cache();
+
+    for (uint8_t i = 0; i < EIP712_SCHEMA_CACHE_SIZE; i++) {
+        const schema_cache_entry_t *entry = &cache->entries[i];
+
+        if ((entry->size != 0) &&
+            (memcmp(entry->schema_hash, schema_hash, sizeof(entry->schema_hash)) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Keep the struct definitions of the current message
+ *
+ * To be called once they are complete, does nothing if they were themselves loaded from
+ * the cache or if they are too large for it.
+ */
+void schema_cache_add(void) {
+    const schema_cache_t *cache = get_cache();
+    const schema_cache_entry_t *entry;
+    const uint8_t *structs;
+    uint16_t size;
+    uint8_t next;
+
+    if (eip712_context->schema_cached) {
+        return;
+    }
+    structs = get_structs_array_raw(&size);
+    if (size > EIP712_SCHEMA_CACHE_ENTRY_SIZE) {
+        PRINTF("Schema of %u bytes too large for the cache\n", size);
+        return;
+    }
+    if (!compute_schema_hash() || (find_entry(eip712_context->schema_hash) != NULL)) {
+        return;
+    }
+    next = cache->next;
+    entry = &cache->entries[next];
+    // invalidated while it is being written
+    if (entry->size != 0) {
+        uint16_t unused = 0;
+
+        cache_write(&entry->size, &unused, sizeof(unused));
+    }
+    cache_write(entry->schema_hash, eip712_context->schema_hash, sizeof(entry->schema_hash));
+    cache_write(entry->structs, structs, size);
+    cache_write(&entry->size, &size, sizeof(size));
+    next = (next + 1) % EIP712_SCHEMA_CACHE_SIZE;
+    cache_write(&cache->next, &next, sizeof(next));
+}
+
+/**
+ * Load the struct definitions of a cached schema
+ *
+ * Only possible before any struct definition.
+ *
+ * @param[in] schema_hash schema hash
+ * @param[in] length its length
+ * @return whether it was successful
+ */
+bool schema_cache_load(const uint8_t *schema_hash, uint8_t length) {
+    const schema_cache_entry_t *entry;
+
+    if (length != sizeof(eip712_context->schema_hash)) {
+        apdu_response_code = APDU_RESPONSE_INVALID_DATA;
+        return false;
+    }
+    if ((entry = find_entry(schema_hash)) == NULL) {
+        PRINTF("Schema not in the cache\n");
+        apdu_response_code = APDU_RESPONSE_REF_DATA_NOT_FOUND;
+        return false;
+    }
+    if (!set_structs_array_raw(entry->structs, entry->size)) {
+        return false;
+    }
+    memcpy(eip712_context->schema_hash, schema_hash, sizeof(eip712_context->schema_hash));
+    eip712_context->schema_cached = true;
+    return true;
+}
+
+#endif  // HAVE_EIP712_SCHEMA_CACHE
@@ -0,0 +1,36 @@
+#ifndef SCHEMA_CACHE_H_
+#define SCHEMA_CACHE_H_
+
+#ifdef HAVE_EIP712_SCHEMA_CACHE
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "context_712.h"
+
+// Number of schemas kept, set at build time
+#ifndef EIP712_SCHEMA_CACHE_SIZE
+#define EIP712_SCHEMA_CACHE_SIZE 3
+#endif
+
+// Largest struct definitions kept (in their in-memory form), larger schemas are not cached
+#ifndef EIP712_SCHEMA_CACHE_ENTRY_SIZE
+#define EIP712_SCHEMA_CACHE_ENTRY_SIZE 512
+#endif
+
+typedef struct {
+    uint8_t schema_hash[sizeof(((s_eip712_context *) 0)->schema_hash)];
+    uint16_t size;  // 0 = unused
+    uint8_t structs[EIP712_SCHEMA_CACHE_ENTRY_SIZE];
+} schema_cache_entry_t;
+
+typedef struct {
+    uint8_t next;  // slot overwritten by the next new schema
+    schema_cache_entry_t entries[EIP712_SCHEMA_CACHE_SIZE];
+} schema_cache_t;
+
+void schema_cache_add(void);
+bool schema_cache_load(const uint8_t *schema_hash, uint8_t length);
+
+#endif  // HAVE_EIP712_SCHEMA_CACHE
+
+#endif  // SCHEMA_CACHE_H_
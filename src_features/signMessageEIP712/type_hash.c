@@ -167,12 +167,19 @@ static const void **get_struct_dependencies(uint8_t *const deps_count,
  * @return whether the type_hash was successful or not
  */
 bool type_hash(const char *const struct_name, const uint8_t struct_name_length, uint8_t *hash_buf) {
-    const void *const struct_ptr = get_structn(struct_name, struct_name_length);
+    uint8_t *const cached_hash = get_struct_type_hash(struct_name, struct_name_length);
+    const void *struct_ptr;
     uint8_t deps_count = 0;
     const void **deps;
-    void *mem_loc_bak = mem_alloc(0);
+    mem_mark_t mark = mem_mark();
     cx_err_t error = CX_INTERNAL_ERROR;
 
+    // the same struct type is often hashed many times (arrays of structs)
+    if ((cached_hash != NULL) && !allzeroes(cached_hash, KECCAK256_HASH_BYTESIZE)) {
+        memcpy(hash_buf, cached_hash, KECCAK256_HASH_BYTESIZE);
+        return true;
+    }
+    struct_ptr = get_structn(struct_name, struct_name_length);
     CX_CHECK(cx_keccak_init_no_throw(&global_sha3, 256));
     deps = get_struct_dependencies(&deps_count, NULL, struct_ptr);
     if ((deps_count > 0) && (deps == NULL)) {
@@ -189,7 +196,7 @@ bool type_hash(const char *const struct_name, const uint8_t struct_name_length,
         }
         deps += 1;
     }
-    mem_dealloc(mem_alloc(0) - mem_loc_bak);
+    mem_release(mark);
 
     // copy hash into memory
     CX_CHECK(cx_hash_no_throw((cx_hash_t *) &global_sha3,
@@ -198,6 +205,9 @@ bool type_hash(const char *const struct_name, const uint8_t struct_name_length,
                               0,
                               hash_buf,
                               KECCAK256_HASH_BYTESIZE));
+    if (cached_hash != NULL) {
+        memcpy(cached_hash, hash_buf, KECCAK256_HASH_BYTESIZE);
+    }
     return true;
 end:
     return false;
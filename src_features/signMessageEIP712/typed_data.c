@@ -8,6 +8,12 @@
 #include "context_712.h"
 #include "mem.h"
 #include "mem_utils.h"
+#include "common_utils.h"
+
+// Bound to the memory taken by the typeHash of the structs, not kept for larger schemas
+#define TYPE_HASH_CACHE_MAX_STRUCTS 48
+// Memory left for the message once the typeHash are kept (path hash contexts & field values)
+#define TYPE_HASH_CACHE_MEM_RESERVE 2048
 
 static s_typed_data *typed_data = NULL;
 
@@ -30,6 +36,9 @@ bool typed_data_init(void) {
 
         // create len(types)
         *(typed_data->structs_array) = 0;
+        typed_data->structs_index = NULL;
+        typed_data->structs_index_count = 0;
+        typed_data->structs_type_hashes = NULL;
     }
     return true;
 }
@@ -409,9 +418,203 @@ const uint8_t *get_structs_array(uint8_t *const length) {
     return get_array_in_mem(typed_data->structs_array, length);
 }
 
+/**
+ * Get the in-memory form of the structs array
+ *
+ * @param[out] size its size in bytes, the structs count included
+ * @return pointer to the structs count
+ */
+const uint8_t *get_structs_array_raw(uint16_t *const size) {
+    const uint8_t *struct_ptr;
+    uint8_t structs_count = 0;
+
+    struct_ptr = get_structs_array(&structs_count);
+    while (structs_count-- > 0) {
+        struct_ptr = get_next_struct(struct_ptr);
+    }
+    *size = struct_ptr - typed_data->structs_array;
+    return typed_data->structs_array;
+}
+
+/**
+ * Set the structs array from its in-memory form
+ *
+ * Only possible before any struct definition, the structs array then being the last
+ * allocation.
+ *
+ * @param[in] data the structs count followed by the structs
+ * @param[in] size its size in bytes
+ * @return whether it was successful
+ */
+bool set_structs_array_raw(const uint8_t *const data, uint16_t size) {
+    if ((typed_data == NULL) || (size == 0) || (*(typed_data->structs_array) != 0) ||
+        (mem_alloc(0) != (typed_data->structs_array + 1))) {
+        apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
+        return false;
+    }
+    if (mem_alloc(size - 1) == NULL) {
+        apdu_response_code = APDU_RESPONSE_INSUFFICIENT_MEMORY;
+        return false;
+    }
+    memcpy(typed_data->structs_array, data, size);
+    struct_state = INITIALIZED;
+    return true;
+}
+
+/**
+ * Hash a struct name for the structs index
+ *
+ * FNV-1a folded on 16 bits, the matches still being checked on the full name.
+ *
+ * @param[in] name struct name
+ * @param[in] length name length
+ * @return name hash
+ */
+static uint16_t struct_name_hash(const char *const name, uint8_t length) {
+    uint32_t hash = 0x811c9dc5;
+
+    for (uint8_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t) name[i];
+        hash *= 0x01000193;
+    }
+    return (uint16_t) ((hash >> 16) ^ hash);
+}
+
+/**
+ * Build the structs index, once all the structs have been defined
+ *
+ * It is allocated right after the struct definitions, so it lasts as long as them, along with
+ * the memory keeping the typeHash of each struct once computed.
+ *
+ * @return whether it was successful
+ */
+bool typed_data_build_index(void) {
+    uint8_t structs_count = 0;
+    const uint8_t *struct_ptr;
+    const char *name;
+    uint8_t name_length = 0;
+    s_struct_index_entry entry;
+    uint8_t idx;
+    size_t size;
+
+    if (typed_data == NULL) {
+        apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
+        return false;
+    }
+    if (typed_data->structs_index != NULL) {
+        return true;
+    }
+    struct_ptr = get_structs_array(&structs_count);
+    if ((typed_data->structs_index =
+             mem_alloc_and_align(sizeof(*typed_data->structs_index) * structs_count,
+                                 __alignof__(*typed_data->structs_index))) == NULL) {
+        apdu_response_code = APDU_RESPONSE_INSUFFICIENT_MEMORY;
+        return false;
+    }
+    for (uint8_t count = 0; count < structs_count; ++count) {
+        name = get_struct_name(struct_ptr, &name_length);
+        entry.name_hash = struct_name_hash(name, name_length);
+        entry.offset = struct_ptr - typed_data->structs_array;
+        // insertion sort, there are at most 255 structs
+        for (idx = count;
+             (idx > 0) && (typed_data->structs_index[idx - 1].name_hash > entry.name_hash);
+             --idx) {
+            typed_data->structs_index[idx] = typed_data->structs_index[idx - 1];
+        }
+        typed_data->structs_index[idx] = entry;
+        struct_ptr = get_next_struct(struct_ptr);
+    }
+    typed_data->structs_index_count = structs_count;
+
+    size = KECCAK256_HASH_BYTESIZE * structs_count;
+    // only kept if the message still fits, otherwise they will be computed every time
+    if ((structs_count <= TYPE_HASH_CACHE_MAX_STRUCTS) &&
+        (mem_available() >= (size + TYPE_HASH_CACHE_MEM_RESERVE))) {
+        if ((typed_data->structs_type_hashes = mem_alloc(size)) != NULL) {
+            explicit_bzero(typed_data->structs_type_hashes, size);
+        }
+    }
+    return true;
+}
+
+/**
+ * Find the structs index entry of a given struct name
+ *
+ * @param[in] name struct name
+ * @param[in] length name length
+ * @return position of the entry, \ref structs_index_count if not found
+ */
+static uint8_t get_struct_index_entry(const char *const name, const uint8_t length) {
+    uint16_t name_hash = struct_name_hash(name, length);
+    uint8_t low = 0;
+    uint8_t high = typed_data->structs_index_count;
+    uint8_t mid;
+    const uint8_t *struct_ptr;
+    const char *struct_name;
+    uint8_t name_length = 0;
+
+    // first entry with that hash
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (typed_data->structs_index[mid].name_hash < name_hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    // then check the names of all the entries with it
+    for (; (low < typed_data->structs_index_count) &&
+           (typed_data->structs_index[low].name_hash == name_hash);
+         ++low) {
+        struct_ptr = typed_data->structs_array + typed_data->structs_index[low].offset;
+        struct_name = get_struct_name(struct_ptr, &name_length);
+        if ((length == name_length) && (memcmp(name, struct_name, length) == 0)) {
+            return low;
+        }
+    }
+    return typed_data->structs_index_count;
+}
+
+/**
+ * Find struct with a given name in the structs index
+ *
+ * @param[in] name struct name
+ * @param[in] length name length
+ * @return pointer to struct, \ref NULL if not found
+ */
+static const uint8_t *get_structn_indexed(const char *const name, const uint8_t length) {
+    uint8_t entry = get_struct_index_entry(name, length);
+
+    if (entry == typed_data->structs_index_count) {
+        return NULL;
+    }
+    return typed_data->structs_array + typed_data->structs_index[entry].offset;
+}
+
+/**
+ * Get the memory where the typeHash of a given struct is kept
+ *
+ * @param[in] name struct name
+ * @param[in] length name length
+ * @return pointer to the typeHash, all zeroes until computed, \ref NULL if it is not kept
+ */
+uint8_t *get_struct_type_hash(const char *const name, const uint8_t length) {
+    uint8_t entry;
+
+    if ((name == NULL) || (typed_data == NULL) || (typed_data->structs_type_hashes == NULL)) {
+        return NULL;
+    }
+    if ((entry = get_struct_index_entry(name, length)) == typed_data->structs_index_count) {
+        return NULL;
+    }
+    return typed_data->structs_type_hashes + (KECCAK256_HASH_BYTESIZE * entry);
+}
+
 /**
  * Find struct with a given name
  *
+ * Looked up in the structs index once built, otherwise in the structs array.
+ *
  * @param[in] name struct name
  * @param[in] length name length
  * @return pointer to struct
@@ -420,12 +623,18 @@ const uint8_t *get_structn(const char *const name, const uint8_t length) {
     uint8_t structs_count = 0;
     const uint8_t *struct_ptr;
     const char *struct_name;
-    uint8_t name_length;
+    uint8_t name_length = 0;
 
-    if (name == NULL) {
+    if ((name == NULL) || (typed_data == NULL)) {
         apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
         return NULL;
     }
+    if (typed_data->structs_index != NULL) {
+        if ((struct_ptr = get_structn_indexed(name, length)) == NULL) {
+            apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
+        }
+        return struct_ptr;
+    }
     struct_ptr = get_structs_array(&structs_count);
     while (structs_count-- > 0) {
         struct_name = get_struct_name(struct_ptr, &name_length);
@@ -28,9 +28,19 @@ typedef enum {
     TYPES_COUNT
 } e_type;
 
+// Entry of the struct name index, sorted by name hash
+typedef struct {
+    uint16_t name_hash;
+    uint16_t offset;  // from the start of the structs array
+} s_struct_index_entry;
+
 typedef struct {
     uint8_t *structs_array;
     uint8_t *current_struct_fields_array;
+    s_struct_index_entry *structs_index;
+    uint8_t structs_index_count;
+    // typeHash of each indexed struct, all zeroes until computed
+    uint8_t *structs_type_hashes;
 } s_typed_data;
 
 typedef uint8_t typedesc_t;
@@ -54,7 +64,11 @@ const char *get_struct_name(const uint8_t *ptr, uint8_t *const length);
 const uint8_t *get_struct_fields_array(const uint8_t *ptr, uint8_t *const length);
 const uint8_t *get_next_struct(const uint8_t *ptr);
 const uint8_t *get_structs_array(uint8_t *const length);
+const uint8_t *get_structs_array_raw(uint16_t *const size);
+bool set_structs_array_raw(const uint8_t *const data, uint16_t size);
 const uint8_t *get_structn(const char *const name_ptr, const uint8_t name_length);
+bool typed_data_build_index(void);
+uint8_t *get_struct_type_hash(const char *const name, const uint8_t length);
 bool set_struct_name(uint8_t length, const uint8_t *const name);
 bool set_struct_field(uint8_t length, const uint8_t *const data);
 bool typed_data_init(void);
@@ -11,7 +11,7 @@
 #include "common_utils.h"  // uint256_to_decimal
 #include "common_712.h"
 #include "context_712.h"     // eip712_context_deinit
-#include "uint256.h"         // tostring256 && tostring256_signed
+#include "uint256.h"         // tostring256, tostring256_signed && amount_to_string
 #include "path.h"            // path_get_root_type
 #include "apdu_constants.h"  // APDU response codes
 #include "typed_data.h"
@@ -108,6 +108,22 @@ static void ui_712_set_buf(const char *const src,
     }
 }
 
+/**
+ * Skip a field hashed without being formatted
+ *
+ * Only possible if it is neither shown nor has a filter, and no struct is waiting to be reviewed.
+ *
+ * @return whether it was skipped
+ */
+bool ui_712_skip_field(void) {
+    if ((ui_ctx == NULL) || ui_712_field_shown() || (ui_ctx->field_flags != 0) ||
+        (ui_ctx->structs_to_review > 0)) {
+        apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
+        return false;
+    }
+    return true;
+}
+
 /**
  * Skip the field if needed and reset its UI flags
  */
@@ -381,12 +397,12 @@ static bool ui_712_format_amount_join(void) {
     const tokenDefinition_t *token;
     token = &tmpCtx.transactionContext.extraInfo[ui_ctx->amount.idx].token;
 
-    if (!amountToString(ui_ctx->amount.joins[ui_ctx->amount.idx].value,
-                        ui_ctx->amount.joins[ui_ctx->amount.idx].value_length,
-                        token->decimals,
-                        token->ticker,
-                        strings.tmp.tmp,
-                        sizeof(strings.tmp.tmp))) {
+    if (!amount_to_string(ui_ctx->amount.joins[ui_ctx->amount.idx].value,
+                          ui_ctx->amount.joins[ui_ctx->amount.idx].value_length,
+                          token->decimals,
+                          token->ticker,
+                          strings.tmp.tmp,
+                          sizeof(strings.tmp.tmp))) {
         return false;
     }
     ui_ctx->field_flags |= UI_712_FIELD_SHOWN;
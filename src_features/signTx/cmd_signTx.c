@@ -2,6 +2,7 @@
 #include "apdu_constants.h"
 #include "feature_signTx.h"
 #include "eth_plugin_interface.h"
+#include "profiling.h"
 
 void handleSign(uint8_t p1,
                 uint8_t p2,
@@ -42,7 +43,8 @@ void handleSign(uint8_t p1,
         uint8_t txType = *workBuffer;
         if (txType >= MIN_TX_TYPE && txType <= MAX_TX_TYPE) {
             // Enumerate through all supported txTypes here...
-            if (txType == EIP2930 || txType == EIP1559) {
+            if (txType == EIP2930 || txType == EIP1559 || txType == EIP4844 ||
+                txType == EIP7702) {
                 CX_ASSERT(cx_hash_no_throw((cx_hash_t *) &global_sha3, 0, workBuffer, 1, NULL, 0));
                 txContext.txType = txType;
                 workBuffer++;
@@ -73,6 +75,7 @@ void handleSign(uint8_t p1,
                          workBuffer,
                          dataLength,
                          (chainConfig->chainId == 888 ? TX_FLAG_TYPE : 0));  // Wanchain exception
+    PROFILING_COUNT("processTx", 0);
     switch (txResult) {
         case USTREAM_SUSPENDED:
             break;
@@ -3,6 +3,7 @@
 #include "common_utils.h"
 #include "feature_signTx.h"
 #include "uint256.h"
+#include "uint_common.h"
 #include "eth_plugin_handler.h"
 #include "network.h"
 #include "common_ui.h"
@@ -11,6 +12,7 @@
 #include "crypto_helpers.h"
 #include "format.h"
 #include "manage_asset_info.h"
+#include "profiling.h"
 
 #define ERR_SILENT_MODE_CHECK_FAILED 0x6001
 
@@ -32,11 +34,59 @@ static uint32_t splitBinaryParameterPart(char *result, size_t result_size, uint8
     }
 }
 
+/**
+ * Provide the plugin some parameters of the data field with a single call
+ *
+ * The plugin only gets a pointer in the APDU buffer, it has to copy what it keeps.
+ *
+ * @param[in] parameters consecutive parameters, 32 bytes each
+ * @param[in] count number of parameters
+ * @return whether the plugin accepted them
+ */
+static bool provide_plugin_parameters(const uint8_t *parameters, uint16_t count) {
+    ethPluginProvideParameters_t pluginProvideParameters;
+
+    eth_plugin_prepare_provide_parameters(&pluginProvideParameters,
+                                          parameters,
+                                          dataContext.tokenContext.fieldIndex * 32 + 4,
+                                          count);
+    if (!eth_plugin_call(ETH_PLUGIN_PROVIDE_PARAMETER, (void *) &pluginProvideParameters)) {
+        return false;
+    }
+    dataContext.tokenContext.fieldIndex += count;
+    return true;
+}
+
+/**
+ * Provide the plugin every complete parameter left in the current chunk, without buffering them
+ *
+ * @param[in] context transaction parsing context
+ * @return \ref CUSTOM_NOT_HANDLED if no parameter is complete, the processing status otherwise
+ */
+static customStatus_e process_plugin_parameters(txContext_t *context) {
+    uint32_t length =
+        MIN(context->commandLength, context->currentFieldLength - context->currentFieldPos);
+    uint16_t count = length / 32;
+    const uint8_t *parameters = context->workBuffer;
+
+    if (count == 0) {
+        return CUSTOM_NOT_HANDLED;
+    }
+    PRINTF("currentFieldPos %d parameters %d\n", context->currentFieldPos, count);
+    copyTxData(context, NULL, count * 32);
+    if (context->currentFieldPos == context->currentFieldLength) {
+        context->currentField++;
+        context->processingField = false;
+    }
+    if (!provide_plugin_parameters(parameters, count)) {
+        PRINTF("Plugin parameters call failed\n");
+        return CUSTOM_FAULT;
+    }
+    return CUSTOM_HANDLED;
+}
+
 customStatus_e customProcessor(txContext_t *context) {
-    if (((context->txType == LEGACY && context->currentField == LEGACY_RLP_DATA) ||
-         (context->txType == EIP2930 && context->currentField == EIP2930_RLP_DATA) ||
-         (context->txType == EIP1559 && context->currentField == EIP1559_RLP_DATA)) &&
-        (context->currentFieldLength != 0)) {
+    if (isDataField(context) && (context->currentFieldLength != 0)) {
         context->content->dataPresent = true;
         // If handling a new contract rather than a function call, abort immediately
         if (tmpContent.txContent.destinationLength == 0) {
@@ -47,7 +97,7 @@ customStatus_e customProcessor(txContext_t *context) {
             return CUSTOM_NOT_HANDLED;
         }
         if (context->currentFieldPos == 0) {
-            ethPluginInitContract_t pluginInit;
+            ethPluginInitContractExt_t pluginInit;
             // If handling the beginning of the data field, assume that the function selector is
             // present
             if (context->commandLength < 4) {
@@ -98,6 +148,15 @@ customStatus_e customProcessor(txContext_t *context) {
                 dataContext.tokenContext.pluginStatus <= ETH_PLUGIN_RESULT_UNSUCCESSFUL) {
                 return CUSTOM_NOT_HANDLED;
             }
+            // plugins which support it get the whole parameters straight from the APDU
+            if ((dataContext.tokenContext.pluginStatus >= ETH_PLUGIN_RESULT_SUCCESSFUL) &&
+                dataContext.tokenContext.pluginBatchParameters &&
+                (dataContext.tokenContext.fieldOffset == 0)) {
+                customStatus_e status = process_plugin_parameters(context);
+                if (status != CUSTOM_NOT_HANDLED) {
+                    return status;
+                }
+            }
             blockSize = 32 - (dataContext.tokenContext.fieldOffset % 32);
         }
 
@@ -126,16 +185,11 @@ customStatus_e customProcessor(txContext_t *context) {
         if (copySize == blockSize) {
             // Can process or display
             if (dataContext.tokenContext.pluginStatus >= ETH_PLUGIN_RESULT_SUCCESSFUL) {
-                ethPluginProvideParameter_t pluginProvideParameter;
-                eth_plugin_prepare_provide_parameter(&pluginProvideParameter,
-                                                     dataContext.tokenContext.data,
-                                                     dataContext.tokenContext.fieldIndex * 32 + 4);
-                if (!eth_plugin_call(ETH_PLUGIN_PROVIDE_PARAMETER,
-                                     (void *) &pluginProvideParameter)) {
+                // one by one, or split across chunks, or the shorter last one
+                if (!provide_plugin_parameters(dataContext.tokenContext.data, 1)) {
                     PRINTF("Plugin parameter call failed\n");
                     return CUSTOM_FAULT;
                 }
-                dataContext.tokenContext.fieldIndex++;
                 dataContext.tokenContext.fieldOffset = 0;
                 memset(dataContext.tokenContext.data, 0, sizeof(dataContext.tokenContext.data));
                 return CUSTOM_HANDLED;
@@ -204,42 +258,10 @@ static void address_to_string(uint8_t *in,
 static void raw_fee_to_string(uint256_t *rawFee, char *displayBuffer, uint32_t displayBufferSize) {
     uint64_t chain_id = get_tx_chain_id();
     const char *feeTicker = get_displayable_ticker(&chain_id, chainConfig);
-    uint8_t tickerOffset = 0;
-    uint32_t i;
 
-    tostring256(rawFee, 10, (char *) (G_io_apdu_buffer + 100), 100);
-    i = 0;
-    while (G_io_apdu_buffer[100 + i]) {
-        i++;
-    }
-    adjustDecimals((char *) (G_io_apdu_buffer + 100),
-                   i,
-                   (char *) G_io_apdu_buffer,
-                   100,
-                   WEI_TO_ETHER);
-    i = 0;
-    tickerOffset = 0;
-    memset(displayBuffer, 0, displayBufferSize);
-
-    while (feeTicker[tickerOffset]) {
-        if ((uint32_t) tickerOffset >= displayBufferSize) {
-            break;
-        }
-
-        displayBuffer[tickerOffset] = feeTicker[tickerOffset];
-        tickerOffset++;
-    }
-    if ((uint32_t) tickerOffset < displayBufferSize) displayBuffer[tickerOffset++] = ' ';
-    while (G_io_apdu_buffer[i]) {
-        if ((uint32_t) (tickerOffset) + i >= displayBufferSize) {
-            break;
-        }
-        displayBuffer[tickerOffset + i] = G_io_apdu_buffer[i];
-        i++;
-    }
-
-    if ((uint32_t) (tickerOffset) + i < displayBufferSize) {
-        displayBuffer[tickerOffset + i] = '\0';
+    if (!amount256_to_string(rawFee, WEI_TO_ETHER, feeTicker, displayBuffer, displayBufferSize)) {
+        PRINTF("OVERFLOW, fee to string failed\n");
+        THROW(EXCEPTION_OVERFLOW);
     }
 }
 
@@ -259,7 +281,23 @@ static void max_transaction_fee_to_string(const txInt256_t *BEGasPrice,
     PRINTF("Gas limit %.*H\n", BEGasLimit->length, BEGasLimit->value);
     convertUint256BE(BEGasPrice->value, BEGasPrice->length, &gasPrice);
     convertUint256BE(BEGasLimit->value, BEGasLimit->length, &gasLimit);
-    mul256(&gasPrice, &gasLimit, &rawFee);
+    if (!mul256_checked(&gasPrice, &gasLimit, &rawFee)) {
+        THROW(EXCEPTION_OVERFLOW);
+    }
+    if (txContext.txType == EIP4844) {
+        // Blob gas is paid on top of the execution gas
+        const txInt256_t *BEBlobGasPrice = &txContext.summary.maxFeePerBlobGas;
+        uint256_t blobGasPrice = {0};
+        uint256_t blobGas = {0};
+        uint256_t blobFee = {0};
+
+        convertUint256BE(BEBlobGasPrice->value, BEBlobGasPrice->length, &blobGasPrice);
+        LOWER(LOWER(blobGas)) = (uint64_t) txContext.summary.blobs.count * GAS_PER_BLOB;
+        if (!mul256_checked(&blobGasPrice, &blobGas, &blobFee) ||
+            !add256_checked(&rawFee, &blobFee, &rawFee)) {
+            THROW(EXCEPTION_OVERFLOW);
+        }
+    }
     raw_fee_to_string(&rawFee, displayBuffer, displayBufferSize);
 }
 
@@ -317,8 +355,28 @@ static int strcasecmp_workaround(const char *str1, const char *str2) {
     return 0;
 }
 
+/**
+ * Look a token up among the known ones, then among the ones verified in a previous session
+ *
+ * @param[in] chain_id chain ID of the transaction
+ * @param[in] address contract address
+ * @return the token information, \ref NULL if it is unknown
+ */
+static extraInfo_t *lookup_token(uint64_t chain_id, const uint8_t *address) {
+    extraInfo_t *info = get_asset_info_by_addr(address);
+
+#ifdef HAVE_TOKEN_STORE
+    if (info == NULL) {
+        info = load_stored_asset_info(chain_id, address);
+    }
+#else
+    (void) chain_id;
+#endif
+    return info;
+}
+
 __attribute__((noinline)) static bool finalize_parsing_helper(bool direct, bool *use_standard_UI) {
-    char displayBuffer[50];
+    char displayBuffer[sizeof(strings.common.maxFee)];
     uint8_t decimals = WEI_TO_ETHER;
     uint64_t chain_id = get_tx_chain_id();
     const char *ticker = get_displayable_ticker(&chain_id, chainConfig);
@@ -367,14 +425,14 @@ __attribute__((noinline)) static bool finalize_parsing_helper(bool direct, bool
         if ((pluginFinalize.tokenLookup1 != NULL) || (pluginFinalize.tokenLookup2 != NULL)) {
             if (pluginFinalize.tokenLookup1 != NULL) {
                 PRINTF("Lookup1: %.*H\n", ADDRESS_LENGTH, pluginFinalize.tokenLookup1);
-                pluginProvideInfo.item1 = get_asset_info_by_addr(pluginFinalize.tokenLookup1);
+                pluginProvideInfo.item1 = lookup_token(chain_id, pluginFinalize.tokenLookup1);
                 if (pluginProvideInfo.item1 != NULL) {
                     PRINTF("Token1 ticker: %s\n", pluginProvideInfo.item1->token.ticker);
                 }
             }
             if (pluginFinalize.tokenLookup2 != NULL) {
                 PRINTF("Lookup2: %.*H\n", ADDRESS_LENGTH, pluginFinalize.tokenLookup2);
-                pluginProvideInfo.item2 = get_asset_info_by_addr(pluginFinalize.tokenLookup2);
+                pluginProvideInfo.item2 = lookup_token(chain_id, pluginFinalize.tokenLookup2);
                 if (pluginProvideInfo.item2 != NULL) {
                     PRINTF("Token2 ticker: %s\n", pluginProvideInfo.item2->token.ticker);
                 }
@@ -476,12 +534,12 @@ __attribute__((noinline)) static bool finalize_parsing_helper(bool direct, bool
 
         // Format the amount in a temporary buffer, if in swap case compare it with validated
         // amount, else commit it
-        if (!amountToString(tmpContent.txContent.value.value,
-                            tmpContent.txContent.value.length,
-                            decimals,
-                            ticker,
-                            displayBuffer,
-                            sizeof(displayBuffer))) {
+        if (!amount_to_string(tmpContent.txContent.value.value,
+                              tmpContent.txContent.value.length,
+                              decimals,
+                              ticker,
+                              displayBuffer,
+                              sizeof(displayBuffer))) {
             PRINTF("OVERFLOW, amount to string failed\n");
             THROW(EXCEPTION_OVERFLOW);
         }
@@ -526,6 +584,28 @@ __attribute__((noinline)) static bool finalize_parsing_helper(bool direct, bool
                     sizeof(strings.common.nonce));
     PRINTF("Nonce: %s\n", strings.common.nonce);
 
+    // Prepare the access list summary, only shown when there is one
+    if (txContext.summary.accessList.addresses != 0) {
+        snprintf(strings.common.accessList,
+                 sizeof(strings.common.accessList),
+                 "%u address%s, %u key%s",
+                 (unsigned int) txContext.summary.accessList.addresses,
+                 (txContext.summary.accessList.addresses > 1) ? "es" : "",
+                 (unsigned int) txContext.summary.accessList.storageKeys,
+                 (txContext.summary.accessList.storageKeys > 1) ? "s" : "");
+        PRINTF("Access list: %s\n", strings.common.accessList);
+    }
+
+    // Prepare the summary of the lists only found in blob and set code transactions
+    if ((txContext.txType == EIP4844) || (txContext.txType == EIP7702)) {
+        uint32_t count = (txContext.txType == EIP4844) ? txContext.summary.blobs.count
+                                                       : txContext.summary.authorizations.count;
+        if (!u64_to_string(count, strings.common.listCount, sizeof(strings.common.listCount))) {
+            THROW(0x6502);
+        }
+        PRINTF("List count: %s\n", strings.common.listCount);
+    }
+
     // Prepare network field
     get_network_as_string(strings.common.network_name, sizeof(strings.common.network_name));
     PRINTF("Network: %s\n", strings.common.network_name);
@@ -536,8 +616,11 @@ end:
 
 void finalizeParsing(bool direct) {
     bool use_standard_UI = true;
+    bool parsed;
 
-    if (!finalize_parsing_helper(direct, &use_standard_UI)) {
+    parsed = finalize_parsing_helper(direct, &use_standard_UI);
+    PROFILING_COUNT("finalizeParsing", 0);
+    if (!parsed) {
         return;
     }
     // If called from swap, the user has already validated a standard transaction
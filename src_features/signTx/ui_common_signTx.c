@@ -4,6 +4,7 @@
 #include "common_utils.h"
 #include "common_ui.h"
 #include "handle_swap_sign_transaction.h"
+#include "token_store.h"
 
 unsigned int io_seproxyhal_touch_tx_ok(__attribute__((unused)) const bagl_element_t *e) {
     uint32_t info = 0;
@@ -21,7 +22,7 @@ unsigned int io_seproxyhal_touch_tx_ok(__attribute__((unused)) const bagl_elemen
         THROW(0x6F00);
     }
 
-    if (txContext.txType == EIP1559 || txContext.txType == EIP2930) {
+    if (txContext.txType != LEGACY) {
         if (info & CX_ECCINFO_PARITY_ODD) {
             G_io_apdu_buffer[0] = 1;
         } else {
@@ -68,6 +69,10 @@ unsigned int io_seproxyhal_touch_tx_ok(__attribute__((unused)) const bagl_elemen
         }
     }
     reset_app_context();
+#ifdef HAVE_TOKEN_STORE
+    // the response is sent, the flash can be written
+    token_store_flush();
+#endif
     // Display back the original UX
     ui_idle();
     return 0;  // do not redraw the widget
@@ -79,6 +84,9 @@ unsigned int io_seproxyhal_touch_tx_cancel(__attribute__((unused)) const bagl_el
     G_io_apdu_buffer[1] = 0x85;
     // Send back the response, do not restart the event loop
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
+#ifdef HAVE_TOKEN_STORE
+    token_store_flush();
+#endif
     // Display back the original UX
     ui_idle();
     return 0;  // do not redraw the widget
@@ -15,7 +15,7 @@
 #define MAX_PLUGIN_ITEMS 8
 #define TAG_MAX_LEN      43
 #define VALUE_MAX_LEN    79
-#define MAX_PAIRS        12  // Max 10 for plugins + 2 (Network and fees)
+#define MAX_PAIRS        14  // Max 10 for plugins + 4 (2 list summaries, Network and fees)
 
 static nbgl_contentTagValue_t pairs[MAX_PAIRS];
 static nbgl_contentTagValueList_t pairsList;
@@ -84,6 +84,24 @@ static void get_lowercase_operation(char *dst, size_t dst_len) {
     dst[idx] = '\0';
 }
 
+// Lists of the transaction (access list, blobs or authorizations) are only shown as a summary
+static uint8_t setTxListPairs(uint8_t nbPairs) {
+    if (txContext.summary.accessList.addresses != 0) {
+        pairs[nbPairs].item = "Access list";
+        pairs[nbPairs].value = strings.common.accessList;
+        nbPairs++;
+    }
+    if (txContext.txType == EIP4844) {
+        pairs[nbPairs].item = "Blobs";
+    } else if (txContext.txType == EIP7702) {
+        pairs[nbPairs].item = "Authorizations";
+    } else {
+        return nbPairs;
+    }
+    pairs[nbPairs].value = strings.common.listCount;
+    return nbPairs + 1;
+}
+
 static uint8_t setTagValuePairs(void) {
     uint8_t nbPairs = 0;
     uint8_t pairIndex = 0;
@@ -106,7 +124,8 @@ static uint8_t setTagValuePairs(void) {
             nbPairs++;
             LEDGER_ASSERT((++counter < MAX_PLUGIN_ITEMS), "Too many items for plugin\n");
         }
-        // for the last 1 (or 2), tags are fixed
+        // for the last ones, tags are fixed
+        nbPairs = setTxListPairs(nbPairs);
         if (tx_approval_context.displayNetwork) {
             pairs[nbPairs].item = "Network";
             pairs[nbPairs].value = strings.common.network_name;
@@ -137,6 +156,7 @@ static uint8_t setTagValuePairs(void) {
 #ifdef HAVE_DOMAIN_NAME
         }
 #endif
+        nbPairs = setTxListPairs(nbPairs);
         if (N_storage.displayNonce) {
             pairs[nbPairs].item = "Nonce";
             pairs[nbPairs].value = strings.common.nonce;
@@ -1,6 +1,7 @@
 #include "common_ui.h"
 #include "ui_nbgl.h"
 #include "nbgl_use_case.h"
+#include "token_store.h"
 
 // settings info definition
 #define SETTING_INFO_NB 2
@@ -16,7 +17,10 @@ enum {
     EIP712_VERBOSE_TOKEN,
 #endif
 #ifdef HAVE_DOMAIN_NAME
-    DOMAIN_NAME_VERBOSE_TOKEN
+    DOMAIN_NAME_VERBOSE_TOKEN,
+#endif
+#ifdef HAVE_TOKEN_STORE
+    TOKEN_STORE_TOKEN,
 #endif
 };
 
@@ -29,6 +33,9 @@ enum {
 #endif
 #ifdef HAVE_DOMAIN_NAME
     DOMAIN_NAME_VERBOSE_ID,
+#endif
+#ifdef HAVE_TOKEN_STORE
+    TOKEN_STORE_ID,
 #endif
     SETTINGS_SWITCHES_NB
 };
@@ -80,6 +87,17 @@ static void controlsCallback(int token, uint8_t index, int page) {
             nvm_write((void*) &N_storage.verbose_domain_name, (void*) &value, sizeof(uint8_t));
             break;
 #endif  // HAVE_DOMAIN_NAME
+#ifdef HAVE_TOKEN_STORE
+        case TOKEN_STORE_TOKEN:
+            value = (N_storage.tokenStore ? 0 : 1);
+            switches[TOKEN_STORE_ID].initState = (nbgl_state_t) value;
+            // turning it off forgets the tokens
+            if (!value) {
+                token_store_clear();
+            }
+            nvm_write((void*) &N_storage.tokenStore, (void*) &value, sizeof(uint8_t));
+            break;
+#endif  // HAVE_TOKEN_STORE
     }
 }
 
@@ -119,6 +137,14 @@ void ui_menu_settings(void) {
     switches[DOMAIN_NAME_VERBOSE_ID].tuneId = TUNE_TAP_CASUAL;
 #endif  // HAVE_DOMAIN_NAME
 
+#ifdef HAVE_TOKEN_STORE
+    switches[TOKEN_STORE_ID].initState = N_storage.tokenStore ? ON_STATE : OFF_STATE;
+    switches[TOKEN_STORE_ID].text = "Remember tokens";
+    switches[TOKEN_STORE_ID].subText = "Keep verified tokens\nacross sessions";
+    switches[TOKEN_STORE_ID].token = TOKEN_STORE_TOKEN;
+    switches[TOKEN_STORE_ID].tuneId = TUNE_TAP_CASUAL;
+#endif  // HAVE_TOKEN_STORE
+
     contents[0].type = SWITCHES_LIST;
     contents[0].content.switchesList.nbSwitches = SETTINGS_SWITCHES_NB;
     contents[0].content.switchesList.switches = switches;
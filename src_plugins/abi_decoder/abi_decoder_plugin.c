@@ -0,0 +1,309 @@
+#ifdef HAVE_ABI_DESCRIPTOR
+
+#include <string.h>
+#include "abi_decoder_plugin.h"
+#include "eth_plugin_internal.h"
+#include "eth_plugin_handler.h"
+#include "network.h"
+
+abi_decoder_context_t g_abi_decoder;
+
+static const abi_param_t *get_param(uint8_t index) {
+    return &g_abi_descriptor.params[index];
+}
+
+static abi_value_t *new_value(uint8_t param, uint8_t item) {
+    abi_value_t *value;
+
+    if (g_abi_decoder.values_count == ABI_MAX_VALUES) {
+        PRINTF("Too many values to display\n");
+        return NULL;
+    }
+    value = &g_abi_decoder.values[g_abi_decoder.values_count++];
+    memset(value, 0, sizeof(*value));
+    value->param = param;
+    value->item = item;
+    return value;
+}
+
+/**
+ * Decode a value of a static type, only accepting its canonical encoding
+ *
+ * @param[in] param_index index of the parameter
+ * @param[in] item index in the array, 0 if the parameter is not an array
+ * @param[in] word the encoded value
+ * @return whether it was successful
+ */
+static bool decode_static(uint8_t param_index, uint8_t item, const uint8_t *word) {
+    const abi_param_t *param = get_param(param_index);
+    abi_value_t *value;
+    bool valid;
+
+    switch (param->type & ~ABI_TYPE_ARRAY_FLAG) {
+        case ABI_TYPE_ADDRESS:
+            valid = allzeroes(word, INT256_LENGTH - ADDRESS_LENGTH);
+            break;
+        case ABI_TYPE_UINT:
+            valid = allzeroes(word, INT256_LENGTH - param->width);
+            break;
+        case ABI_TYPE_INT:
+            // sign extension of the M bits
+            valid = true;
+            for (uint8_t i = 0; valid && (i < (INT256_LENGTH - param->width)); i++) {
+                valid = (word[i] == ((word[INT256_LENGTH - param->width] & 0x80) ? 0xff : 0x00));
+            }
+            break;
+        case ABI_TYPE_BOOL:
+            valid = allzeroes(word, INT256_LENGTH - 1) && (word[INT256_LENGTH - 1] <= 1);
+            break;
+        case ABI_TYPE_FIXED_BYTES:
+            valid = allzeroes(word + param->size, INT256_LENGTH - param->size);
+            break;
+        default:
+            valid = true;
+            break;
+    }
+    if (!valid) {
+        PRINTF("Invalid value for parameter %d: %.*H\n", param_index, INT256_LENGTH, word);
+        return false;
+    }
+    if ((value = new_value(param_index, item)) == NULL) {
+        return false;
+    }
+    memcpy(value->data, word, INT256_LENGTH);
+    return true;
+}
+
+static bool decode_head(uint8_t param_index, const uint8_t *word) {
+    if (!abi_param_is_dynamic(get_param(param_index))) {
+        return decode_static(param_index, 0, word);
+    }
+    return U4BE_from_parameter(word, &g_abi_decoder.tail_offsets[param_index]);
+}
+
+/**
+ * Start decoding the next dynamic parameter
+ *
+ * Only the canonical encoding is accepted, the parameters being encoded right after the head, in
+ * their order.
+ *
+ * @param[in] offset offset of the word, relative to the first parameter
+ * @param[in] word the length of the parameter
+ * @return whether it was successful
+ */
+static bool start_tail(uint32_t offset, const uint8_t *word) {
+    abi_decoder_context_t *context = &g_abi_decoder;
+    const abi_param_t *param;
+    uint32_t length;
+
+    while ((context->next_tail < g_abi_descriptor.params_count) &&
+           !abi_param_is_dynamic(get_param(context->next_tail))) {
+        context->next_tail += 1;
+    }
+    if (context->next_tail == g_abi_descriptor.params_count) {
+        PRINTF("Unexpected data at offset %d\n", offset);
+        return false;
+    }
+    if (context->tail_offsets[context->next_tail] != offset) {
+        PRINTF("Parameter %d expected at offset %d, not %d\n",
+               context->next_tail,
+               context->tail_offsets[context->next_tail],
+               offset);
+        return false;
+    }
+    if (!U4BE_from_parameter(word, &length)) {
+        return false;
+    }
+    param = get_param(context->next_tail);
+    if (param->type & ABI_TYPE_ARRAY_FLAG) {
+        context->tail_words = length;
+    } else {
+        abi_value_t *value = new_value(context->next_tail, 0);
+
+        if (value == NULL) {
+            return false;
+        }
+        value->length = length;
+        context->tail_words = (length + INT256_LENGTH - 1) / INT256_LENGTH;
+    }
+    // the decoded values are bounded, but not the skipped bytes
+    if (context->tail_words > ((context->data_size - offset) / INT256_LENGTH - 1)) {
+        PRINTF("Parameter %d longer than the calldata\n", context->next_tail);
+        return false;
+    }
+    context->tail_length = length;
+    if (context->tail_words != 0) {
+        context->tail_param = context->next_tail;
+    }
+    context->next_tail += 1;
+    return true;
+}
+
+static bool decode_tail(const uint8_t *word) {
+    abi_decoder_context_t *context = &g_abi_decoder;
+    const abi_param_t *param = get_param(context->tail_param);
+
+    if (param->type & ABI_TYPE_ARRAY_FLAG) {
+        uint32_t item = context->tail_length - context->tail_words;
+
+        // more items than values anyway
+        if (item >= ABI_MAX_VALUES) {
+            PRINTF("Too many values to display\n");
+            return false;
+        }
+        if (!decode_static(context->tail_param, item, word)) {
+            return false;
+        }
+    } else {
+        // the value of a bytes or string is the last one, its tail being decoded
+        abi_value_t *value = &context->values[context->values_count - 1];
+        uint32_t total_words = (value->length + INT256_LENGTH - 1) / INT256_LENGTH;
+        uint32_t consumed = (total_words - context->tail_words) * INT256_LENGTH;
+
+        if (consumed == 0) {
+            memcpy(value->data, word, MIN(value->length, INT256_LENGTH));
+        }
+        if ((context->tail_words == 1) &&
+            !allzeroes(word + (value->length - consumed),
+                       INT256_LENGTH - (value->length - consumed))) {
+            PRINTF("Invalid padding of parameter %d\n", context->tail_param);
+            return false;
+        }
+    }
+    if (--context->tail_words == 0) {
+        context->tail_param = ABI_NO_TAIL;
+    }
+    return true;
+}
+
+/**
+ * Decode a word of the calldata
+ *
+ * @param[in] parameter_offset offset of the word in the calldata
+ * @param[in] word the word
+ * @return whether it was successful
+ */
+static bool decode_word(uint32_t parameter_offset, const uint8_t *word) {
+    uint32_t offset = parameter_offset - SELECTOR_SIZE;
+
+    if ((offset / INT256_LENGTH) < g_abi_descriptor.params_count) {
+        return decode_head(offset / INT256_LENGTH, word);
+    }
+    if (g_abi_decoder.tail_param == ABI_NO_TAIL) {
+        return start_tail(offset, word);
+    }
+    return decode_tail(word);
+}
+
+/**
+ * Sort the values in the order of the parameters
+ *
+ * The static parameters are decoded before the dynamic ones, whatever their order. Insertion sort,
+ * stable to keep the array items in order.
+ */
+static void sort_values(void) {
+    abi_value_t *values = g_abi_decoder.values;
+
+    for (uint8_t i = 1; i < g_abi_decoder.values_count; i++) {
+        abi_value_t value = values[i];
+        uint8_t j = i;
+
+        for (; (j > 0) && (values[j - 1].param > value.param); j--) {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+}
+
+static void handle_init_contract(ethPluginInitContract_t *msg) {
+    abi_decoder_context_t *context = &g_abi_decoder;
+
+    memset(context, 0, sizeof(*context));
+    context->tail_param = ABI_NO_TAIL;
+    context->data_size = msg->dataSize - SELECTOR_SIZE;
+    if (((context->data_size % INT256_LENGTH) != 0) ||
+        (context->data_size < (g_abi_descriptor.params_count * INT256_LENGTH))) {
+        PRINTF("Calldata size %d does not match the ABI descriptor\n", msg->dataSize);
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+        return;
+    }
+    ((ethPluginInitContractExt_t *) msg)->capabilities |= ETH_PLUGIN_CAPABILITY_BATCH_PARAMETERS;
+    msg->result = ETH_PLUGIN_RESULT_OK;
+}
+
+static void handle_provide_parameters(ethPluginProvideParameters_t *msg) {
+    msg->base.result = ETH_PLUGIN_RESULT_OK;
+    for (uint16_t i = 0; i < msg->count; i++) {
+        if (!decode_word(msg->base.parameterOffset + i * INT256_LENGTH,
+                         msg->base.parameter + i * INT256_LENGTH)) {
+            msg->base.result = ETH_PLUGIN_RESULT_ERROR;
+            break;
+        }
+    }
+}
+
+static void handle_finalize(ethPluginFinalize_t *msg) {
+    abi_decoder_context_t *context = &g_abi_decoder;
+
+    while ((context->next_tail < g_abi_descriptor.params_count) &&
+           !abi_param_is_dynamic(get_param(context->next_tail))) {
+        context->next_tail += 1;
+    }
+    if ((context->tail_param != ABI_NO_TAIL) ||
+        (context->next_tail != g_abi_descriptor.params_count)) {
+        PRINTF("Truncated calldata\n");
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+        return;
+    }
+    // only known once the whole transaction has been parsed
+    if (get_tx_chain_id() != g_abi_descriptor.chain_id) {
+        PRINTF("ABI descriptor chain ID mismatch\n");
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+        return;
+    }
+    sort_values();
+    msg->tokenLookup1 = NULL;
+    msg->tokenLookup2 = NULL;
+    msg->numScreens = context->values_count;
+    // payable method
+    if (!allzeroes(msg->pluginSharedRO->txContent->value.value,
+                   msg->pluginSharedRO->txContent->value.length)) {
+        msg->numScreens += 1;
+    }
+    msg->uiType = ETH_UI_TYPE_GENERIC;
+    msg->result = ETH_PLUGIN_RESULT_OK;
+}
+
+static void handle_query_contract_id(ethQueryContractID_t *msg) {
+    strlcpy(msg->name, g_abi_descriptor.name, msg->nameLength);
+    strlcpy(msg->version, g_abi_descriptor.method, msg->versionLength);
+    msg->result = ETH_PLUGIN_RESULT_OK;
+}
+
+void abi_decoder_plugin_call(int message, void *parameters) {
+    switch (message) {
+        case ETH_PLUGIN_INIT_CONTRACT:
+            handle_init_contract((ethPluginInitContract_t *) parameters);
+            break;
+        case ETH_PLUGIN_PROVIDE_PARAMETER:
+            handle_provide_parameters((ethPluginProvideParameters_t *) parameters);
+            break;
+        case ETH_PLUGIN_FINALIZE:
+            handle_finalize((ethPluginFinalize_t *) parameters);
+            break;
+        case ETH_PLUGIN_PROVIDE_INFO:
+            ((ethPluginProvideInfo_t *) parameters)->result = ETH_PLUGIN_RESULT_OK;
+            break;
+        case ETH_PLUGIN_QUERY_CONTRACT_ID:
+            handle_query_contract_id((ethQueryContractID_t *) parameters);
+            break;
+        case ETH_PLUGIN_QUERY_CONTRACT_UI:
+            handle_query_contract_ui_abi(parameters);
+            break;
+        default:
+            PRINTF("Unhandled message %d\n", message);
+            break;
+    }
+}
+
+#endif  // HAVE_ABI_DESCRIPTOR
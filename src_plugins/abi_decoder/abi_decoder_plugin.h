@@ -0,0 +1,46 @@
+#ifndef _ABI_DECODER_PLUGIN_H_
+#define _ABI_DECODER_PLUGIN_H_
+
+#ifdef HAVE_ABI_DESCRIPTOR
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "abi_descriptor.h"
+
+// Internal plugin decoding the calldata of the method described by the last provided ABI
+// descriptor, as it is received
+
+#define ABI_MAX_VALUES 12
+
+// No dynamic parameter being decoded
+#define ABI_NO_TAIL 0xff
+
+typedef struct {
+    uint32_t length;  // of the bytes or string, even if only the first bytes are kept
+    uint8_t param;
+    uint8_t item;  // index in the array
+    uint8_t data[INT256_LENGTH];
+} abi_value_t;
+
+typedef struct {
+    // offsets of the dynamic parameters, relative to the first parameter
+    uint32_t tail_offsets[ABI_MAX_PARAMS];
+    uint32_t data_size;
+    // dynamic parameter being decoded, its length and its words left
+    uint8_t tail_param;
+    uint32_t tail_length;
+    uint32_t tail_words;
+    // dynamic parameter to be decoded next
+    uint8_t next_tail;
+    uint8_t values_count;
+    abi_value_t values[ABI_MAX_VALUES];
+} abi_decoder_context_t;
+
+extern abi_decoder_context_t g_abi_decoder;
+
+void abi_decoder_plugin_call(int message, void *parameters);
+void handle_query_contract_ui_abi(void *parameters);
+
+#endif  // HAVE_ABI_DESCRIPTOR
+
+#endif  // _ABI_DECODER_PLUGIN_H_
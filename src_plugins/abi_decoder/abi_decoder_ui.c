@@ -0,0 +1,150 @@
+#ifdef HAVE_ABI_DESCRIPTOR
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "abi_decoder_plugin.h"
+#include "eth_plugin_internal.h"
+#include "eth_plugin_interface.h"
+#include "common_utils.h"
+#include "uint256.h"
+#include "format.h"
+
+#define ELLIPSIS "..."
+
+/**
+ * Format the first bytes of a value in hexadecimal, with an ellipsis if they do not all fit
+ *
+ * @param[in] data the bytes
+ * @param[in] length their number
+ * @param[in] truncated whether the value has more bytes than the ones given
+ * @param[out] out output buffer
+ * @param[in] out_size size of the output buffer
+ * @return whether it was successful
+ */
+static bool format_bytes(const uint8_t *data,
+                         size_t length,
+                         bool truncated,
+                         char *out,
+                         size_t out_size) {
+    size_t max;
+
+    if (out_size < (sizeof("0x") + sizeof(ELLIPSIS))) {
+        return false;
+    }
+    max = (out_size - sizeof("0x") - (sizeof(ELLIPSIS) - 1)) / 2;
+    if (length > max) {
+        length = max;
+        truncated = true;
+    }
+    strlcpy(out, "0x", out_size);
+    if (format_hex(data, length, out + 2, out_size - 2) < 0) {
+        return false;
+    }
+    if (truncated) {
+        strlcat(out, ELLIPSIS, out_size);
+    }
+    return true;
+}
+
+static bool format_string(const abi_value_t *value, char *out, size_t out_size) {
+    size_t length = MIN(value->length, sizeof(value->data));
+    bool truncated = (value->length > length);
+
+    for (size_t i = 0; i < length; i++) {
+        if (!isprint(value->data[i])) {
+            PRINTF("Non-printable string\n");
+            return false;
+        }
+    }
+    if ((length + 1) > out_size) {
+        length = out_size - sizeof(ELLIPSIS);
+        truncated = true;
+    }
+    memcpy(out, value->data, length);
+    out[length] = '\0';
+    if (truncated) {
+        strlcat(out, ELLIPSIS, out_size);
+    }
+    return true;
+}
+
+static bool format_value(const abi_value_t *value, char *out, size_t out_size) {
+    const abi_param_t *param = &g_abi_descriptor.params[value->param];
+    uint256_t number;
+
+    switch (param->type & ~ABI_TYPE_ARRAY_FLAG) {
+        case ABI_TYPE_ADDRESS:
+            return getEthDisplayableAddress(
+                (uint8_t *) value->data + INT256_LENGTH - ADDRESS_LENGTH,
+                out,
+                out_size,
+                chainConfig->chainId);
+        case ABI_TYPE_UINT:
+            if ((param->size != 0) || (param->unit[0] != '\0')) {
+                return amount_to_string(value->data,
+                                        sizeof(value->data),
+                                        param->size,
+                                        param->unit,
+                                        out,
+                                        out_size);
+            }
+            return uint256_to_decimal(value->data, sizeof(value->data), out, out_size);
+        case ABI_TYPE_INT:
+            convertUint256BE(value->data, sizeof(value->data), &number);
+            return tostring256_signed(&number, 10, out, out_size);
+        case ABI_TYPE_BOOL:
+            strlcpy(out, value->data[INT256_LENGTH - 1] ? "true" : "false", out_size);
+            return true;
+        case ABI_TYPE_FIXED_BYTES:
+            return format_bytes(value->data, param->size, false, out, out_size);
+        case ABI_TYPE_BYTES:
+            return format_bytes(value->data,
+                                MIN(value->length, sizeof(value->data)),
+                                value->length > sizeof(value->data),
+                                out,
+                                out_size);
+        case ABI_TYPE_STRING:
+            return format_string(value, out, out_size);
+        default:
+            return false;
+    }
+}
+
+void handle_query_contract_ui_abi(void *parameters) {
+    ethQueryContractUI_t *msg = (ethQueryContractUI_t *) parameters;
+    const abi_value_t *value;
+    const abi_param_t *param;
+
+    msg->result = ETH_PLUGIN_RESULT_OK;
+    if (msg->screenIndex == g_abi_decoder.values_count) {
+        // amount sent to a payable method
+        strlcpy(msg->title, "Amount", msg->titleLength);
+        if (!amount_to_string(msg->pluginSharedRO->txContent->value.value,
+                              msg->pluginSharedRO->txContent->value.length,
+                              WEI_TO_ETHER,
+                              msg->network_ticker,
+                              msg->msg,
+                              msg->msgLength)) {
+            msg->result = ETH_PLUGIN_RESULT_ERROR;
+        }
+        return;
+    }
+    if (msg->screenIndex > g_abi_decoder.values_count) {
+        PRINTF("Unsupported screen index %d\n", msg->screenIndex);
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+        return;
+    }
+    value = &g_abi_decoder.values[msg->screenIndex];
+    param = &g_abi_descriptor.params[value->param];
+    if (param->type & ABI_TYPE_ARRAY_FLAG) {
+        snprintf(msg->title, msg->titleLength, "%s [%d]", param->label, value->item);
+    } else {
+        strlcpy(msg->title, param->label, msg->titleLength);
+    }
+    if (!format_value(value, msg->msg, msg->msgLength)) {
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+    }
+}
+
+#endif  // HAVE_ABI_DESCRIPTOR
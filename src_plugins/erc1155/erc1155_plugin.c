@@ -5,6 +5,10 @@
 #include "plugin_utils.h"
 #include "eth_plugin_internal.h"
 #include "eth_plugin_handler.h"
+#ifdef HAVE_MULTICALL
+#include "multicall_plugin.h"
+_Static_assert(sizeof(erc1155_context_t) <= MULTICALL_CONTEXT_SIZE, "ERC-1155 context too large");
+#endif  // HAVE_MULTICALL
 
 static const uint8_t ERC1155_APPROVE_FOR_ALL_SELECTOR[SELECTOR_SIZE] = {0xa2, 0x2c, 0xb4, 0x65};
 static const uint8_t ERC1155_SAFE_TRANSFER_SELECTOR[SELECTOR_SIZE] = {0xf2, 0x42, 0x43, 0x2a};
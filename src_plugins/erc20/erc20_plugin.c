@@ -5,6 +5,7 @@
 #include "plugin_utils.h"
 #include "ethUstream.h"
 #include "common_utils.h"
+#include "uint256.h"
 
 typedef enum { ERC20_TRANSFER = 0, ERC20_APPROVE } erc20Selector_t;
 
@@ -22,6 +23,11 @@ typedef struct erc20_parameters_t {
     char contract_name[MAX_CONTRACT_NAME_LEN];
 } erc20_parameters_t;
 
+#ifdef HAVE_MULTICALL
+#include "multicall_plugin.h"
+_Static_assert(sizeof(erc20_parameters_t) <= MULTICALL_CONTEXT_SIZE, "ERC-20 context too large");
+#endif  // HAVE_MULTICALL
+
 typedef struct contract_t {
     char name[MAX_CONTRACT_NAME_LEN];
     uint8_t address[ADDRESS_LENGTH];
@@ -73,6 +79,23 @@ bool check_contract(erc20_parameters_t *context) {
     return false;
 }
 
+static eth_plugin_result_t handle_parameter(erc20_parameters_t *context,
+                                            uint32_t offset,
+                                            const uint8_t *parameter) {
+    PRINTF("erc20 plugin provide parameter %d %.*H\n", offset, 32, parameter);
+    switch (offset) {
+        case 4:
+            memmove(context->destinationAddress, parameter + 12, 20);
+            return ETH_PLUGIN_RESULT_OK;
+        case 4 + 32:
+            memmove(context->amount, parameter, 32);
+            return ETH_PLUGIN_RESULT_OK;
+        default:
+            PRINTF("Unhandled parameter offset\n");
+            return ETH_PLUGIN_RESULT_ERROR;
+    }
+}
+
 void erc20_plugin_call(int message, void *parameters) {
     switch (message) {
         case ETH_PLUGIN_INIT_CONTRACT: {
@@ -97,30 +120,21 @@ void erc20_plugin_call(int message, void *parameters) {
                     break;
                 }
                 PRINTF("erc20 plugin init\n");
+                ((ethPluginInitContractExt_t *) msg)->capabilities |=
+                    ETH_PLUGIN_CAPABILITY_BATCH_PARAMETERS;
                 msg->result = ETH_PLUGIN_RESULT_OK;
             }
         } break;
 
         case ETH_PLUGIN_PROVIDE_PARAMETER: {
-            ethPluginProvideParameter_t *msg = (ethPluginProvideParameter_t *) parameters;
-            erc20_parameters_t *context = (erc20_parameters_t *) msg->pluginContext;
-            PRINTF("erc20 plugin provide parameter %d %.*H\n",
-                   msg->parameterOffset,
-                   32,
-                   msg->parameter);
-            switch (msg->parameterOffset) {
-                case 4:
-                    memmove(context->destinationAddress, msg->parameter + 12, 20);
-                    msg->result = ETH_PLUGIN_RESULT_OK;
-                    break;
-                case 4 + 32:
-                    memmove(context->amount, msg->parameter, 32);
-                    msg->result = ETH_PLUGIN_RESULT_OK;
-                    break;
-                default:
-                    PRINTF("Unhandled parameter offset\n");
-                    msg->result = ETH_PLUGIN_RESULT_ERROR;
-                    break;
+            ethPluginProvideParameters_t *msg = (ethPluginProvideParameters_t *) parameters;
+            erc20_parameters_t *context = (erc20_parameters_t *) msg->base.pluginContext;
+            msg->base.result = ETH_PLUGIN_RESULT_OK;
+            for (uint16_t i = 0; (i < msg->count) && (msg->base.result == ETH_PLUGIN_RESULT_OK);
+                 i++) {
+                msg->base.result = handle_parameter(context,
+                                                    msg->base.parameterOffset + i * 32,
+                                                    msg->base.parameter + i * 32);
             }
         } break;
 
@@ -184,12 +198,12 @@ void erc20_plugin_call(int message, void *parameters) {
                         strlcpy(msg->msg, "Unlimited ", msg->msgLength);
                         strlcat(msg->msg, context->ticker, msg->msgLength);
                     } else {
-                        if (!amountToString(context->amount,
-                                            sizeof(context->amount),
-                                            context->decimals,
-                                            context->ticker,
-                                            msg->msg,
-                                            100)) {
+                        if (!amount_to_string(context->amount,
+                                              sizeof(context->amount),
+                                              context->decimals,
+                                              context->ticker,
+                                              msg->msg,
+                                              msg->msgLength)) {
                             THROW(EXCEPTION_OVERFLOW);
                         }
                     }
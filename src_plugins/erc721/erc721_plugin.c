@@ -6,6 +6,10 @@
 #include "eth_plugin_internal.h"
 #include "eth_plugin_interface.h"
 #include "eth_plugin_handler.h"
+#ifdef HAVE_MULTICALL
+#include "multicall_plugin.h"
+_Static_assert(sizeof(erc721_context_t) <= MULTICALL_CONTEXT_SIZE, "ERC-721 context too large");
+#endif  // HAVE_MULTICALL
 
 static const uint8_t ERC721_APPROVE_SELECTOR[SELECTOR_SIZE] = {0x09, 0x5e, 0xa7, 0xb3};
 static const uint8_t ERC721_APPROVE_FOR_ALL_SELECTOR[SELECTOR_SIZE] = {0xa2, 0x2c, 0xb4, 0x65};
@@ -5,6 +5,7 @@
 #include "eth_plugin_handler.h"
 #include "shared_context.h"
 #include "common_utils.h"
+#include "uint256.h"
 
 void getEth2PublicKey(uint32_t *bip32Path, uint8_t bip32PathLength, uint8_t *out);
 
@@ -201,12 +202,12 @@ void eth2_plugin_call(int message, void *parameters) {
                     uint8_t decimals = WEI_TO_ETHER;
                     const char *ticker = chainConfig->coinName;
                     strlcpy(msg->title, "Amount", msg->titleLength);
-                    if (!amountToString(tmpContent.txContent.value.value,
-                                        tmpContent.txContent.value.length,
-                                        decimals,
-                                        ticker,
-                                        msg->msg,
-                                        100)) {
+                    if (!amount_to_string(tmpContent.txContent.value.value,
+                                          tmpContent.txContent.value.length,
+                                          decimals,
+                                          ticker,
+                                          msg->msg,
+                                          msg->msgLength)) {
                         THROW(EXCEPTION_OVERFLOW);
                     }
                     msg->result = ETH_PLUGIN_RESULT_OK;
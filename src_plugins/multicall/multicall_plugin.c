@@ -0,0 +1,703 @@
+#ifdef HAVE_MULTICALL
+
+#include <string.h>
+#include "multicall_plugin.h"
+#include "eth_plugin_internal.h"
+#include "eth_plugin_handler.h"
+#include "manage_asset_info.h"
+#include "plugin_utils.h"
+#include "common_utils.h"
+
+multicall_context_t g_multicall;
+
+typedef enum {
+    ARGS_HEAD,
+    ARGS_LENGTH,
+    ARGS_OFFSETS,
+    ARGS_ELEMENT_LENGTH,
+    ARGS_ELEMENT,
+    ARGS_PADDING,
+    ARGS_DONE,
+} multicall_args_state_t;
+
+typedef enum {
+    PACKED_OPERATION,
+    PACKED_TO,
+    PACKED_VALUE,
+    PACKED_DATA_LENGTH,
+    PACKED_CALL,
+} multicall_packed_state_t;
+
+typedef enum {
+    CALL_SELECTOR,
+    CALL_DATA,
+} multicall_call_state_t;
+
+// Safe multiSend operation of a plain call, the delegate calls are not decoded
+#define MULTISEND_OPERATION_CALL 0
+
+#define PACKED_OPERATION_SIZE 1
+
+// Words in the head of the parameters of each method, and index of the batch in it
+static const uint8_t HEAD_WORDS[MULTICALL_METHODS_COUNT] = {1, 2, 1};
+static const uint8_t BATCH_PARAM[MULTICALL_METHODS_COUNT] = {0, 1, 0};
+
+_Static_assert(NUM_MULTICALL_SELECTORS == MULTICALL_METHODS_COUNT, "Multicall methods mismatch");
+
+static void decode_field(void);
+
+static multicall_frame_t *get_frame(void) {
+    return &g_multicall.frames[g_multicall.depth - 1];
+}
+
+static void fail(const char *reason) {
+    PRINTF("Multicall fallback: %s\n", reason);
+    g_multicall.fallback = true;
+    g_multicall.fieldSize = 0;
+}
+
+/**
+ * Expect the next field of the current frame
+ *
+ * @param[in] size its size, a field never spanning several frames
+ */
+static void expect(uint32_t size) {
+    if (size > (get_frame()->end - g_multicall.pos)) {
+        fail("Field out of its frame");
+        return;
+    }
+    g_multicall.fieldSize = size;
+    g_multicall.fieldFill = 0;
+}
+
+static int find_method(const uint8_t *selector) {
+    for (int i = 0; i < NUM_MULTICALL_SELECTORS; i++) {
+        if (memcmp(PIC(MULTICALL_SELECTORS[i]), selector, SELECTOR_SIZE) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool multicall_call_message(multicall_call_t *call, int message, void *parameters) {
+    ethPluginSharedRW_t pluginRW;
+    ethPluginSharedRO_t pluginRO;
+    txContent_t *txContent = &g_multicall.txContent;
+
+    // the plugin sees the call as a transaction of its own
+    memcpy(txContent, &tmpContent.txContent, sizeof(*txContent));
+    memcpy(txContent->destination, call->target, ADDRESS_LENGTH);
+    txContent->destinationLength = ADDRESS_LENGTH;
+    memcpy(txContent->value.value, call->value, INT256_LENGTH);
+    txContent->value.length = INT256_LENGTH;
+    pluginRW.sha3 = &global_sha3;
+    pluginRO.txContent = txContent;
+
+    switch (message) {
+        case ETH_PLUGIN_INIT_CONTRACT:
+            ((ethPluginInitContract_t *) parameters)->interfaceVersion =
+                ETH_PLUGIN_INTERFACE_VERSION_LATEST;
+            ((ethPluginInitContract_t *) parameters)->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
+            ((ethPluginInitContract_t *) parameters)->pluginSharedRW = &pluginRW;
+            ((ethPluginInitContract_t *) parameters)->pluginSharedRO = &pluginRO;
+            ((ethPluginInitContract_t *) parameters)->pluginContext = call->context;
+            ((ethPluginInitContract_t *) parameters)->pluginContextLength = sizeof(call->context);
+            break;
+        case ETH_PLUGIN_PROVIDE_PARAMETER:
+            ((ethPluginProvideParameter_t *) parameters)->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
+            ((ethPluginProvideParameter_t *) parameters)->pluginSharedRW = &pluginRW;
+            ((ethPluginProvideParameter_t *) parameters)->pluginSharedRO = &pluginRO;
+            ((ethPluginProvideParameter_t *) parameters)->pluginContext = call->context;
+            break;
+        case ETH_PLUGIN_FINALIZE:
+            ((ethPluginFinalize_t *) parameters)->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
+            ((ethPluginFinalize_t *) parameters)->pluginSharedRW = &pluginRW;
+            ((ethPluginFinalize_t *) parameters)->pluginSharedRO = &pluginRO;
+            ((ethPluginFinalize_t *) parameters)->pluginContext = call->context;
+            break;
+        case ETH_PLUGIN_PROVIDE_INFO:
+            ((ethPluginProvideInfo_t *) parameters)->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
+            ((ethPluginProvideInfo_t *) parameters)->pluginSharedRW = &pluginRW;
+            ((ethPluginProvideInfo_t *) parameters)->pluginSharedRO = &pluginRO;
+            ((ethPluginProvideInfo_t *) parameters)->pluginContext = call->context;
+            break;
+        case ETH_PLUGIN_QUERY_CONTRACT_UI:
+            ((ethQueryContractUI_t *) parameters)->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
+            ((ethQueryContractUI_t *) parameters)->pluginSharedRW = &pluginRW;
+            ((ethQueryContractUI_t *) parameters)->pluginSharedRO = &pluginRO;
+            ((ethQueryContractUI_t *) parameters)->pluginContext = call->context;
+            break;
+        default:
+            PRINTF("Unsupported call message %d\n", message);
+            return false;
+    }
+
+    switch (call->plugin) {
+        case CALL_PLUGIN_ERC20:
+            erc20_plugin_call(message, parameters);
+            break;
+#ifdef HAVE_NFT_SUPPORT
+        case CALL_PLUGIN_ERC721:
+            erc721_plugin_call(message, parameters);
+            break;
+        case CALL_PLUGIN_ERC1155:
+            erc1155_plugin_call(message, parameters);
+            break;
+#endif  // HAVE_NFT_SUPPORT
+        default:
+            return false;
+    }
+    return true;
+}
+
+static bool init_call(multicall_call_t *call, uint8_t plugin, ethPluginInitContractExt_t *init) {
+    memset(call->context, 0, sizeof(call->context));
+    call->plugin = plugin;
+    return multicall_call_message(call, ETH_PLUGIN_INIT_CONTRACT, init) &&
+           (init->base.result == ETH_PLUGIN_RESULT_OK);
+}
+
+static bool is_erc20_selector(const uint8_t *selector) {
+    for (size_t i = 0; i < NUM_ERC20_SELECTORS; i++) {
+        if (memcmp(PIC(ERC20_SELECTORS[i]), selector, SELECTOR_SIZE) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Start decoding a call with the internal plugin handling its selector
+ *
+ * ERC-20 first, its approve selector being also the ERC-721 one. The NFT plugins are only tried on
+ * a contract with a known NFT description, which their screens need.
+ *
+ * @param[in] frame frame of the call
+ * @param[in] selector the selector of the call
+ * @return whether a plugin handles it
+ */
+static bool start_call(const multicall_frame_t *frame, const uint8_t *selector) {
+    multicall_call_t *call = &g_multicall.calls[g_multicall.callsCount];
+    ethPluginInitContractExt_t init;
+    bool started = false;
+
+    eth_plugin_prepare_init(&init, selector, frame->end - frame->start);
+    if (is_erc20_selector(selector)) {
+        started = init_call(call, CALL_PLUGIN_ERC20, &init);
+    }
+#ifdef HAVE_NFT_SUPPORT
+    else if (get_asset_info_by_addr(call->target) != NULL) {
+        started = init_call(call, CALL_PLUGIN_ERC721, &init) ||
+                  init_call(call, CALL_PLUGIN_ERC1155, &init);
+    }
+#endif  // HAVE_NFT_SUPPORT
+    if (!started) {
+        PRINTF("No plugin for the call %.*H\n", SELECTOR_SIZE, selector);
+        return false;
+    }
+    g_multicall.callsCount += 1;
+    return true;
+}
+
+static bool finish_call(void) {
+    multicall_call_t *call = &g_multicall.calls[g_multicall.callsCount - 1];
+    ethPluginFinalize_t finalize;
+    ethPluginProvideInfo_t provideInfo;
+
+    eth_plugin_prepare_finalize(&finalize);
+    if (!multicall_call_message(call, ETH_PLUGIN_FINALIZE, &finalize) ||
+        (finalize.result != ETH_PLUGIN_RESULT_OK)) {
+        return false;
+    }
+    eth_plugin_prepare_provide_info(&provideInfo);
+    if ((finalize.tokenLookup1 != NULL) || (finalize.tokenLookup2 != NULL)) {
+        if (finalize.tokenLookup1 != NULL) {
+            provideInfo.item1 = get_asset_info_by_addr(finalize.tokenLookup1);
+        }
+        if (finalize.tokenLookup2 != NULL) {
+            provideInfo.item2 = get_asset_info_by_addr(finalize.tokenLookup2);
+        }
+        // a fallback would show the call data
+        if (!multicall_call_message(call, ETH_PLUGIN_PROVIDE_INFO, &provideInfo) ||
+            (provideInfo.result != ETH_PLUGIN_RESULT_OK)) {
+            return false;
+        }
+    }
+    call->uiType = finalize.uiType;
+    switch (finalize.uiType) {
+        case ETH_UI_TYPE_GENERIC:
+            call->numScreens = finalize.numScreens + provideInfo.additionalScreens;
+            break;
+        case ETH_UI_TYPE_AMOUNT_ADDRESS:
+            // kept as offsets, the pointers are only valid in the context of the call
+            if ((finalize.amount < call->context) ||
+                ((finalize.amount + INT256_LENGTH) > (call->context + sizeof(call->context))) ||
+                (finalize.address < call->context) ||
+                ((finalize.address + ADDRESS_LENGTH) > (call->context + sizeof(call->context)))) {
+                PRINTF("Amount/address out of the call context\n");
+                return false;
+            }
+            call->amountOffset = finalize.amount - call->context;
+            call->addressOffset = finalize.address - call->context;
+            call->numScreens = 2;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Enter a new frame, starting at the current position
+ *
+ * @param[in] kind kind of the frame
+ * @param[in] length its length
+ * @param[in] target target of its calls
+ */
+static void push_frame(multicall_frame_kind_t kind, uint32_t length, const uint8_t *target) {
+    multicall_frame_t *frame;
+
+    if (g_multicall.depth == MULTICALL_MAX_DEPTH) {
+        fail("Too deeply nested");
+        return;
+    }
+    frame = &g_multicall.frames[g_multicall.depth++];
+    memset(frame, 0, sizeof(*frame));
+    frame->kind = kind;
+    frame->start = g_multicall.pos;
+    frame->end = g_multicall.pos + length;
+    memmove(frame->target, target, ADDRESS_LENGTH);
+    switch (kind) {
+        case FRAME_ARGS:
+            frame->state = ARGS_HEAD;
+            expect(INT256_LENGTH);
+            break;
+        case FRAME_PACKED:
+            frame->state = PACKED_OPERATION;
+            expect(PACKED_OPERATION_SIZE);
+            break;
+        case FRAME_CALL:
+            frame->state = CALL_SELECTOR;
+            expect(SELECTOR_SIZE);
+            break;
+    }
+}
+
+static void expect_element(multicall_frame_t *frame) {
+    // only the canonical encoding, each element right after the previous one
+    if (g_multicall.pos != (frame->base + frame->offsets[frame->item])) {
+        fail("Unexpected element offset");
+        return;
+    }
+    frame->state = ARGS_ELEMENT_LENGTH;
+    expect(INT256_LENGTH);
+}
+
+static void close_frame(void);
+
+static void next_element(multicall_frame_t *frame) {
+    if (frame->method == MULTICALL_MULTISEND) {
+        frame->state = ARGS_DONE;
+        close_frame();
+    } else if (++frame->item < frame->items) {
+        expect_element(frame);
+    } else {
+        frame->state = ARGS_DONE;
+        close_frame();
+    }
+}
+
+/**
+ * Resume a frame once a frame in it has been closed
+ *
+ * @param[in] frame the frame
+ */
+static void resume_frame(multicall_frame_t *frame) {
+    uint32_t padding;
+
+    switch (frame->kind) {
+        case FRAME_ARGS:
+            padding = (INT256_LENGTH - (frame->length % INT256_LENGTH)) % INT256_LENGTH;
+            if (padding == 0) {
+                next_element(frame);
+            } else {
+                frame->state = ARGS_PADDING;
+                expect(padding);
+            }
+            break;
+        case FRAME_PACKED:
+            if (g_multicall.pos == frame->end) {
+                close_frame();
+            } else {
+                frame->state = PACKED_OPERATION;
+                expect(PACKED_OPERATION_SIZE);
+            }
+            break;
+        default:
+            fail("Unexpected frame");
+            break;
+    }
+}
+
+static void close_frame(void) {
+    if (g_multicall.pos != get_frame()->end) {
+        fail("Trailing data");
+        return;
+    }
+    g_multicall.depth -= 1;
+    g_multicall.fieldSize = 0;
+    if (g_multicall.depth > 0) {
+        resume_frame(get_frame());
+    }
+}
+
+/**
+ * Start a call, or a nested batch, of the given length in the current frame
+ *
+ * @param[in] length its length
+ * @param[in] target its target
+ */
+static void enter_call(uint32_t length, const uint8_t *target) {
+    multicall_call_t *call;
+
+    if (length > (get_frame()->end - g_multicall.pos)) {
+        fail("Call out of its frame");
+        return;
+    }
+    if (g_multicall.callsCount == MULTICALL_MAX_CALLS) {
+        fail("Too many calls");
+        return;
+    }
+    call = &g_multicall.calls[g_multicall.callsCount];
+    memset(call, 0, sizeof(*call));
+    memmove(call->target, target, ADDRESS_LENGTH);
+    memmove(call->value, g_multicall.value, INT256_LENGTH);
+    memset(g_multicall.value, 0, sizeof(g_multicall.value));
+    if (length == 0) {
+        // plain transfer, only in the transactions of a multiSend
+        if (get_frame()->kind != FRAME_PACKED) {
+            fail("Empty call");
+            return;
+        }
+        call->plugin = CALL_PLUGIN_NONE;
+        call->numScreens = 1;
+        g_multicall.callsCount += 1;
+        resume_frame(get_frame());
+        return;
+    }
+    push_frame(FRAME_CALL, length, target);
+}
+
+static void decode_args_field(multicall_frame_t *frame, const uint8_t *field) {
+    uint32_t value;
+
+    if ((frame->state != ARGS_PADDING) && !U4BE_from_parameter(field, &value)) {
+        fail("Invalid integer");
+        return;
+    }
+    switch (frame->state) {
+        case ARGS_HEAD:
+            if ((frame->item == BATCH_PARAM[frame->method]) &&
+                (value != (HEAD_WORDS[frame->method] * INT256_LENGTH))) {
+                fail("Unexpected batch offset");
+                return;
+            }
+            if (++frame->item < HEAD_WORDS[frame->method]) {
+                expect(INT256_LENGTH);
+            } else {
+                frame->state = ARGS_LENGTH;
+                expect(INT256_LENGTH);
+            }
+            break;
+        case ARGS_LENGTH:
+            if (frame->method == MULTICALL_MULTISEND) {
+                if ((value == 0) || (value > (frame->end - g_multicall.pos))) {
+                    fail("Invalid transactions length");
+                    return;
+                }
+                frame->length = value;
+                frame->state = ARGS_ELEMENT;
+                push_frame(FRAME_PACKED, value, frame->target);
+            } else if (value > MULTICALL_MAX_CALLS) {
+                fail("Too many calls");
+            } else {
+                frame->items = value;
+                frame->item = 0;
+                frame->base = g_multicall.pos;
+                if (frame->items == 0) {
+                    frame->state = ARGS_DONE;
+                    close_frame();
+                } else {
+                    frame->state = ARGS_OFFSETS;
+                    expect(INT256_LENGTH);
+                }
+            }
+            break;
+        case ARGS_OFFSETS:
+            frame->offsets[frame->item] = value;
+            if (++frame->item < frame->items) {
+                expect(INT256_LENGTH);
+            } else {
+                frame->item = 0;
+                expect_element(frame);
+            }
+            break;
+        case ARGS_ELEMENT_LENGTH:
+            frame->length = value;
+            frame->state = ARGS_ELEMENT;
+            enter_call(value, frame->target);
+            break;
+        case ARGS_PADDING:
+            if (!allzeroes(field, g_multicall.fieldSize)) {
+                fail("Invalid padding");
+                return;
+            }
+            next_element(frame);
+            break;
+        default:
+            fail("Unexpected data");
+            break;
+    }
+}
+
+static void decode_packed_field(multicall_frame_t *frame, const uint8_t *field) {
+    uint32_t length;
+
+    switch (frame->state) {
+        case PACKED_OPERATION:
+            if (field[0] != MULTISEND_OPERATION_CALL) {
+                fail("Delegate call");
+                return;
+            }
+            frame->state = PACKED_TO;
+            expect(ADDRESS_LENGTH);
+            break;
+        case PACKED_TO:
+            memmove(frame->target, field, ADDRESS_LENGTH);
+            frame->state = PACKED_VALUE;
+            expect(INT256_LENGTH);
+            break;
+        case PACKED_VALUE:
+            memmove(g_multicall.value, field, INT256_LENGTH);
+            frame->state = PACKED_DATA_LENGTH;
+            expect(INT256_LENGTH);
+            break;
+        case PACKED_DATA_LENGTH:
+            if (!U4BE_from_parameter(field, &length)) {
+                fail("Invalid integer");
+                return;
+            }
+            frame->state = PACKED_CALL;
+            enter_call(length, frame->target);
+            break;
+        default:
+            fail("Unexpected data");
+            break;
+    }
+}
+
+static void expect_call_data(const multicall_frame_t *frame) {
+    if (g_multicall.pos == frame->end) {
+        if (!finish_call()) {
+            fail("Call not decoded");
+            return;
+        }
+        close_frame();
+    } else {
+        expect(MIN(INT256_LENGTH, frame->end - g_multicall.pos));
+    }
+}
+
+static void decode_call_field(multicall_frame_t *frame, uint8_t *field) {
+    const multicall_call_t *call = &g_multicall.calls[g_multicall.callsCount];
+    ethPluginProvideParameters_t provideParameter;
+    uint8_t target[ADDRESS_LENGTH];
+    int method;
+
+    switch (frame->state) {
+        case CALL_SELECTOR:
+            if ((method = find_method(field)) >= 0) {
+                // nested batch, replacing the frame of the call
+                if (!allzeroes(call->value, sizeof(call->value))) {
+                    fail("Value sent to a nested batch");
+                    return;
+                }
+                memmove(target, frame->target, sizeof(target));
+                g_multicall.depth -= 1;
+                push_frame(FRAME_ARGS, frame->end - g_multicall.pos, target);
+                get_frame()->method = method;
+                return;
+            }
+            if (!start_call(frame, field)) {
+                fail("Unsupported call");
+                return;
+            }
+            frame->state = CALL_DATA;
+            expect_call_data(frame);
+            break;
+        case CALL_DATA:
+            // the last parameter of the call may be shorter
+            memset(field + g_multicall.fieldSize, 0, INT256_LENGTH - g_multicall.fieldSize);
+            eth_plugin_prepare_provide_parameters(&provideParameter,
+                                                  field,
+                                                  g_multicall.pos - g_multicall.fieldSize -
+                                                      frame->start,
+                                                  1);
+            if (!multicall_call_message(&g_multicall.calls[g_multicall.callsCount - 1],
+                                        ETH_PLUGIN_PROVIDE_PARAMETER,
+                                        &provideParameter) ||
+                (provideParameter.base.result != ETH_PLUGIN_RESULT_OK)) {
+                fail("Call parameter rejected");
+                return;
+            }
+            expect_call_data(frame);
+            break;
+        default:
+            fail("Unexpected data");
+            break;
+    }
+}
+
+static void decode_field(void) {
+    multicall_frame_t *frame = get_frame();
+
+    switch (frame->kind) {
+        case FRAME_ARGS:
+            decode_args_field(frame, g_multicall.field);
+            break;
+        case FRAME_PACKED:
+            decode_packed_field(frame, g_multicall.field);
+            break;
+        case FRAME_CALL:
+            decode_call_field(frame, g_multicall.field);
+            break;
+        default:
+            fail("Unexpected frame");
+            break;
+    }
+}
+
+/**
+ * Decode some bytes of the calldata
+ *
+ * The frames are nested, but the calldata is decoded as it is received, one field at a time.
+ *
+ * @param[in] data the bytes
+ * @param[in] size their number
+ */
+static void decode_bytes(const uint8_t *data, size_t size) {
+    while ((size > 0) && !g_multicall.fallback) {
+        size_t length;
+
+        if (g_multicall.fieldSize == 0) {
+            fail("Unexpected data");
+            return;
+        }
+        length = MIN(size, (size_t) (g_multicall.fieldSize - g_multicall.fieldFill));
+        memcpy(g_multicall.field + g_multicall.fieldFill, data, length);
+        g_multicall.fieldFill += length;
+        g_multicall.pos += length;
+        data += length;
+        size -= length;
+        if (g_multicall.fieldFill == g_multicall.fieldSize) {
+            decode_field();
+        }
+    }
+}
+
+/**
+ * Decode a parameter of the batch
+ *
+ * @param[in] offset offset of the parameter in the calldata
+ * @param[in] parameter the parameter, the last one being padded with zeros
+ */
+static void decode_parameter(uint32_t offset, const uint8_t *parameter) {
+    if (g_multicall.fallback) {
+        return;
+    }
+    if ((offset - SELECTOR_SIZE) != g_multicall.pos) {
+        fail("Unexpected parameter offset");
+        return;
+    }
+    decode_bytes(parameter, MIN(INT256_LENGTH, g_multicall.dataSize - g_multicall.pos));
+}
+
+static void handle_init_contract(ethPluginInitContract_t *msg) {
+    int method = find_method(msg->selector);
+
+    if (method < 0) {
+        msg->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
+        return;
+    }
+    memset(&g_multicall, 0, sizeof(g_multicall));
+    g_multicall.method = method;
+    g_multicall.dataSize = msg->dataSize - SELECTOR_SIZE;
+    push_frame(FRAME_ARGS, g_multicall.dataSize, msg->pluginSharedRO->txContent->destination);
+    get_frame()->method = method;
+    ((ethPluginInitContractExt_t *) msg)->capabilities |= ETH_PLUGIN_CAPABILITY_BATCH_PARAMETERS;
+    msg->result = ETH_PLUGIN_RESULT_OK;
+}
+
+static void handle_finalize(ethPluginFinalize_t *msg) {
+    msg->result = ETH_PLUGIN_RESULT_FALLBACK;
+    if (g_multicall.fallback || (g_multicall.depth != 0) || (g_multicall.callsCount == 0)) {
+        PRINTF("Batch not decoded\n");
+        return;
+    }
+    msg->numScreens = 0;
+    for (uint8_t i = 0; i < g_multicall.callsCount; i++) {
+        // a screen to introduce each call
+        msg->numScreens += 1 + g_multicall.calls[i].numScreens;
+    }
+    // payable batch
+    if (!allzeroes(msg->pluginSharedRO->txContent->value.value,
+                   msg->pluginSharedRO->txContent->value.length)) {
+        msg->numScreens += 1;
+    }
+    msg->tokenLookup1 = NULL;
+    msg->tokenLookup2 = NULL;
+    msg->uiType = ETH_UI_TYPE_GENERIC;
+    msg->result = ETH_PLUGIN_RESULT_OK;
+}
+
+static void handle_query_contract_id(ethQueryContractID_t *msg) {
+    strlcpy(msg->name, "Batch", msg->nameLength);
+    strlcpy(msg->version,
+            (g_multicall.method == MULTICALL_MULTISEND) ? "MultiSend" : "Multicall",
+            msg->versionLength);
+    msg->result = ETH_PLUGIN_RESULT_OK;
+}
+
+void multicall_plugin_call(int message, void *parameters) {
+    switch (message) {
+        case ETH_PLUGIN_INIT_CONTRACT:
+            handle_init_contract((ethPluginInitContract_t *) parameters);
+            break;
+        case ETH_PLUGIN_PROVIDE_PARAMETER: {
+            ethPluginProvideParameters_t *msg = (ethPluginProvideParameters_t *) parameters;
+
+            for (uint16_t i = 0; i < msg->count; i++) {
+                decode_parameter(msg->base.parameterOffset + i * INT256_LENGTH,
+                                 msg->base.parameter + i * INT256_LENGTH);
+            }
+            msg->base.result = ETH_PLUGIN_RESULT_OK;
+        } break;
+        case ETH_PLUGIN_FINALIZE:
+            handle_finalize((ethPluginFinalize_t *) parameters);
+            break;
+        case ETH_PLUGIN_PROVIDE_INFO:
+            ((ethPluginProvideInfo_t *) parameters)->result = ETH_PLUGIN_RESULT_OK;
+            break;
+        case ETH_PLUGIN_QUERY_CONTRACT_ID:
+            handle_query_contract_id((ethQueryContractID_t *) parameters);
+            break;
+        case ETH_PLUGIN_QUERY_CONTRACT_UI:
+            handle_query_contract_ui_multicall(parameters);
+            break;
+        default:
+            PRINTF("Unhandled message %d\n", message);
+            break;
+    }
+}
+
+#endif  // HAVE_MULTICALL
@@ -0,0 +1,97 @@
+#ifndef _MULTICALL_PLUGIN_H_
+#define _MULTICALL_PLUGIN_H_
+
+#ifdef HAVE_MULTICALL
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "shared_context.h"
+#include "eth_plugin_interface.h"
+
+// Internal plugin for the batches of calls, multicall(bytes[]) and Safe multiSend(bytes), decoding
+// each call with the matching internal plugin while the calldata is received
+
+typedef enum {
+    MULTICALL_BYTES_ARRAY = 0,  // multicall(bytes[])
+    MULTICALL_DEADLINE,         // multicall(uint256,bytes[])
+    MULTICALL_MULTISEND,        // multiSend(bytes)
+    MULTICALL_METHODS_COUNT
+} multicall_method_t;
+
+// Calls of all the batches, nested ones included
+#define MULTICALL_MAX_CALLS 4
+// Nested frames being decoded: a batch, one of its calls, a batch in this call and so on
+#define MULTICALL_MAX_DEPTH 4
+// Enough for the contexts of the ERC-20, ERC-721 and ERC-1155 plugins
+#define MULTICALL_CONTEXT_SIZE (4 * INT256_LENGTH)
+
+typedef enum {
+    CALL_PLUGIN_NONE = 0,  // plain transfer, without data
+    CALL_PLUGIN_ERC20,
+#ifdef HAVE_NFT_SUPPORT
+    CALL_PLUGIN_ERC721,
+    CALL_PLUGIN_ERC1155,
+#endif
+} multicall_call_plugin_t;
+
+typedef enum {
+    FRAME_ARGS,    // ABI encoded parameters of a batch method
+    FRAME_PACKED,  // packed transactions of multiSend
+    FRAME_CALL,    // data of a call
+} multicall_frame_kind_t;
+
+typedef struct {
+    uint32_t start;  // position of the first byte, origin of the ABI offsets
+    uint32_t end;    // position right after the last byte
+    uint32_t base;   // origin of the offsets of the bytes[] elements
+    uint32_t length;  // of the bytes being decoded
+    uint32_t offsets[MULTICALL_MAX_CALLS];
+    uint8_t target[ADDRESS_LENGTH];  // of the calls in this frame
+    uint8_t kind;
+    uint8_t state;
+    uint8_t method;
+    uint8_t items;
+    uint8_t item;
+} multicall_frame_t;
+
+typedef struct {
+    // context of the plugin decoding the call, cast as its context struct like pluginContext
+    uint8_t context[MULTICALL_CONTEXT_SIZE] __attribute__((aligned(4)));
+    uint8_t target[ADDRESS_LENGTH];
+    uint8_t value[INT256_LENGTH];
+    uint8_t plugin;
+    uint8_t uiType;
+    uint8_t numScreens;
+    // in the context, for the calls using the amount/address UI
+    uint8_t amountOffset;
+    uint8_t addressOffset;
+} multicall_call_t;
+
+typedef struct {
+    multicall_call_t calls[MULTICALL_MAX_CALLS];
+    multicall_frame_t frames[MULTICALL_MAX_DEPTH];
+    // transaction seen by the plugin decoding a call
+    txContent_t txContent;
+    // value sent with the next call
+    uint8_t value[INT256_LENGTH];
+    uint8_t field[INT256_LENGTH];
+    uint32_t pos;  // in the calldata, after the selector
+    uint32_t dataSize;
+    uint8_t fieldSize;
+    uint8_t fieldFill;
+    uint8_t depth;
+    uint8_t callsCount;
+    uint8_t method;
+    // batch which can not be decoded, left to the blind signing
+    bool fallback;
+} multicall_context_t;
+
+extern multicall_context_t g_multicall;
+
+void multicall_plugin_call(int message, void *parameters);
+bool multicall_call_message(multicall_call_t *call, int message, void *parameters);
+void handle_query_contract_ui_multicall(void *parameters);
+
+#endif  // HAVE_MULTICALL
+
+#endif  // _MULTICALL_PLUGIN_H_
@@ -0,0 +1,107 @@
+#ifdef HAVE_MULTICALL
+
+#include <stdio.h>
+#include <string.h>
+#include "multicall_plugin.h"
+#include "eth_plugin_internal.h"
+#include "manage_asset_info.h"
+#include "common_utils.h"
+#include "uint256.h"
+
+static void amount_ui(ethQueryContractUI_t *msg,
+                      const uint8_t *amount,
+                      uint8_t amount_size,
+                      uint8_t decimals,
+                      const char *ticker) {
+    strlcpy(msg->title, "Amount", msg->titleLength);
+    if (!amount_to_string(amount, amount_size, decimals, ticker, msg->msg, msg->msgLength)) {
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+    }
+}
+
+static void address_ui(ethQueryContractUI_t *msg, const char *title, const uint8_t *address) {
+    strlcpy(msg->title, title, msg->titleLength);
+    if (!getEthDisplayableAddress((uint8_t *) address,
+                                  msg->msg,
+                                  msg->msgLength,
+                                  chainConfig->chainId)) {
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+    }
+}
+
+/**
+ * Screen of a call, as the plugin which decoded it would show it
+ *
+ * @param[in,out] msg the query
+ * @param[in] call the call
+ * @param[in] index index of the screen in the call
+ */
+static void call_ui(ethQueryContractUI_t *msg, multicall_call_t *call, uint8_t index) {
+    extraInfo_t *asset = get_asset_info_by_addr(call->target);
+    ethQueryContractUI_t query;
+
+    if (call->plugin == CALL_PLUGIN_NONE) {
+        amount_ui(msg, call->value, sizeof(call->value), WEI_TO_ETHER, msg->network_ticker);
+        return;
+    }
+    if (call->uiType == ETH_UI_TYPE_AMOUNT_ADDRESS) {
+        if (asset == NULL) {
+            msg->result = ETH_PLUGIN_RESULT_ERROR;
+        } else if (index == 0) {
+            amount_ui(msg,
+                      call->context + call->amountOffset,
+                      INT256_LENGTH,
+                      asset->token.decimals,
+                      asset->token.ticker);
+        } else {
+            address_ui(msg, "Address", call->context + call->addressOffset);
+        }
+        return;
+    }
+    memcpy(&query, msg, sizeof(query));
+    query.item1 = asset;
+    query.item2 = NULL;
+    query.screenIndex = index;
+    if (!multicall_call_message(call, ETH_PLUGIN_QUERY_CONTRACT_UI, &query)) {
+        msg->result = ETH_PLUGIN_RESULT_ERROR;
+        return;
+    }
+    msg->result = query.result;
+}
+
+void handle_query_contract_ui_multicall(void *parameters) {
+    ethQueryContractUI_t *msg = (ethQueryContractUI_t *) parameters;
+    uint8_t index = msg->screenIndex;
+
+    msg->result = ETH_PLUGIN_RESULT_OK;
+    for (uint8_t i = 0; i < g_multicall.callsCount; i++) {
+        multicall_call_t *call = &g_multicall.calls[i];
+
+        if (index == 0) {
+            char title[sizeof("Call 255 of 255")];
+
+            snprintf(title, sizeof(title), "Call %d of %d", i + 1, g_multicall.callsCount);
+            address_ui(msg, title, call->target);
+            return;
+        }
+        index -= 1;
+        if (index < call->numScreens) {
+            call_ui(msg, call, index);
+            return;
+        }
+        index -= call->numScreens;
+    }
+    if (index == 0) {
+        // amount sent to a payable batch
+        amount_ui(msg,
+                  msg->pluginSharedRO->txContent->value.value,
+                  msg->pluginSharedRO->txContent->value.length,
+                  WEI_TO_ETHER,
+                  msg->network_ticker);
+        return;
+    }
+    PRINTF("Unsupported screen index %d\n", msg->screenIndex);
+    msg->result = ETH_PLUGIN_RESULT_ERROR;
+}
+
+#endif  // HAVE_MULTICALL
@@ -0,0 +1,48 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Behaviour of the stubbed plugin layer
+typedef enum {
+    BENCH_PLUGIN_NONE,    // no plugin matches, calldata is only hashed
+    BENCH_PLUGIN_ACCEPT,  // a plugin accepts every contract call and every parameter
+    BENCH_PLUGIN_BATCH    // same, but it gets several parameters per ETH_PLUGIN_PROVIDE_PARAMETER
+} bench_plugin_mode_e;
+
+extern bench_plugin_mode_e g_bench_plugin_mode;
+extern uint32_t g_bench_plugin_parameters;
+// Calls made to the plugin to provide these parameters
+extern uint32_t g_bench_plugin_calls;
+// Checksum of the parameters and of their offsets, in the order they were provided
+extern uint32_t g_bench_plugin_digest;
+
+void bench_set_storage(bool data_allowed, bool contract_details);
+
+// Monotonic tick counter, CPU cycles when available
+uint64_t bench_ticks(void);
+const char *bench_ticks_unit(void);
+// Nanoseconds since an arbitrary origin
+uint64_t bench_ns(void);
+
+// Deterministic pseudo-random generator so that the corpora are reproducible
+uint32_t bench_rand(uint32_t *state);
+void bench_rand_bytes(uint32_t *state, uint8_t *out, size_t len);
@@ -0,0 +1,218 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Token/NFT description cache benchmark
+//
+// Provisions assets the way the PROVIDE ERC 20 TOKEN INFORMATION handler does, checks the
+// lookups, replacement and eviction behaviour, and that a rejected description leaves the cache
+// unchanged, then times the address lookups against a linear scan of the cache.
+//
+// Usage: bench_assets [-n iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared_context.h"
+#include "manage_asset_info.h"
+#include "bench.h"
+
+#define DEFAULT_ITERATIONS 20000
+
+static uint8_t g_addresses[2 * MAX_ASSETS][ADDRESS_LENGTH];
+
+/**
+ * Parse a token description
+ *
+ * @param[in] address contract address
+ * @return the token, not stored until validated
+ */
+static tokenDefinition_t *parse(const uint8_t *address) {
+    tokenDefinition_t *token = &get_current_asset_info()->token;
+
+    memcpy(token->address, address, ADDRESS_LENGTH);
+    snprintf(token->ticker, sizeof(token->ticker), "T%02x ", address[0]);
+    token->decimals = 18;
+    return token;
+}
+
+static uint8_t provision(const uint8_t *address) {
+    parse(address);
+    validate_current_asset_info();
+    return tmpCtx.transactionContext.currentAssetIndex;
+}
+
+/**
+ * Check that descriptions rejected after being parsed (bad signature...) change nothing
+ *
+ * @return whether the cache is unchanged
+ */
+static bool check_rejected(void) {
+    static transactionContext_t before;
+    const asset_cache_stats_t *stats = get_asset_cache_stats();
+    uint32_t evictions = stats->evictions;
+
+    memcpy(&before, &tmpCtx.transactionContext, sizeof(before));
+    // an unknown asset, then a new description of a known one
+    parse(g_addresses[MAX_ASSETS]);
+    parse(g_addresses[0])->decimals = 6;
+    if ((stats->evictions != evictions) ||
+        (memcmp(before.extraInfo, tmpCtx.transactionContext.extraInfo, sizeof(before.extraInfo)) !=
+         0) ||
+        (memcmp(before.assetSet, tmpCtx.transactionContext.assetSet, sizeof(before.assetSet)) !=
+         0) ||
+        (memcmp(before.assetBuckets,
+                tmpCtx.transactionContext.assetBuckets,
+                sizeof(before.assetBuckets)) != 0)) {
+        fprintf(stderr, "rejected description changed the cache\n");
+        return false;
+    }
+    return true;
+}
+
+// Lookup as done before the address index
+static extraInfo_t *ref_get_asset_info_by_addr(const uint8_t *address) {
+    for (uint8_t i = 0; i < MAX_ASSETS; i++) {
+        if (tmpCtx.transactionContext.assetSet[i] &&
+            (memcmp(tmpCtx.transactionContext.extraInfo[i].token.address,
+                    address,
+                    ADDRESS_LENGTH) == 0)) {
+            return &tmpCtx.transactionContext.extraInfo[i];
+        }
+    }
+    return NULL;
+}
+
+static bool check_cache(void) {
+    const asset_cache_stats_t *stats = get_asset_cache_stats();
+    uint32_t evictions = stats->evictions;
+    uint8_t address[ADDRESS_LENGTH];
+
+    forget_known_assets();
+    for (uint8_t i = 0; i < MAX_ASSETS; i++) {
+        if (provision(g_addresses[i]) != i) {
+            fprintf(stderr, "asset #%u not provisioned in order\n", i);
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < MAX_ASSETS; i++) {
+        if (get_asset_info_by_addr(g_addresses[i]) != &tmpCtx.transactionContext.extraInfo[i]) {
+            fprintf(stderr, "asset #%u not found\n", i);
+            return false;
+        }
+    }
+    if (!check_rejected()) {
+        return false;
+    }
+    // a new description of a known address replaces it
+    if ((provision(g_addresses[0]) != 0) || (get_asset_info_by_addr(g_addresses[0]) == NULL)) {
+        fprintf(stderr, "asset replacement failed\n");
+        return false;
+    }
+    // asset #1 is now the least recently used one, then #2...
+    for (uint8_t i = 0; i < MAX_ASSETS; i++) {
+        uint8_t expected = (i + 1) % MAX_ASSETS;
+
+        if (provision(g_addresses[MAX_ASSETS + i]) != expected) {
+            fprintf(stderr, "asset #%u was not the one evicted\n", expected);
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < (2 * MAX_ASSETS); i++) {
+        bool expected = (i >= MAX_ASSETS);
+
+        if ((get_asset_info_by_addr(g_addresses[i]) != NULL) != expected) {
+            fprintf(stderr, "asset #%u lookup mismatch after eviction\n", i);
+            return false;
+        }
+    }
+    memset(address, 0, sizeof(address));
+    if (get_asset_info_by_addr(address) != NULL) {
+        fprintf(stderr, "unknown address found\n");
+        return false;
+    }
+    if ((stats->evictions - evictions) != (MAX_ASSETS + 1)) {
+        fprintf(stderr, "unexpected eviction count\n");
+        return false;
+    }
+    forget_known_assets();
+    if (get_asset_info_by_addr(g_addresses[MAX_ASSETS]) != NULL) {
+        fprintf(stderr, "asset still known after reset\n");
+        return false;
+    }
+    return true;
+}
+
+static void bench_lookup(uint32_t iterations) {
+    uint64_t ticks[2];
+
+    forget_known_assets();
+    for (uint8_t i = 0; i < MAX_ASSETS; i++) {
+        provision(g_addresses[i]);
+    }
+    for (int impl = 0; impl < 2; impl++) {
+        uint64_t start = bench_ticks();
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            // half hits, half misses
+            for (uint8_t i = 0; i < (2 * MAX_ASSETS); i++) {
+                extraInfo_t *volatile info;
+
+                if (impl == 0) {
+                    info = ref_get_asset_info_by_addr(g_addresses[i]);
+                } else {
+                    info = get_asset_info_by_addr(g_addresses[i]);
+                }
+                (void) info;
+            }
+        }
+        ticks[impl] = bench_ticks() - start;
+    }
+    printf("lookup      %3u assets %10.1f %s/call (scan) %10.1f %s/call %8.1fx\n",
+           MAX_ASSETS,
+           (double) ticks[0] / ((double) iterations * 2 * MAX_ASSETS),
+           bench_ticks_unit(),
+           (double) ticks[1] / ((double) iterations * 2 * MAX_ASSETS),
+           bench_ticks_unit(),
+           (double) ticks[0] / (double) ticks[1]);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t seed = 0xa55e75;
+    const asset_cache_stats_t *stats;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < (2 * MAX_ASSETS); i++) {
+        bench_rand_bytes(&seed, g_addresses[i], ADDRESS_LENGTH);
+    }
+    if (!check_cache()) {
+        return EXIT_FAILURE;
+    }
+    bench_lookup(iterations);
+    stats = get_asset_cache_stats();
+    printf("hits %u, misses %u, evictions %u\n", stats->hits, stats->misses, stats->evictions);
+    return EXIT_SUCCESS;
+}
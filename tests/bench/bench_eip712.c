@@ -0,0 +1,563 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// EIP-712 hashing benchmark
+//
+// Sends struct definitions and implementations to the EIP-712 engine the way the STRUCT DEFINITION
+// and STRUCT IMPLEMENTATION commands provide them, and checks the domain & message hashes of the
+// "Mail" example of the EIP-712 specification, then of an order book whose structs are nested
+// and defined after many others, and of a batch of payments made of arrays of primitives, whose
+// elements are sent one by one or packed (and then refused as in verbose mode, and sent one by one
+// again). Then times the definition of that schema, the hashing
+// of the order book and of the batch, both ways.
+//
+// Usage: bench_eip712 [-n iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared_context.h"
+#include "apdu_constants.h"
+#include "context_712.h"
+#include "typed_data.h"
+#include "path.h"
+#include "field_hash.h"
+#include "ui_logic.h"
+#include "commands_712.h"
+#include "schema_cache.h"
+#include "bench.h"
+
+#define DEFAULT_ITERATIONS 2000
+
+// structs defined before the ones of the order book
+#define PADDING_STRUCTS 40
+
+#define ORDERS 16
+#define IDS    3
+
+#define PAYMENTS 200
+
+// typedesc of the struct fields
+#define T_CUSTOM  0x00
+#define T_UINT    (0x40 | 0x02)
+#define T_ADDRESS 0x03
+#define T_BOOL    0x04
+#define T_STRING  0x05
+#define T_BYTES   (0x40 | 0x06)
+#define T_ARRAY   0x80
+
+// expected hashes
+static const uint8_t MAIL_DOMAIN_HASH[] = {
+    0xf2, 0xce, 0xe3, 0x75, 0xfa, 0x42, 0xb4, 0x21, 0x43, 0x80, 0x40, 0x25, 0xfc, 0x44, 0x9d, 0xea,
+    0xfd, 0x50, 0xcc, 0x03, 0x1c, 0xa2, 0x57, 0xe0, 0xb1, 0x94, 0xa6, 0x50, 0xa9, 0x12, 0x09, 0x0f};
+static const uint8_t MAIL_MESSAGE_HASH[] = {
+    0xc5, 0x2c, 0x0e, 0xe5, 0xd8, 0x42, 0x64, 0x47, 0x18, 0x06, 0x29, 0x0a, 0x3f, 0x2c, 0x4c, 0xec,
+    0xfc, 0x54, 0x90, 0x62, 0x6b, 0xf9, 0x12, 0xd0, 0x1f, 0x24, 0x0d, 0x7a, 0x27, 0x4b, 0x37, 0x1e};
+static const uint8_t BOOK_MESSAGE_HASH[] = {
+    0x3e, 0xf6, 0x77, 0xf0, 0xd4, 0x22, 0xd0, 0xfc, 0xf2, 0x39, 0xbe, 0x44, 0xa1, 0x4d, 0xbc, 0xfe,
+    0x61, 0x51, 0x6a, 0x73, 0xe2, 0xc5, 0x8e, 0x93, 0x6e, 0x7d, 0x29, 0x62, 0x19, 0x53, 0xfa, 0x8b};
+static const uint8_t BATCH_MESSAGE_HASH[] = {
+    0xa9, 0x91, 0x47, 0x53, 0x8e, 0x25, 0xb9, 0xae, 0x5a, 0x12, 0xe1, 0x2c, 0x7b, 0x56, 0xc5, 0x9c,
+    0xbe, 0x0e, 0xbf, 0xd1, 0xc3, 0xfb, 0x81, 0x40, 0x70, 0x39, 0x70, 0x9c, 0xaf, 0x06, 0x92, 0x0b};
+
+static const uint8_t MAIL_SCHEMA_HASH[] = {
+    0x46, 0x62, 0xa1, 0x63, 0xa3, 0x62, 0xc6, 0x29, 0x60, 0xc9, 0x0c, 0x4b, 0xb1, 0x41,
+    0xba, 0x24, 0x90, 0x80, 0xa1, 0xea, 0x1f, 0xff, 0xec, 0x09, 0xd4, 0x51, 0xca, 0xfd};
+
+static uint32_t g_fields;
+static uint32_t g_apdus;
+
+// whether the array elements of the batch are packed
+static bool g_packed;
+
+// whether the fields are shown, which makes the app refuse the packed ones
+static bool g_shown;
+
+// packed field values not sent yet
+static uint8_t g_pack[255];
+static uint8_t g_pack_length;
+
+// schema of the last message, as sent by a client to use the schema cache
+static uint8_t g_schema_hash[sizeof(MAIL_SCHEMA_HASH)];
+
+/*
+ * The UI is not benchmarked, every field is hashed without being displayed
+ */
+bool ui_712_init(void) {
+    return true;
+}
+
+void ui_712_deinit(void) {
+}
+
+bool ui_712_new_field(const void *const field_ptr, const uint8_t *const data, uint8_t length) {
+    (void) field_ptr;
+    (void) data;
+    (void) length;
+    return true;
+}
+
+void ui_712_finalize_field(void) {
+    g_fields += 1;
+}
+
+bool ui_712_skip_field(void) {
+    if (g_shown) {
+        apdu_response_code = APDU_RESPONSE_CONDITION_NOT_SATISFIED;
+        return false;
+    }
+    g_fields += 1;
+    return true;
+}
+
+e_eip712_nfs ui_712_next_field(void) {
+    return EIP712_FIELD_INCOMING;
+}
+
+void ui_712_notify_filter_change(void) {
+}
+
+void handle_eip712_return_code(bool success) {
+    (void) success;
+}
+
+static bool def_struct(const char *name) {
+    return set_struct_name(strlen(name), (const uint8_t *) name);
+}
+
+/**
+ * Define a struct field
+ *
+ * @param[in] typedesc field TypeDesc, with \ref T_ARRAY for an array of dynamic size
+ * @param[in] type custom type name or type size
+ * @param[in] name key name
+ */
+static bool def_field(uint8_t typedesc, const void *type, const char *name) {
+    uint8_t data[128];
+    uint8_t length = 0;
+
+    data[length++] = typedesc;
+    if ((typedesc & 0x0f) == T_CUSTOM) {
+        data[length++] = strlen(type);
+        memcpy(&data[length], type, strlen(type));
+        length += strlen(type);
+    } else if (typedesc & 0x40) {
+        data[length++] = *(const uint8_t *) type;
+    }
+    if (typedesc & T_ARRAY) {
+        data[length++] = 1;
+        data[length++] = ARRAY_DYNAMIC;
+    }
+    data[length++] = strlen(name);
+    memcpy(&data[length], name, strlen(name));
+    length += strlen(name);
+    return set_struct_field(length, data);
+}
+
+static bool impl_root(const char *name) {
+    bool defined = (struct_state == DEFINED);
+
+    g_apdus += 1;
+    if (!path_set_root(name, strlen(name))) {
+        return false;
+    }
+    if (!defined) {
+        schema_cache_add();
+        memcpy(g_schema_hash, eip712_context->schema_hash, sizeof(g_schema_hash));
+    }
+    return true;
+}
+
+static bool impl_array(uint8_t size) {
+    g_apdus += 1;
+    return path_new_array_depth(&size, sizeof(size));
+}
+
+static bool impl_field(const void *value, uint8_t length) {
+    uint8_t data[2 + 255];
+
+    g_apdus += 1;
+    data[0] = 0;
+    data[1] = length;
+    memcpy(&data[2], value, length);
+    return field_hash(data, 2 + length, false);
+}
+
+static bool impl_string(const char *value) {
+    return impl_field(value, strlen(value));
+}
+
+static uint8_t uint_bytes(uint64_t value, uint8_t *data) {
+    uint8_t length = 0;
+
+    for (int i = 7; i >= 0; i--) {
+        if ((length > 0) || ((value >> (8 * i)) & 0xff) || (i == 0)) {
+            data[length++] = (value >> (8 * i)) & 0xff;
+        }
+    }
+    return length;
+}
+
+static bool impl_uint(uint64_t value) {
+    uint8_t data[8];
+    uint8_t length = uint_bytes(value, data);
+
+    return impl_field(data, length);
+}
+
+static bool impl_packed_flush(void) {
+    uint8_t length = g_pack_length;
+
+    if (length == 0) {
+        return true;
+    }
+    g_apdus += 1;
+    g_pack_length = 0;
+    if (field_hash_packed(g_pack, length)) {
+        return true;
+    }
+    if (apdu_response_code != APDU_RESPONSE_COMMAND_NOT_ALLOWED) {
+        return false;
+    }
+    // refused without being hashed, sent one by one like the client does
+    for (uint8_t idx = 0; idx < length; idx += 2 + g_pack[idx + 1]) {
+        if (!impl_field(&g_pack[idx + 2], g_pack[idx + 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Implement an array element, packed with the next ones until they fill an APDU if enabled
+ *
+ * @param[in] value element value
+ * @param[in] length its length
+ */
+static bool impl_element(const void *value, uint8_t length) {
+    if (!g_packed) {
+        return impl_field(value, length);
+    }
+    if ((g_pack_length + 2 + length) > sizeof(g_pack)) {
+        if (!impl_packed_flush()) {
+            return false;
+        }
+    }
+    g_pack[g_pack_length++] = 0;
+    g_pack[g_pack_length++] = length;
+    memcpy(&g_pack[g_pack_length], value, length);
+    g_pack_length += length;
+    return true;
+}
+
+static const uint8_t g_size_256 = 32;
+static const uint8_t g_size_16 = 2;
+
+static bool define_mail(void) {
+    return def_struct("EIP712Domain") && def_field(T_STRING, NULL, "name") &&
+           def_field(T_STRING, NULL, "version") && def_field(T_UINT, &g_size_256, "chainId") &&
+           def_field(T_ADDRESS, NULL, "verifyingContract") && def_struct("Mail") &&
+           def_field(T_CUSTOM, "Person", "from") && def_field(T_CUSTOM, "Person", "to") &&
+           def_field(T_STRING, NULL, "contents") && def_struct("Person") &&
+           def_field(T_STRING, NULL, "name") && def_field(T_ADDRESS, NULL, "wallet");
+}
+
+static bool hash_mail(void) {
+    static const uint8_t contract[ADDRESS_LENGTH] = {0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc,
+                                                     0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc,
+                                                     0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc};
+    static const uint8_t cow[ADDRESS_LENGTH] = {0xcd, 0x2a, 0x3d, 0x9f, 0x93, 0x8e, 0x13,
+                                                0xcd, 0x94, 0x7e, 0xc0, 0x5a, 0xbc, 0x7f,
+                                                0xe7, 0x34, 0xdf, 0x8d, 0xd8, 0x26};
+    static const uint8_t bob[ADDRESS_LENGTH] = {0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb,
+                                                0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb,
+                                                0xbb, 0xbb, 0xbb, 0xbb, 0xbb, 0xbb};
+
+    return impl_root("EIP712Domain") && impl_string("Ether Mail") && impl_string("1") &&
+           impl_uint(1) && impl_field(contract, sizeof(contract)) && impl_root("Mail") &&
+           impl_string("Cow") && impl_field(cow, sizeof(cow)) && impl_string("Bob") &&
+           impl_field(bob, sizeof(bob)) && impl_string("Hello, Bob!");
+}
+
+static bool define_book(void) {
+    char name[16];
+
+    if (!def_struct("EIP712Domain") || !def_field(T_STRING, NULL, "name") ||
+        !def_field(T_UINT, &g_size_256, "chainId")) {
+        return false;
+    }
+    for (int i = 0; i < PADDING_STRUCTS; i++) {
+        snprintf(name, sizeof(name), "Padding%02d", i);
+        if (!def_struct(name) || !def_field(T_UINT, &g_size_256, "value")) {
+            return false;
+        }
+    }
+    return def_struct("Fee") && def_field(T_ADDRESS, NULL, "recipient") &&
+           def_field(T_UINT, &g_size_16, "bps") && def_struct("Asset") &&
+           def_field(T_ADDRESS, NULL, "token") && def_field(T_UINT, &g_size_256, "amount") &&
+           def_field(T_CUSTOM, "Fee", "fee") && def_struct("Order") &&
+           def_field(T_ADDRESS, NULL, "maker") && def_field(T_CUSTOM, "Asset", "sell") &&
+           def_field(T_CUSTOM, "Asset", "buy") && def_field(T_UINT, &g_size_256, "nonce") &&
+           def_field(T_BYTES, &g_size_256, "salt") && def_field(T_BOOL, NULL, "partial") &&
+           def_field(T_STRING, NULL, "memo") && def_field(T_UINT | T_ARRAY, &g_size_256, "ids") &&
+           def_struct("Book") && def_field(T_STRING, NULL, "name") &&
+           def_field(T_CUSTOM | T_ARRAY, "Order", "orders");
+}
+
+static bool load_schema(void) {
+    return schema_cache_load(g_schema_hash, sizeof(g_schema_hash));
+}
+
+static bool hash_asset(uint32_t *seed) {
+    uint8_t address[ADDRESS_LENGTH];
+
+    bench_rand_bytes(seed, address, sizeof(address));
+    if (!impl_field(address, sizeof(address)) || !impl_uint(bench_rand(seed))) {
+        return false;
+    }
+    bench_rand_bytes(seed, address, sizeof(address));
+    return impl_field(address, sizeof(address)) && impl_uint(bench_rand(seed) % 10000);
+}
+
+static bool hash_book(void) {
+    uint32_t seed = 712;
+    uint8_t address[ADDRESS_LENGTH];
+    uint8_t salt[32];
+    bool partial;
+
+    if (!impl_root("EIP712Domain") || !impl_string("Order book") || !impl_uint(1)) {
+        return false;
+    }
+    if (!impl_root("Book") || !impl_string("Bench") || !impl_array(ORDERS)) {
+        return false;
+    }
+    for (int i = 0; i < ORDERS; i++) {
+        bench_rand_bytes(&seed, address, sizeof(address));
+        bench_rand_bytes(&seed, salt, sizeof(salt));
+        partial = bench_rand(&seed) & 1;
+        if (!impl_field(address, sizeof(address)) || !hash_asset(&seed) || !hash_asset(&seed) ||
+            !impl_uint(i) || !impl_field(salt, sizeof(salt)) ||
+            !impl_field(&partial, sizeof(partial)) || !impl_string("good till cancelled") ||
+            !impl_array(IDS)) {
+            return false;
+        }
+        for (int id = 0; id < IDS; id++) {
+            if (!impl_uint(bench_rand(&seed))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool define_batch(void) {
+    return def_struct("EIP712Domain") && def_field(T_STRING, NULL, "name") &&
+           def_field(T_UINT, &g_size_256, "chainId") && def_struct("Batch") &&
+           def_field(T_STRING, NULL, "name") &&
+           def_field(T_UINT | T_ARRAY, &g_size_256, "amounts") &&
+           def_field(T_ADDRESS | T_ARRAY, NULL, "recipients");
+}
+
+static bool hash_batch(void) {
+    uint32_t seed = 0xba7c4;
+    uint8_t data[ADDRESS_LENGTH];
+    uint8_t length;
+
+    if (!impl_root("EIP712Domain") || !impl_string("Payroll") || !impl_uint(1) ||
+        !impl_root("Batch") || !impl_string("Bench") || !impl_array(PAYMENTS)) {
+        return false;
+    }
+    for (int i = 0; i < PAYMENTS; i++) {
+        length = uint_bytes(bench_rand(&seed), data);
+        if (!impl_element(data, length)) {
+            return false;
+        }
+    }
+    if (!impl_packed_flush() || !impl_array(PAYMENTS)) {
+        return false;
+    }
+    for (int i = 0; i < PAYMENTS; i++) {
+        bench_rand_bytes(&seed, data, sizeof(data));
+        if (!impl_element(data, sizeof(data))) {
+            return false;
+        }
+    }
+    return impl_packed_flush();
+}
+
+static bool hash_batch_packed(void) {
+    bool ok;
+
+    g_packed = true;
+    ok = hash_batch();
+    g_packed = false;
+    return ok;
+}
+
+static bool hash_batch_shown(void) {
+    bool ok;
+
+    g_shown = true;
+    ok = hash_batch_packed();
+    g_shown = false;
+    return ok;
+}
+
+static bool check_hashes(const char *name,
+                         const uint8_t *domain_hash,
+                         const uint8_t *message_hash) {
+    if (path_get_field() != NULL) {
+        fprintf(stderr, "%s: fields left to implement\n", name);
+        return false;
+    }
+    if ((domain_hash != NULL) &&
+        (memcmp(tmpCtx.messageSigningContext712.domainHash, domain_hash, 32) != 0)) {
+        fprintf(stderr, "%s: wrong domain hash\n", name);
+        return false;
+    }
+    if (memcmp(tmpCtx.messageSigningContext712.messageHash, message_hash, 32) != 0) {
+        fprintf(stderr, "%s: wrong message hash ", name);
+        for (int i = 0; i < 32; i++) {
+            fprintf(stderr, "%02x", tmpCtx.messageSigningContext712.messageHash[i]);
+        }
+        fprintf(stderr, "\n");
+        return false;
+    }
+    printf("%-12s %u fields in %u APDUs, hashes ok\n", name, g_fields, g_apdus);
+    return true;
+}
+
+static bool check(const char *name,
+                  bool (*define)(void),
+                  bool (*hash)(void),
+                  const uint8_t *domain_hash,
+                  const uint8_t *message_hash) {
+    bool ok;
+
+    g_fields = 0;
+    g_apdus = 0;
+    if (!eip712_context_init() || !define()) {
+        fprintf(stderr, "%s: definition failed\n", name);
+        eip712_context_deinit();
+        return false;
+    }
+    if (!hash()) {
+        fprintf(stderr, "%s: implementation failed after %u fields\n", name, g_fields);
+        eip712_context_deinit();
+        return false;
+    }
+    ok = check_hashes(name, domain_hash, message_hash);
+    eip712_context_deinit();
+    return ok;
+}
+
+static void bench_book(uint32_t iterations) {
+    uint64_t define_ns = 0;
+    uint64_t load_ns = 0;
+    uint64_t hash_ns = 0;
+    uint64_t start;
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        g_fields = 0;
+        start = bench_ns();
+        eip712_context_init();
+        define_book();
+        define_ns += bench_ns() - start;
+        start = bench_ns();
+        hash_book();
+        hash_ns += bench_ns() - start;
+        eip712_context_deinit();
+
+        start = bench_ns();
+        eip712_context_init();
+        load_schema();
+        load_ns += bench_ns() - start;
+        eip712_context_deinit();
+    }
+    printf("define      %u x %u structs: %.0f ns/schema\n",
+           iterations,
+           PADDING_STRUCTS + 5,
+           (double) define_ns / iterations);
+    printf("load        %u x %u structs: %.0f ns/schema\n",
+           iterations,
+           PADDING_STRUCTS + 5,
+           (double) load_ns / iterations);
+    printf("hash        %u x %u fields: %.0f ns/message, %.0f ns/field\n",
+           iterations,
+           g_fields,
+           (double) hash_ns / iterations,
+           (double) hash_ns / ((double) iterations * g_fields));
+}
+
+static void bench_batch(uint32_t iterations) {
+    uint64_t ns[2] = {0};
+    uint64_t start;
+
+    for (uint32_t it = 0; it < iterations; it++) {
+        for (int packed = 0; packed < 2; packed++) {
+            eip712_context_init();
+            define_batch();
+            start = bench_ns();
+            if (packed) {
+                hash_batch_packed();
+            } else {
+                hash_batch();
+            }
+            ns[packed] += bench_ns() - start;
+            eip712_context_deinit();
+        }
+    }
+    printf("batch       %u x %u elements: %.0f ns/message, %.0f ns/message packed\n",
+           iterations,
+           2 * PAYMENTS,
+           (double) ns[0] / iterations,
+           (double) ns[1] / iterations);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    reset_app_context();
+    if (!check("mail", define_mail, hash_mail, MAIL_DOMAIN_HASH, MAIL_MESSAGE_HASH)) {
+        return EXIT_FAILURE;
+    }
+    if (memcmp(g_schema_hash, MAIL_SCHEMA_HASH, sizeof(g_schema_hash)) != 0) {
+        fprintf(stderr, "mail: wrong schema hash\n");
+        return EXIT_FAILURE;
+    }
+    if (!check("mail cached", load_schema, hash_mail, MAIL_DOMAIN_HASH, MAIL_MESSAGE_HASH) ||
+        !check("order book", define_book, hash_book, NULL, BOOK_MESSAGE_HASH) ||
+        !check("book cached", load_schema, hash_book, NULL, BOOK_MESSAGE_HASH) ||
+        !check("batch", define_batch, hash_batch, NULL, BATCH_MESSAGE_HASH) ||
+        !check("batch packed", define_batch, hash_batch_packed, NULL, BATCH_MESSAGE_HASH) ||
+        !check("batch shown", define_batch, hash_batch_shown, NULL, BATCH_MESSAGE_HASH)) {
+        return EXIT_FAILURE;
+    }
+    bench_book(iterations);
+    bench_batch(iterations);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,328 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Dynamic memory allocator stress benchmark
+//
+// Replays random sequences of allocations (aligned or not), deallocations, nested mark/release
+// scopes of a different tag and exhaustions of the buffer against a model, checking that every
+// allocation is where expected and that the live ones are never overwritten. When built with
+// HAVE_PROFILING, also checks the usage and the high-water marks, overall and per tag. Then times
+// the allocations of a scope, like the temporary ones of the EIP-712 hashing.
+//
+// Usage: bench_mem [-n iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os.h"
+#include "mem.h"
+#include "mem_utils.h"
+#include "bench.h"
+
+#define DEFAULT_ITERATIONS 200000
+
+#define STRESS_OPS       200000
+#define MAX_LIVE         512
+#define MAX_DEPTH        6
+#define ALLOCS_PER_SCOPE 16
+
+typedef struct {
+    size_t start;  // offsets in the buffer
+    size_t end;
+    uint8_t pattern;
+    e_mem_tag tag;
+} allocation_t;
+
+typedef struct {
+    mem_mark_t mark;
+    size_t live_count;  // allocations made before the scope
+    e_mem_tag parent_tag;
+} scope_t;
+
+static allocation_t g_live[MAX_LIVE];
+static size_t g_live_count;
+static scope_t g_scopes[MAX_DEPTH];
+static size_t g_depth;
+static e_mem_tag g_tag;
+static uint8_t *g_base;
+static size_t g_high_water;
+static size_t g_tags_used[MEM_TAGS_COUNT];
+static size_t g_tags_high_water[MEM_TAGS_COUNT];
+static uint32_t g_exhaustions;
+
+static size_t top(void) {
+    return (uint8_t *) mem_alloc(0) - g_base;
+}
+
+static size_t model_top(void) {
+    return (g_live_count > 0) ? g_live[g_live_count - 1].end : 0;
+}
+
+static void set_tag(e_mem_tag tag) {
+    g_tag = tag;
+    MEM_SET_TAG(tag);
+}
+
+static void model_reset(void) {
+    g_live_count = 0;
+    g_depth = 0;
+    memset(g_tags_used, 0, sizeof(g_tags_used));
+    set_tag(MEM_TAG_OTHER);
+}
+
+static void model_push(size_t start, size_t end, uint8_t pattern) {
+    allocation_t *allocation = &g_live[g_live_count++];
+
+    allocation->start = start;
+    allocation->end = end;
+    allocation->pattern = pattern;
+    allocation->tag = g_tag;
+    memset(g_base + start, pattern, end - start);
+    g_tags_used[g_tag] += end - start;
+    if (g_tags_used[g_tag] > g_tags_high_water[g_tag]) {
+        g_tags_high_water[g_tag] = g_tags_used[g_tag];
+    }
+    if (end > g_high_water) {
+        g_high_water = end;
+    }
+}
+
+static void model_pop(void) {
+    allocation_t *allocation = &g_live[--g_live_count];
+
+    g_tags_used[allocation->tag] -= allocation->end - allocation->start;
+}
+
+static bool check_live(const char *op) {
+#ifdef HAVE_PROFILING
+    const mem_stats_t *stats = mem_get_stats();
+#endif
+
+    for (size_t i = 0; i < g_live_count; i++) {
+        const allocation_t *allocation = &g_live[i];
+
+        for (size_t j = allocation->start; j < allocation->end; j++) {
+            if (g_base[j] != allocation->pattern) {
+                fprintf(stderr, "%s: allocation #%zu overwritten\n", op, i);
+                return false;
+            }
+        }
+    }
+    if (top() != model_top()) {
+        fprintf(stderr, "%s: top at %zu instead of %zu\n", op, top(), model_top());
+        return false;
+    }
+#ifdef HAVE_PROFILING
+    if ((stats->used != model_top()) || (stats->high_water != g_high_water)) {
+        fprintf(stderr,
+                "%s: %u/%u bytes used/high water instead of %zu/%zu\n",
+                op,
+                stats->used,
+                stats->high_water,
+                model_top(),
+                g_high_water);
+        return false;
+    }
+    for (int tag = 0; tag < MEM_TAGS_COUNT; tag++) {
+        if (stats->tags_high_water[tag] != g_tags_high_water[tag]) {
+            fprintf(stderr,
+                    "%s: tag %d high water %u instead of %zu\n",
+                    op,
+                    tag,
+                    stats->tags_high_water[tag],
+                    g_tags_high_water[tag]);
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+static bool op_alloc(uint32_t *seed) {
+    uint32_t r = bench_rand(seed);
+    size_t size = r % 48;
+    size_t start = top();
+    uint8_t *ptr;
+
+    if (g_live_count == MAX_LIVE) {
+        return true;
+    }
+    if (r & 0x100) {
+        ptr = mem_alloc_and_align(size, 4);
+        if ((ptr != NULL) && (((uintptr_t) ptr % 4) != 0)) {
+            fprintf(stderr, "alloc: misaligned\n");
+            return false;
+        }
+    } else {
+        ptr = mem_alloc(size);
+    }
+    if (ptr == NULL) {
+        // exhausted, the alignment padding might still have been taken
+        if ((top() + size) <= MEM_SIZE) {
+            fprintf(stderr, "alloc: %zu bytes refused at %zu\n", size, top());
+            return false;
+        }
+        if (top() != start) {
+            model_push(start, top(), (uint8_t) r);
+        }
+        g_exhaustions += 1;
+        return true;
+    }
+    if ((size_t) ((ptr + size) - g_base) != top()) {
+        fprintf(stderr, "alloc: not at the top\n");
+        return false;
+    }
+    model_push(start, top(), (uint8_t) (r >> 16));
+    return true;
+}
+
+static void op_dealloc(void) {
+    size_t floor = (g_depth > 0) ? g_scopes[g_depth - 1].live_count : 0;
+
+    if (g_live_count > floor) {
+        mem_dealloc(g_live[g_live_count - 1].end - g_live[g_live_count - 1].start);
+        model_pop();
+    }
+}
+
+static void op_enter(uint32_t *seed) {
+    scope_t *scope;
+
+    if (g_depth == MAX_DEPTH) {
+        return;
+    }
+    scope = &g_scopes[g_depth++];
+    scope->mark = mem_mark();
+    scope->live_count = g_live_count;
+    scope->parent_tag = g_tag;
+    set_tag(bench_rand(seed) % MEM_TAGS_COUNT);
+}
+
+static void op_leave(void) {
+    scope_t *scope;
+
+    if (g_depth == 0) {
+        return;
+    }
+    scope = &g_scopes[--g_depth];
+    mem_release(scope->mark);
+    while (g_live_count > scope->live_count) {
+        model_pop();
+    }
+    set_tag(scope->parent_tag);
+}
+
+static bool stress(uint32_t ops) {
+    uint32_t seed = 0x3e3a110c;
+    const char *op;
+
+    mem_init();
+    g_base = mem_alloc(0);
+    model_reset();
+    for (uint32_t i = 0; i < ops; i++) {
+        uint32_t r = bench_rand(&seed) % 100;
+        uint32_t exhaustions = g_exhaustions;
+
+        if (r < 60) {
+            op = "alloc";
+            if (!op_alloc(&seed)) {
+                return false;
+            }
+        } else if (r < 80) {
+            op = "dealloc";
+            op_dealloc();
+        } else if (r < 90) {
+            op = "mark";
+            op_enter(&seed);
+        } else {
+            op = "release";
+            op_leave();
+        }
+        if (!check_live(op)) {
+            return false;
+        }
+        if (mem_available() != (MEM_SIZE - top())) {
+            fprintf(stderr, "%s: %zu bytes reported available\n", op, mem_available());
+            return false;
+        }
+        // start over once the buffer is full
+        if (g_exhaustions != exhaustions) {
+            mem_reset();
+            model_reset();
+        }
+    }
+    if (g_exhaustions == 0) {
+        fprintf(stderr, "buffer never exhausted\n");
+        return false;
+    }
+#ifdef HAVE_PROFILING
+    mem_reset_stats();
+    if (mem_get_stats()->high_water != model_top()) {
+        fprintf(stderr, "high water not reset\n");
+        return false;
+    }
+#endif
+    printf("stress      %u operations ok, buffer of %u bytes exhausted %u times\n",
+           ops,
+           MEM_SIZE,
+           g_exhaustions);
+    return true;
+}
+
+static void bench_scopes(uint32_t iterations) {
+    static const size_t sizes[] = {1, 32, 4, 200, 1, 32, 16, 2};
+    uint64_t start;
+    uint64_t ns;
+
+    mem_init();
+    start = bench_ns();
+    for (uint32_t it = 0; it < iterations; it++) {
+        mem_mark_t mark = mem_mark();
+
+        for (int i = 0; i < ALLOCS_PER_SCOPE; i++) {
+            void *volatile ptr = mem_alloc(sizes[i % ARRAY_SIZE(sizes)]);
+
+            (void) ptr;
+        }
+        mem_release(mark);
+    }
+    ns = bench_ns() - start;
+    printf("scopes      %u x %u allocations: %.1f ns/allocation\n",
+           iterations,
+           ALLOCS_PER_SCOPE,
+           (double) ns / ((double) iterations * ALLOCS_PER_SCOPE));
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!stress(STRESS_OPS)) {
+        return EXIT_FAILURE;
+    }
+    bench_scopes(iterations);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,478 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Multicall plugin benchmark
+//
+// Feeds multicall(bytes[]), multicall(uint256,bytes[]) and Safe multiSend(bytes) batches of
+// ERC-20 calls to the plugin the way the calldata is received, in batches of parameters of every
+// size, and checks the screens of the decoded calls, then that the batches it can not decode
+// entirely are left to the blind signing. Then times the decoding of a batch of ERC-20 calls.
+//
+// Usage: bench_multicall [-n iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared_context.h"
+#include "manage_asset_info.h"
+#include "eth_plugin_internal.h"
+#include "eth_plugin_handler.h"
+#include "plugin_utils.h"
+#include "multicall_plugin.h"
+#include "bench.h"
+
+#define DEFAULT_ITERATIONS 20000
+
+#define MAX_CALLDATA 1024
+
+// largest batch of parameters given to the plugin
+#define MAX_BATCH_WORDS 8
+
+#define NO_SCREENS (-1)
+
+typedef struct {
+    uint8_t data[MAX_CALLDATA];
+    size_t size;
+} calldata_t;
+
+static const uint8_t SELECTOR_MULTICALL[] = {0xac, 0x96, 0x50, 0xd8};
+static const uint8_t SELECTOR_MULTICALL_DEADLINE[] = {0x5a, 0xe4, 0x01, 0xdc};
+static const uint8_t SELECTOR_MULTISEND[] = {0x8d, 0x80, 0xff, 0x0a};
+static const uint8_t SELECTOR_TRANSFER[] = {0xa9, 0x05, 0x9c, 0xbb};
+static const uint8_t SELECTOR_APPROVE[] = {0x09, 0x5e, 0xa7, 0xb3};
+static const uint8_t SELECTOR_UNKNOWN[] = {0xde, 0xad, 0xbe, 0xef};
+
+static const uint8_t g_token[ADDRESS_LENGTH] = {0x6b, 0x17, 0x54, 0x74, 0xe8, 0x90, 0x94,
+                                                0xc4, 0x4d, 0xa9, 0x8b, 0x95, 0x4e, 0xed,
+                                                0xea, 0xc4, 0x95, 0x27, 0x1d, 0x0f};
+static const uint8_t g_unknown_token[ADDRESS_LENGTH] = {0x11, 0x22, 0x33};
+static const uint8_t g_safe_multisend[ADDRESS_LENGTH] = {0x40, 0xa2, 0xac, 0xcb, 0xd9, 0x2b, 0xca,
+                                                         0x93, 0x8b, 0x02, 0x01, 0x0e, 0x17, 0xa5,
+                                                         0xb8, 0x92, 0x9b, 0x49, 0x13, 0x0d};
+static const uint8_t g_alice[ADDRESS_LENGTH] = {0xa1, 0x1c, 0xe0};
+static const uint8_t g_bob[ADDRESS_LENGTH] = {0xb0, 0xb0};
+
+static void put(calldata_t *out, const uint8_t *data, size_t size) {
+    memcpy(out->data + out->size, data, size);
+    out->size += size;
+}
+
+static void put_uint(calldata_t *out, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        out->data[out->size + i] = (value >> (8 * (size - 1 - i))) & 0xff;
+    }
+    out->size += size;
+}
+
+static void put_word(calldata_t *out, uint64_t value) {
+    memset(out->data + out->size, 0, INT256_LENGTH - sizeof(value));
+    out->size += INT256_LENGTH - sizeof(value);
+    put_uint(out, value, sizeof(value));
+}
+
+static void put_address_word(calldata_t *out, const uint8_t *address) {
+    memset(out->data + out->size, 0, INT256_LENGTH - ADDRESS_LENGTH);
+    out->size += INT256_LENGTH - ADDRESS_LENGTH;
+    put(out, address, ADDRESS_LENGTH);
+}
+
+static void pad(calldata_t *out) {
+    while ((out->size - SELECTOR_SIZE) % INT256_LENGTH) {
+        out->data[out->size++] = 0;
+    }
+}
+
+static void erc20_call(calldata_t *out,
+                       const uint8_t *selector,
+                       const uint8_t *to,
+                       uint64_t amount) {
+    out->size = 0;
+    put(out, selector, SELECTOR_SIZE);
+    put_address_word(out, to);
+    put_word(out, amount);
+}
+
+/**
+ * Encode a multicall, in the canonical encoding unless the offset of its first call is shifted
+ *
+ * @param[out] out the calldata
+ * @param[in] deadline whether to encode multicall(uint256,bytes[])
+ * @param[in] calls the calls
+ * @param[in] count their number
+ * @param[in] shift added to the offset of the first call
+ */
+static void multicall(calldata_t *out,
+                      bool deadline,
+                      const calldata_t *calls,
+                      size_t count,
+                      uint32_t shift) {
+    uint32_t offset = count * INT256_LENGTH;
+
+    out->size = 0;
+    if (deadline) {
+        put(out, SELECTOR_MULTICALL_DEADLINE, SELECTOR_SIZE);
+        put_word(out, 1700000000);
+        put_word(out, 2 * INT256_LENGTH);
+    } else {
+        put(out, SELECTOR_MULTICALL, SELECTOR_SIZE);
+        put_word(out, INT256_LENGTH);
+    }
+    put_word(out, count);
+    for (size_t i = 0; i < count; i++) {
+        put_word(out, offset + ((i == 0) ? shift : 0));
+        offset += INT256_LENGTH +
+                  (calls[i].size + INT256_LENGTH - 1) / INT256_LENGTH * INT256_LENGTH;
+    }
+    for (size_t i = 0; i < count; i++) {
+        put_word(out, calls[i].size);
+        put(out, calls[i].data, calls[i].size);
+        pad(out);
+    }
+}
+
+static void multisend_tx(calldata_t *out,
+                         uint8_t operation,
+                         const uint8_t *to,
+                         uint64_t value,
+                         const calldata_t *data) {
+    put_uint(out, operation, 1);
+    put(out, to, ADDRESS_LENGTH);
+    put_word(out, value);
+    put_word(out, (data != NULL) ? data->size : 0);
+    if (data != NULL) {
+        put(out, data->data, data->size);
+    }
+}
+
+static void multisend(calldata_t *out, const calldata_t *transactions) {
+    out->size = 0;
+    put(out, SELECTOR_MULTISEND, SELECTOR_SIZE);
+    put_word(out, INT256_LENGTH);
+    put_word(out, transactions->size);
+    put(out, transactions->data, transactions->size);
+    pad(out);
+}
+
+static void set_tx(const uint8_t *destination, uint64_t value) {
+    memset(&tmpContent.txContent, 0, sizeof(tmpContent.txContent));
+    memcpy(tmpContent.txContent.destination, destination, ADDRESS_LENGTH);
+    tmpContent.txContent.destinationLength = ADDRESS_LENGTH;
+    memset(tmpContent.txContent.value.value, 0, INT256_LENGTH);
+    for (size_t i = 0; i < sizeof(value); i++) {
+        tmpContent.txContent.value.value[INT256_LENGTH - 1 - i] = (value >> (8 * i)) & 0xff;
+    }
+    tmpContent.txContent.value.length = INT256_LENGTH;
+}
+
+/**
+ * Decode a batch sent to the destination of the current transaction
+ *
+ * @param[in] calldata the calldata
+ * @param[in] batch_words number of parameters given to the plugin at once
+ * @return the number of screens, NO_SCREENS if the batch is left to the blind signing
+ */
+static int decode(const calldata_t *calldata, size_t batch_words) {
+    ethPluginSharedRO_t pluginRO = {.txContent = &tmpContent.txContent};
+    ethPluginInitContractExt_t init;
+    ethPluginProvideParameters_t provide;
+    ethPluginFinalize_t finalize;
+    uint8_t parameters[MAX_BATCH_WORDS * INT256_LENGTH];
+    size_t offset = SELECTOR_SIZE;
+
+    eth_plugin_prepare_init(&init, calldata->data, calldata->size);
+    init.base.pluginSharedRO = &pluginRO;
+    multicall_plugin_call(ETH_PLUGIN_INIT_CONTRACT, &init);
+    if ((init.base.result != ETH_PLUGIN_RESULT_OK) ||
+        !(init.capabilities & ETH_PLUGIN_CAPABILITY_BATCH_PARAMETERS)) {
+        return NO_SCREENS;
+    }
+    while (offset < calldata->size) {
+        size_t size = MIN(batch_words * INT256_LENGTH, calldata->size - offset);
+        size_t count = (size + INT256_LENGTH - 1) / INT256_LENGTH;
+
+        // the last parameter is padded with zeros, like in the app
+        memset(parameters, 0, sizeof(parameters));
+        memcpy(parameters, calldata->data + offset, size);
+        eth_plugin_prepare_provide_parameters(&provide, parameters, offset, count);
+        multicall_plugin_call(ETH_PLUGIN_PROVIDE_PARAMETER, &provide);
+        if (provide.base.result != ETH_PLUGIN_RESULT_OK) {
+            return NO_SCREENS;
+        }
+        offset += size;
+    }
+    eth_plugin_prepare_finalize(&finalize);
+    finalize.pluginSharedRO = &pluginRO;
+    multicall_plugin_call(ETH_PLUGIN_FINALIZE, &finalize);
+    if (finalize.result != ETH_PLUGIN_RESULT_OK) {
+        return NO_SCREENS;
+    }
+    return finalize.numScreens;
+}
+
+/**
+ * Format all the screens of the decoded batch
+ *
+ * @param[in] count number of screens
+ * @param[out] out the titles and values, one screen per line
+ * @param[in] out_size size of the output buffer
+ * @return whether every screen could be formatted
+ */
+static bool format_screens(int count, char *out, size_t out_size) {
+    ethPluginSharedRO_t pluginRO = {.txContent = &tmpContent.txContent};
+    ethQueryContractUI_t query;
+    char title[32];
+    char msg[80];
+
+    out[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        memset(&query, 0, sizeof(query));
+        query.pluginSharedRO = &pluginRO;
+        strlcpy(query.network_ticker, "ETH", sizeof(query.network_ticker));
+        query.screenIndex = i;
+        query.title = title;
+        query.titleLength = sizeof(title);
+        query.msg = msg;
+        query.msgLength = sizeof(msg);
+        multicall_plugin_call(ETH_PLUGIN_QUERY_CONTRACT_UI, &query);
+        if (query.result != ETH_PLUGIN_RESULT_OK) {
+            fprintf(stderr, "screen #%d not formatted\n", i);
+            return false;
+        }
+        snprintf(out + strlen(out), out_size - strlen(out), "%s: %s\n", title, msg);
+    }
+    return true;
+}
+
+/**
+ * Decode a batch with every batch size, checking the screens are always the same
+ *
+ * @param[in] name name of the case
+ * @param[in] calldata the calldata
+ * @param[in] screens the expected number of screens, NO_SCREENS for a fallback
+ * @param[in] titles the expected titles, in order, NULL to not check them
+ * @return whether it was successful
+ */
+static bool check_batch(const char *name,
+                        const calldata_t *calldata,
+                        int screens,
+                        const char *const *titles) {
+    char expected[1024];
+    char formatted[1024];
+
+    for (size_t words = 1; words <= MAX_BATCH_WORDS; words++) {
+        int count = decode(calldata, words);
+
+        if (count != screens) {
+            fprintf(stderr, "%s: %d screens instead of %d\n", name, count, screens);
+            return false;
+        }
+        if (count == NO_SCREENS) {
+            continue;
+        }
+        if (!format_screens(count, formatted, sizeof(formatted))) {
+            fprintf(stderr, "%s: screens not formatted\n", name);
+            return false;
+        }
+        if (words == 1) {
+            memcpy(expected, formatted, sizeof(expected));
+        } else if (strcmp(expected, formatted) != 0) {
+            fprintf(stderr, "%s: other screens with %zu parameters at once\n", name, words);
+            return false;
+        }
+    }
+    if ((screens != NO_SCREENS) && (titles != NULL)) {
+        const char *line = expected;
+
+        for (int i = 0; i < screens; i++) {
+            size_t length = strlen(titles[i]);
+
+            if ((strncmp(line, titles[i], length) != 0) || (line[length] != ':')) {
+                fprintf(stderr, "%s: screen #%d is \"%.*s\"\n",
+                        name,
+                        i,
+                        (int) strcspn(line, "\n"),
+                        line);
+                return false;
+            }
+            line += strcspn(line, "\n") + 1;
+        }
+    }
+    printf("%-28s %s\n", name, (screens == NO_SCREENS) ? "blind signing" : "decoded");
+    return true;
+}
+
+static bool check_decoded(void) {
+    calldata_t calls[MULTICALL_MAX_CALLS];
+    calldata_t transactions;
+    calldata_t calldata;
+    static const char *const multicall_titles[] =
+        {"Call 1 of 2", "Amount", "Address", "Call 2 of 2", "Amount", "Address"};
+    static const char *const deadline_titles[] = {"Call 1 of 1", "Amount", "Address", "Amount"};
+    static const char *const multisend_titles[] =
+        {"Call 1 of 2", "Amount", "Call 2 of 2", "Amount", "Address"};
+    static const char *const nested_titles[] =
+        {"Call 1 of 2", "Amount", "Address", "Call 2 of 2", "Amount", "Address"};
+
+    set_tx(g_token, 0);
+    erc20_call(&calls[0], SELECTOR_APPROVE, g_alice, 1000);
+    erc20_call(&calls[1], SELECTOR_TRANSFER, g_bob, 5);
+    multicall(&calldata, false, calls, 2, 0);
+    if (!check_batch("multicall", &calldata, 6, multicall_titles)) {
+        return false;
+    }
+    // payable, the amount sent to the batch being shown last
+    set_tx(g_token, 1000000000000000000);
+    multicall(&calldata, true, calls + 1, 1, 0);
+    if (!check_batch("multicall with deadline", &calldata, 4, deadline_titles)) {
+        return false;
+    }
+
+    set_tx(g_safe_multisend, 0);
+    transactions.size = 0;
+    multisend_tx(&transactions, 0, g_alice, 1000000000000000000, NULL);
+    multisend_tx(&transactions, 0, g_token, 0, &calls[1]);
+    multisend(&calldata, &transactions);
+    if (!check_batch("multiSend", &calldata, 5, multisend_titles)) {
+        return false;
+    }
+
+    // multicall of the token in a multiSend
+    multicall(&calls[2], false, calls, 1, 0);
+    transactions.size = 0;
+    multisend_tx(&transactions, 0, g_token, 0, &calls[1]);
+    multisend_tx(&transactions, 0, g_token, 0, &calls[2]);
+    multisend(&calldata, &transactions);
+    return check_batch("nested multicall", &calldata, 6, nested_titles);
+}
+
+static bool check_fallbacks(void) {
+    calldata_t calls[MULTICALL_MAX_CALLS + 1];
+    calldata_t transactions;
+    calldata_t calldata;
+
+    set_tx(g_token, 0);
+    erc20_call(&calls[0], SELECTOR_TRANSFER, g_bob, 5);
+    erc20_call(&calls[1], SELECTOR_UNKNOWN, g_bob, 5);
+    multicall(&calldata, false, calls, 2, 0);
+    if (!check_batch("unknown selector", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+    multicall(&calldata, false, calls, 1, INT256_LENGTH);
+    if (!check_batch("non-canonical offset", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+    for (size_t i = 1; i <= MULTICALL_MAX_CALLS; i++) {
+        memcpy(&calls[i], &calls[0], sizeof(calls[i]));
+    }
+    multicall(&calldata, false, calls, MULTICALL_MAX_CALLS + 1, 0);
+    if (!check_batch("too many calls", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+    multicall(&calldata, false, calls, 0, 0);
+    if (!check_batch("empty multicall", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+    // truncated, the last call ending after the calldata
+    multicall(&calldata, false, calls, 1, 0);
+    calldata.size -= INT256_LENGTH;
+    if (!check_batch("truncated multicall", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+    // token without description
+    set_tx(g_unknown_token, 0);
+    multicall(&calldata, false, calls, 1, 0);
+    if (!check_batch("unknown token", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+
+    set_tx(g_safe_multisend, 0);
+    transactions.size = 0;
+    multisend_tx(&transactions, 1, g_token, 0, &calls[0]);
+    multisend(&calldata, &transactions);
+    if (!check_batch("delegate call", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+    // call of a nested batch sending some value
+    multicall(&calls[1], false, calls, 1, 0);
+    transactions.size = 0;
+    multisend_tx(&transactions, 0, g_token, 1, &calls[1]);
+    multisend(&calldata, &transactions);
+    if (!check_batch("value sent to a batch", &calldata, NO_SCREENS, NULL)) {
+        return false;
+    }
+    // ERC-20 calls do not send any value
+    transactions.size = 0;
+    multisend_tx(&transactions, 0, g_token, 1, &calls[0]);
+    multisend(&calldata, &transactions);
+    return check_batch("value sent to a token", &calldata, NO_SCREENS, NULL);
+}
+
+static void bench_decode(uint32_t iterations) {
+    calldata_t calls[MULTICALL_MAX_CALLS];
+    calldata_t calldata;
+    uint64_t start;
+    uint64_t ticks;
+
+    set_tx(g_token, 0);
+    for (size_t i = 0; i < MULTICALL_MAX_CALLS; i++) {
+        erc20_call(&calls[i], (i % 2) ? SELECTOR_TRANSFER : SELECTOR_APPROVE, g_bob, i);
+    }
+    multicall(&calldata, false, calls, MULTICALL_MAX_CALLS, 0);
+    start = bench_ticks();
+    for (uint32_t it = 0; it < iterations; it++) {
+        int volatile screens = decode(&calldata, MAX_BATCH_WORDS);
+
+        (void) screens;
+    }
+    ticks = bench_ticks() - start;
+    printf("decode      %u x %u ERC-20 calls (%zu bytes): %.1f %s/batch, %.2f %s/byte\n",
+           iterations,
+           MULTICALL_MAX_CALLS,
+           calldata.size,
+           (double) ticks / iterations,
+           bench_ticks_unit(),
+           (double) ticks / ((double) iterations * calldata.size),
+           bench_ticks_unit());
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    tokenDefinition_t *token;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    reset_app_context();
+    token = &get_current_asset_info()->token;
+    memcpy(token->address, g_token, ADDRESS_LENGTH);
+    strlcpy(token->ticker, "DAI", sizeof(token->ticker));
+    token->decimals = 18;
+    validate_current_asset_info();
+
+    if (!check_decoded() || !check_fallbacks()) {
+        return EXIT_FAILURE;
+    }
+    bench_decode(iterations);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Internal plugin selector dispatch benchmark
+//
+// Checks that the generated selector table is sorted and matches INTERNAL_ETH_PLUGINS, then
+// times its binary search against the nested loop over the plugins and their selectors.
+//
+// Usage: bench_selectors [-n iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "eth_plugin_internal.h"
+#include "plugin_utils.h"
+#include "plugin_selectors.gen.h"
+#include "bench.h"
+
+#define DEFAULT_ITERATIONS 200000
+
+// a few known selectors, then random ones
+#define NUM_SAMPLES 16
+
+void erc20_plugin_call(int message, void *parameters) {
+    (void) message;
+    (void) parameters;
+}
+
+// Lookup as done before the generated table
+static int ref_find_plugin(const uint8_t *selector) {
+    for (int i = 0; INTERNAL_ETH_PLUGINS[i].selectors != NULL; i++) {
+        for (int j = 0; j < INTERNAL_ETH_PLUGINS[i].num_selectors; j++) {
+            if (memcmp(selector, INTERNAL_ETH_PLUGINS[i].selectors[j], SELECTOR_SIZE) == 0) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+// Same binary search as eth_plugin_perform_init_old_internal
+static int find_plugin(const uint8_t *selector) {
+    uint32_t value = ((uint32_t) selector[0] << 24) | ((uint32_t) selector[1] << 16) |
+                     ((uint32_t) selector[2] << 8) | selector[3];
+    size_t low = 0;
+    size_t high = g_internal_plugin_selectors_count;
+
+    while (low < high) {
+        size_t mid = low + ((high - low) / 2);
+
+        if (g_internal_plugin_selectors[mid].selector < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if ((low < g_internal_plugin_selectors_count) &&
+        (g_internal_plugin_selectors[low].selector == value)) {
+        return g_internal_plugin_selectors[low].plugin;
+    }
+    return -1;
+}
+
+static bool check_table(void) {
+    size_t count = 0;
+
+    for (size_t i = 1; i < g_internal_plugin_selectors_count; i++) {
+        if (g_internal_plugin_selectors[i - 1].selector > g_internal_plugin_selectors[i].selector) {
+            fprintf(stderr, "selector table not sorted at #%zu\n", i);
+            return false;
+        }
+    }
+    for (int i = 0; INTERNAL_ETH_PLUGINS[i].selectors != NULL; i++) {
+        for (int j = 0; j < INTERNAL_ETH_PLUGINS[i].num_selectors; j++) {
+            const uint8_t *selector = INTERNAL_ETH_PLUGINS[i].selectors[j];
+
+            if (find_plugin(selector) != ref_find_plugin(selector)) {
+                fprintf(stderr,
+                        "selector %02x%02x%02x%02x of %s not dispatched like before\n",
+                        selector[0],
+                        selector[1],
+                        selector[2],
+                        selector[3],
+                        INTERNAL_ETH_PLUGINS[i].alias);
+                return false;
+            }
+            count += 1;
+        }
+    }
+    if (count != g_internal_plugin_selectors_count) {
+        fprintf(stderr,
+                "%zu selectors in the table instead of %zu\n",
+                g_internal_plugin_selectors_count,
+                count);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t seed = 0x5e1ec7;
+    uint8_t samples[NUM_SAMPLES][SELECTOR_SIZE];
+    uint64_t ticks[2];
+    size_t known = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!check_table()) {
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; INTERNAL_ETH_PLUGINS[i].selectors != NULL; i++) {
+        for (int j = 0; (j < INTERNAL_ETH_PLUGINS[i].num_selectors) && (known < NUM_SAMPLES / 2);
+             j++) {
+            memcpy(samples[known++], INTERNAL_ETH_PLUGINS[i].selectors[j], SELECTOR_SIZE);
+        }
+    }
+    for (size_t i = known; i < NUM_SAMPLES; i++) {
+        bench_rand_bytes(&seed, samples[i], SELECTOR_SIZE);
+    }
+
+    for (int impl = 0; impl < 2; impl++) {
+        uint64_t start = bench_ticks();
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (size_t i = 0; i < NUM_SAMPLES; i++) {
+                int volatile plugin;
+
+                if (impl == 0) {
+                    plugin = ref_find_plugin(samples[i]);
+                } else {
+                    plugin = find_plugin(samples[i]);
+                }
+                (void) plugin;
+            }
+        }
+        ticks[impl] = bench_ticks() - start;
+    }
+    printf("dispatch    %3zu selectors %10.1f %s/call (loop) %10.1f %s/call %8.1fx\n",
+           g_internal_plugin_selectors_count,
+           (double) ticks[0] / ((double) iterations * NUM_SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[1] / ((double) iterations * NUM_SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[0] / (double) ticks[1]);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Signature verification cache benchmark
+//
+// Checks which verifications are skipped, the least recently used eviction and the reset, then
+// replays a client which provides the same descriptors for every transaction and counts the
+// ECDSA verifications left. The mocked verification is only a hash, the time saved on a device
+// is the one of a secp256k1 verification per cached descriptor.
+//
+// Usage: bench_sig_cache [-n iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cx.h"
+#include "sig_cache.h"
+#include "bench.h"
+
+#define DEFAULT_ITERATIONS 20000
+
+// descriptors provided for every transaction
+#define DESCRIPTORS_PER_TX 3
+
+static const uint8_t g_key[] = {0x04, 0x5e, 0x6c, 0x10, 0x20, 0xc1, 0x4d, 0xc4, 0x64, 0x42};
+static const uint8_t g_other_key[] = {0x04, 0x6a, 0x94, 0xe7, 0xa4, 0x2c, 0xd0, 0xc3, 0x3f, 0xdf};
+
+static uint8_t g_hashes[2 * SIG_CACHE_SIZE][32];
+static uint8_t g_sigs[2 * SIG_CACHE_SIZE][32];
+
+static void sign(const uint8_t *key, size_t key_len, const uint8_t *hash, uint8_t *sig) {
+    cx_sha256_t ctx;
+
+    cx_sha256_init_no_throw(&ctx);
+    cx_hash_no_throw((cx_hash_t *) &ctx, 0, key, key_len, NULL, 0);
+    cx_hash_no_throw((cx_hash_t *) &ctx, CX_LAST, hash, 32, sig, 32);
+}
+
+static bool verify(size_t i) {
+    return sig_cache_verify(g_key, sizeof(g_key), g_hashes[i], 32, g_sigs[i], 32);
+}
+
+// whether the i-th descriptor is accepted, and with an actual verification or not
+static bool expect(size_t i, bool verified) {
+    uint32_t calls = g_cx_ecdsa_verify_calls;
+
+    if (!verify(i)) {
+        fprintf(stderr, "descriptor #%zu rejected\n", i);
+        return false;
+    }
+    if ((g_cx_ecdsa_verify_calls != calls) != verified) {
+        fprintf(stderr, "descriptor #%zu %s verified\n", i, verified ? "not" : "still");
+        return false;
+    }
+    return true;
+}
+
+static bool check_cache(void) {
+    uint8_t bad_sig[32];
+    uint32_t calls;
+
+    sig_cache_reset();
+    for (size_t i = 0; i < SIG_CACHE_SIZE; i++) {
+        if (!expect(i, true)) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < SIG_CACHE_SIZE; i++) {
+        if (!expect(i, false)) {
+            return false;
+        }
+    }
+    // failures are never cached
+    memcpy(bad_sig, g_sigs[0], sizeof(bad_sig));
+    bad_sig[0] ^= 1;
+    for (int i = 0; i < 2; i++) {
+        calls = g_cx_ecdsa_verify_calls;
+        if (sig_cache_verify(g_key, sizeof(g_key), g_hashes[0], 32, bad_sig, sizeof(bad_sig)) ||
+            (g_cx_ecdsa_verify_calls == calls)) {
+            fprintf(stderr, "bad signature accepted\n");
+            return false;
+        }
+    }
+    // a known hash & signature under another key is verified again
+    calls = g_cx_ecdsa_verify_calls;
+    if (sig_cache_verify(g_other_key, sizeof(g_other_key), g_hashes[0], 32, g_sigs[0], 32) ||
+        (g_cx_ecdsa_verify_calls == calls)) {
+        fprintf(stderr, "signature accepted under another key\n");
+        return false;
+    }
+    // #0 is now the least recently used one, then #1...
+    for (size_t i = 0; i < SIG_CACHE_SIZE; i++) {
+        if (!expect(SIG_CACHE_SIZE + i, true)) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < SIG_CACHE_SIZE; i++) {
+        if (!expect(SIG_CACHE_SIZE + i, false)) {
+            return false;
+        }
+    }
+    if (!expect(0, true) || !expect(SIG_CACHE_SIZE, true)) {
+        return false;
+    }
+    sig_cache_reset();
+    return expect(0, true);
+}
+
+static void bench_session(uint32_t iterations) {
+    uint32_t calls = g_cx_ecdsa_verify_calls;
+    uint64_t start;
+    uint64_t ticks;
+
+    sig_cache_reset();
+    start = bench_ticks();
+    for (uint32_t it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < DESCRIPTORS_PER_TX; i++) {
+            bool volatile valid = verify(i);
+
+            (void) valid;
+        }
+    }
+    ticks = bench_ticks() - start;
+    printf("session     %u tx x %u descriptors: %u ECDSA verifications instead of %u, %.1f %s/hit\n",
+           iterations,
+           DESCRIPTORS_PER_TX,
+           g_cx_ecdsa_verify_calls - calls,
+           iterations * DESCRIPTORS_PER_TX,
+           (double) ticks / ((double) iterations * DESCRIPTORS_PER_TX),
+           bench_ticks_unit());
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t seed = 0x516ca7e;
+    const sig_cache_stats_t *stats;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < (2 * SIG_CACHE_SIZE); i++) {
+        bench_rand_bytes(&seed, g_hashes[i], sizeof(g_hashes[i]));
+        sign(g_key, sizeof(g_key), g_hashes[i], g_sigs[i]);
+    }
+    if (!check_cache()) {
+        return EXIT_FAILURE;
+    }
+    bench_session(iterations);
+    stats = get_sig_cache_stats();
+    printf("hits %u, misses %u, evictions %u\n", stats->hits, stats->misses, stats->evictions);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,576 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Transaction parser throughput benchmark
+//
+// Replays corpora of transactions through initTx() / processTx() / continueTx() the same way
+// handleSign() does, split into APDU-sized chunks, and checks that the streamed hash matches the
+// Keccak of the whole payload.
+//
+// Usage: bench_tx [-n iterations] [corpus.hex ...]
+//   Without corpus files, deterministic corpora are generated for every transaction type.
+//   A corpus file holds one hex encoded transaction per line, typed transactions being prefixed
+//   with their EIP-2718 type byte.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared_context.h"
+#include "feature_signTx.h"
+#include "eth_plugin_interface.h"
+#include "bench.h"
+
+#define APDU_MAX_PAYLOAD     255
+#define BIP32_PAYLOAD_LENGTH (1 + 5 * sizeof(uint32_t))
+#define MAX_TX_SIZE          (32 * 1024)
+#define MAX_CORPUS_SIZE      256
+#define GENERATED_CORPUS_SIZE 64
+#define DEFAULT_ITERATIONS   200
+
+typedef struct {
+    uint8_t *raw;
+    size_t length;
+    // offsets in raw on which an APDU chunk must not end, 0 if none
+    size_t selector_offset;
+    size_t v_offset;
+    // offset in raw of the destination address, 0 if unknown
+    size_t to_offset;
+    // blob hashes or authorizations, for the types that have them
+    uint32_t list_count;
+    uint32_t access_list_addresses;
+    uint32_t access_list_keys;
+} bench_tx_t;
+
+typedef struct {
+    const char *name;
+    uint8_t type;
+    uint8_t fields;
+    bench_tx_t txs[MAX_CORPUS_SIZE];
+    size_t count;
+} bench_corpus_t;
+
+typedef struct {
+    uint64_t txs;
+    uint64_t bytes;
+    uint64_t apdus;
+    uint64_t fields;
+    uint64_t plugin_calls;
+    uint64_t ticks;
+    uint64_t ns;
+} bench_result_t;
+
+static bench_corpus_t g_corpora[] = {
+    {.name = "LEGACY", .type = LEGACY, .fields = 9},
+    {.name = "EIP2930", .type = EIP2930, .fields = 8},
+    {.name = "EIP1559", .type = EIP1559, .fields = 9},
+    {.name = "EIP4844", .type = EIP4844, .fields = 11},
+    {.name = "EIP7702", .type = EIP7702, .fields = 10},
+};
+
+// RLP encoding helpers
+
+static size_t rlp_put_length(uint8_t *out, size_t length, uint8_t short_base, uint8_t long_base) {
+    size_t be_len = 0;
+
+    if (length <= 55) {
+        out[0] = short_base + (uint8_t) length;
+        return 1;
+    }
+    for (size_t tmp = length; tmp != 0; tmp >>= 8) {
+        be_len += 1;
+    }
+    out[0] = long_base + (uint8_t) be_len;
+    for (size_t i = 0; i < be_len; i++) {
+        out[1 + i] = (uint8_t) (length >> (8 * (be_len - 1 - i)));
+    }
+    return 1 + be_len;
+}
+
+static size_t rlp_put_string(uint8_t *out, const uint8_t *data, size_t length) {
+    size_t off;
+
+    if ((length == 1) && (data[0] < 0x80)) {
+        out[0] = data[0];
+        return 1;
+    }
+    off = rlp_put_length(out, length, 0x80, 0xb7);
+    memmove(out + off, data, length);
+    return off + length;
+}
+
+static size_t rlp_put_uint(uint8_t *out, uint64_t value) {
+    uint8_t be[sizeof(value)];
+    size_t len = 0;
+
+    for (uint64_t tmp = value; tmp != 0; tmp >>= 8) {
+        len += 1;
+    }
+    for (size_t i = 0; i < len; i++) {
+        be[i] = (uint8_t) (value >> (8 * (len - 1 - i)));
+    }
+    return rlp_put_string(out, be, len);
+}
+
+static size_t rlp_put_list(uint8_t *out, const uint8_t *payload, size_t length) {
+    size_t off = rlp_put_length(out, length, 0xc0, 0xf7);
+
+    memmove(out + off, payload, length);
+    return off + length;
+}
+
+// Corpus generation
+
+// Plain transfers, ERC-20 transfers/approvals, swaps and larger contract calls
+static const size_t DATA_SIZES[] = {0, 68, 68, 132, 196, 356, 1028, 4100};
+
+static size_t gen_access_list(uint8_t *out,
+                              uint32_t *seed,
+                              uint8_t entries,
+                              uint32_t *keys_count) {
+    uint8_t list[1024];
+    size_t list_off = 0;
+
+    for (uint8_t i = 0; i < entries; i++) {
+        uint8_t entry[256];
+        uint8_t keys[256];
+        uint8_t value[32];
+        size_t entry_off = 0;
+        size_t keys_off = 0;
+        uint8_t nkeys = (uint8_t) (bench_rand(seed) % 4);
+
+        *keys_count += nkeys;
+        bench_rand_bytes(seed, value, ADDRESS_LENGTH);
+        entry_off += rlp_put_string(entry, value, ADDRESS_LENGTH);
+        for (uint8_t k = 0; k < nkeys; k++) {
+            bench_rand_bytes(seed, value, sizeof(value));
+            keys_off += rlp_put_string(keys + keys_off, value, sizeof(value));
+        }
+        entry_off += rlp_put_list(entry + entry_off, keys, keys_off);
+        list_off += rlp_put_list(list + list_off, entry, entry_off);
+    }
+    return rlp_put_list(out, list, list_off);
+}
+
+static size_t gen_blob_hashes(uint8_t *out, uint32_t *seed, uint8_t count) {
+    uint8_t list[6 * (1 + 32)];
+    size_t list_off = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t hash[32];
+
+        bench_rand_bytes(seed, hash, sizeof(hash));
+        hash[0] = 0x01;  // KZG version
+        list_off += rlp_put_string(list + list_off, hash, sizeof(hash));
+    }
+    return rlp_put_list(out, list, list_off);
+}
+
+static size_t gen_authorization_list(uint8_t *out, uint32_t *seed, uint8_t count) {
+    uint8_t list[1024];
+    size_t list_off = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t tuple[256];
+        uint8_t value[32];
+        size_t tuple_off = 0;
+
+        tuple_off += rlp_put_uint(tuple + tuple_off, 1);  // chain ID
+        bench_rand_bytes(seed, value, ADDRESS_LENGTH);
+        tuple_off += rlp_put_string(tuple + tuple_off, value, ADDRESS_LENGTH);
+        tuple_off += rlp_put_uint(tuple + tuple_off, bench_rand(seed) % 1000);  // nonce
+        tuple_off += rlp_put_uint(tuple + tuple_off, bench_rand(seed) & 1);     // y parity
+        bench_rand_bytes(seed, value, sizeof(value));
+        tuple_off += rlp_put_string(tuple + tuple_off, value, sizeof(value));  // r
+        bench_rand_bytes(seed, value, sizeof(value));
+        tuple_off += rlp_put_string(tuple + tuple_off, value, sizeof(value));  // s
+        list_off += rlp_put_list(list + list_off, tuple, tuple_off);
+    }
+    return rlp_put_list(out, list, list_off);
+}
+
+static void gen_tx(bench_tx_t *tx, uint8_t type, uint32_t *seed, size_t data_size) {
+    uint8_t *body = malloc(MAX_TX_SIZE);
+    uint8_t *data = malloc(data_size + 1);
+    uint8_t addr[ADDRESS_LENGTH];
+    uint8_t header[1 + 5];
+    size_t header_len = 0;
+    size_t off = 0;
+    size_t data_offset;
+    size_t to_offset;
+    size_t v_offset = 0;
+    uint32_t list_count = 0;
+
+    bench_rand_bytes(seed, addr, sizeof(addr));
+    bench_rand_bytes(seed, data, data_size);
+
+    if (type != LEGACY) {
+        off += rlp_put_uint(body + off, 1);  // chain ID
+    }
+    off += rlp_put_uint(body + off, bench_rand(seed) % 1000);  // nonce
+    if ((type != LEGACY) && (type >= EIP1559)) {
+        off += rlp_put_uint(body + off, 1000000000ull);  // max priority fee per gas
+    }
+    off += rlp_put_uint(body + off, 20000000000ull + bench_rand(seed));  // (max fee per) gas price
+    off += rlp_put_uint(body + off, 21000 + data_size * 16);             // gas limit
+    to_offset = off + 1;
+    off += rlp_put_string(body + off, addr, sizeof(addr));               // to
+    off += rlp_put_uint(body + off, ((uint64_t) bench_rand(seed) << 24) | bench_rand(seed));
+    off += rlp_put_length(body + off, data_size, 0x80, 0xb7);
+    data_offset = off;
+    memcpy(body + off, data, data_size);
+    off += data_size;
+    if (type == LEGACY) {
+        // EIP-155 signing payload
+        v_offset = off;
+        off += rlp_put_uint(body + off, 1);  // v = chain ID
+        off += rlp_put_uint(body + off, 0);  // r
+        off += rlp_put_uint(body + off, 0);  // s
+    } else {
+        tx->access_list_addresses = bench_rand(seed) % 3;
+        tx->access_list_keys = 0;
+        off += gen_access_list(body + off,
+                               seed,
+                               (uint8_t) tx->access_list_addresses,
+                               &tx->access_list_keys);
+    }
+    if (type == EIP4844) {
+        list_count = 1 + bench_rand(seed) % 6;
+        off += rlp_put_uint(body + off, 1 + bench_rand(seed) % 1000);  // max fee per blob gas
+        off += gen_blob_hashes(body + off, seed, (uint8_t) list_count);
+    } else if (type == EIP7702) {
+        list_count = 1 + bench_rand(seed) % 3;
+        off += gen_authorization_list(body + off, seed, (uint8_t) list_count);
+    }
+
+    if (type != LEGACY) {
+        header[header_len++] = type;
+    }
+    header_len += rlp_put_length(header + header_len, off, 0xc0, 0xf7);
+
+    tx->length = header_len + off;
+    tx->raw = malloc(tx->length);
+    memcpy(tx->raw, header, header_len);
+    memcpy(tx->raw + header_len, body, off);
+    tx->selector_offset = (data_size >= SELECTOR_LENGTH) ? (header_len + data_offset) : 0;
+    tx->v_offset = (type == LEGACY) ? (header_len + v_offset) : 0;
+    tx->to_offset = header_len + to_offset;
+    tx->list_count = list_count;
+    free(data);
+    free(body);
+}
+
+static void gen_corpora(void) {
+    uint32_t seed = 0x5eed1234;
+
+    for (size_t c = 0; c < ARRAYLEN(g_corpora); c++) {
+        for (size_t i = 0; i < GENERATED_CORPUS_SIZE; i++) {
+            gen_tx(&g_corpora[c].txs[i],
+                   g_corpora[c].type,
+                   &seed,
+                   DATA_SIZES[i % ARRAYLEN(DATA_SIZES)]);
+        }
+        g_corpora[c].count = GENERATED_CORPUS_SIZE;
+    }
+}
+
+static int hex_nibble(char c) {
+    if ((c >= '0') && (c <= '9')) return c - '0';
+    if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+    if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+    return -1;
+}
+
+static bool load_corpus(const char *path) {
+    FILE *f = fopen(path, "r");
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t line_len;
+
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    while ((line_len = getline(&line, &line_size, f)) > 0) {
+        bench_corpus_t *corpus = NULL;
+        bench_tx_t *tx;
+        size_t len = 0;
+        const char *hex = line;
+
+        while ((line_len > 0) && (hex_nibble(line[line_len - 1]) < 0)) {
+            line_len -= 1;
+        }
+        if ((line_len >= 2) && (hex[0] == '0') && ((hex[1] == 'x') || (hex[1] == 'X'))) {
+            hex += 2;
+            line_len -= 2;
+        }
+        if ((line_len <= 0) || (line_len % 2) != 0) {
+            continue;
+        }
+        tx = NULL;
+        {
+            int hi = hex_nibble(hex[0]);
+            int lo = hex_nibble(hex[1]);
+            uint8_t first = (uint8_t) ((hi << 4) | lo);
+
+            for (size_t c = 0; c < ARRAYLEN(g_corpora); c++) {
+                if ((first == g_corpora[c].type) ||
+                    ((first >= LEGACY) && (g_corpora[c].type == LEGACY))) {
+                    corpus = &g_corpora[c];
+                }
+            }
+        }
+        if ((corpus == NULL) || (corpus->count == MAX_CORPUS_SIZE)) {
+            continue;
+        }
+        tx = &corpus->txs[corpus->count];
+        memset(tx, 0, sizeof(*tx));
+        tx->raw = malloc(line_len / 2);
+        for (ssize_t i = 0; i < line_len; i += 2) {
+            int hi = hex_nibble(hex[i]);
+            int lo = hex_nibble(hex[i + 1]);
+
+            if ((hi < 0) || (lo < 0)) {
+                break;
+            }
+            tx->raw[len++] = (uint8_t) ((hi << 4) | lo);
+        }
+        tx->length = len;
+        corpus->count += 1;
+    }
+    free(line);
+    fclose(f);
+    return true;
+}
+
+// Replay
+
+// Size of the next APDU chunk, mimics the clients which never cut right before v (legacy
+// transactions) nor inside the function selector
+static size_t next_chunk_size(const bench_tx_t *tx, size_t offset) {
+    size_t size = APDU_MAX_PAYLOAD;
+
+    if (offset == 0) {
+        size -= BIP32_PAYLOAD_LENGTH;
+    }
+    if ((offset + size) >= tx->length) {
+        return tx->length - offset;
+    }
+    if ((tx->v_offset != 0) && ((offset + size) == tx->v_offset)) {
+        size -= 1;
+    }
+    if ((tx->selector_offset != 0) && ((offset + size) > tx->selector_offset) &&
+        ((offset + size) < (tx->selector_offset + SELECTOR_LENGTH))) {
+        size = tx->selector_offset - offset;
+    }
+    return size;
+}
+
+static bool replay_tx(const bench_tx_t *tx, uint64_t *apdus) {
+    const uint8_t *buffer = tx->raw;
+    size_t offset = 0;
+    parserStatus_e status = USTREAM_PROCESSING;
+
+    reset_app_context();
+    appState = APP_STATE_SIGNING_TX;
+    tmpContent.txContent.dataPresent = false;
+    dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_UNAVAILABLE;
+    initTx(&txContext, &global_sha3, &tmpContent.txContent, customProcessor, NULL);
+
+    while (offset < tx->length) {
+        size_t size = next_chunk_size(tx, offset);
+        const uint8_t *chunk = buffer + offset;
+        size_t chunk_size = size;
+
+        if ((offset == 0) && (*chunk <= MAX_TX_TYPE)) {
+            // EIP-2718 type prefix, handled by handleSign()
+            cx_hash_no_throw((cx_hash_t *) &global_sha3, 0, chunk, 1, NULL, 0);
+            txContext.txType = *chunk;
+            chunk += 1;
+            chunk_size -= 1;
+        } else if (offset == 0) {
+            txContext.txType = LEGACY;
+        }
+        *apdus += 1;
+        status = processTx(&txContext, chunk, chunk_size, 0);
+        while (status == USTREAM_SUSPENDED) {
+            status = continueTx(&txContext);
+        }
+        if ((status != USTREAM_PROCESSING) && (status != USTREAM_FINISHED)) {
+            return false;
+        }
+        offset += size;
+    }
+    return status == USTREAM_FINISHED;
+}
+
+static bool check_hash(const bench_tx_t *tx) {
+    cx_sha3_t sha3;
+    uint8_t expected[32];
+    uint8_t computed[32];
+
+    cx_hash_no_throw((cx_hash_t *) &global_sha3, CX_LAST, NULL, 0, computed, sizeof(computed));
+    cx_keccak_init_no_throw(&sha3, 256);
+    cx_hash_no_throw((cx_hash_t *) &sha3, CX_LAST, tx->raw, tx->length, expected, sizeof(expected));
+    return memcmp(expected, computed, sizeof(expected)) == 0;
+}
+
+static bool check_content(const bench_tx_t *tx) {
+    const txContent_t *content = &tmpContent.txContent;
+
+    if (tx->to_offset == 0) {
+        return true;
+    }
+    if ((txContext.summary.accessList.addresses != tx->access_list_addresses) ||
+        (txContext.summary.accessList.storageKeys != tx->access_list_keys)) {
+        return false;
+    }
+    if ((txContext.txType == EIP4844) && (txContext.summary.blobs.count != tx->list_count)) {
+        return false;
+    }
+    if ((txContext.txType == EIP7702) &&
+        (txContext.summary.authorizations.count != tx->list_count)) {
+        return false;
+    }
+    return (content->destinationLength == ADDRESS_LENGTH) &&
+           (memcmp(content->destination, tx->raw + tx->to_offset, ADDRESS_LENGTH) == 0) &&
+           (content->startgas.length != 0) && (content->gasprice.length != 0);
+}
+
+// The plugin must get the same parameters whether they are provided one by one or not
+static bool check_batch(const bench_tx_t *tx) {
+    uint64_t apdus = 0;
+    uint32_t parameters;
+    uint32_t digest;
+
+    g_bench_plugin_mode = BENCH_PLUGIN_ACCEPT;
+    g_bench_plugin_parameters = 0;
+    g_bench_plugin_digest = 0;
+    replay_tx(tx, &apdus);
+    parameters = g_bench_plugin_parameters;
+    digest = g_bench_plugin_digest;
+
+    g_bench_plugin_mode = BENCH_PLUGIN_BATCH;
+    g_bench_plugin_parameters = 0;
+    g_bench_plugin_digest = 0;
+    replay_tx(tx, &apdus);
+    return (g_bench_plugin_parameters == parameters) && (g_bench_plugin_digest == digest);
+}
+
+static bool run_corpus(const bench_corpus_t *corpus, uint32_t iterations, bench_result_t *res) {
+    uint64_t start_ns;
+    uint64_t start_ticks;
+
+    memset(res, 0, sizeof(*res));
+    // correctness pass, not timed
+    for (size_t i = 0; i < corpus->count; i++) {
+        uint64_t apdus = 0;
+
+        if (!replay_tx(&corpus->txs[i], &apdus)) {
+            fprintf(stderr, "%s: transaction #%zu was rejected by the parser\n", corpus->name, i);
+            return false;
+        }
+        if (!check_hash(&corpus->txs[i])) {
+            fprintf(stderr, "%s: transaction #%zu hash mismatch\n", corpus->name, i);
+            return false;
+        }
+        if (!check_content(&corpus->txs[i])) {
+            fprintf(stderr, "%s: transaction #%zu content mismatch\n", corpus->name, i);
+            return false;
+        }
+        if ((g_bench_plugin_mode == BENCH_PLUGIN_BATCH) && !check_batch(&corpus->txs[i])) {
+            fprintf(stderr, "%s: transaction #%zu parameters mismatch\n", corpus->name, i);
+            return false;
+        }
+    }
+
+    g_bench_plugin_calls = 0;
+    start_ns = bench_ns();
+    start_ticks = bench_ticks();
+    for (uint32_t it = 0; it < iterations; it++) {
+        for (size_t i = 0; i < corpus->count; i++) {
+            replay_tx(&corpus->txs[i], &res->apdus);
+            res->txs += 1;
+            res->bytes += corpus->txs[i].length;
+            res->fields += corpus->fields;
+        }
+    }
+    res->ticks = bench_ticks() - start_ticks;
+    res->ns = bench_ns() - start_ns;
+    res->plugin_calls = g_bench_plugin_calls;
+    return true;
+}
+
+static void print_result(const bench_corpus_t *corpus,
+                         const char *mode,
+                         const bench_result_t *res) {
+    double seconds = (double) res->ns / 1e9;
+
+    printf("%-8s %-8s %6zu tx %10.2f MB/s %10.1f %s/field %10.1f %s/APDU %6.1f plugin calls/tx\n",
+           corpus->name,
+           mode,
+           corpus->count,
+           ((double) res->bytes / (1024.0 * 1024.0)) / seconds,
+           (double) res->ticks / (double) res->fields,
+           bench_ticks_unit(),
+           (double) res->ticks / (double) res->apdus,
+           bench_ticks_unit(),
+           (double) res->plugin_calls / (double) res->txs);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    bool loaded = false;
+    static const struct {
+        const char *name;
+        bench_plugin_mode_e mode;
+    } modes[] = {
+        {"hash", BENCH_PLUGIN_NONE},
+        {"plugin", BENCH_PLUGIN_ACCEPT},
+        {"batch", BENCH_PLUGIN_BATCH},
+    };
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 10);
+        } else if (!load_corpus(argv[i])) {
+            return EXIT_FAILURE;
+        } else {
+            loaded = true;
+        }
+    }
+    if (!loaded) {
+        gen_corpora();
+    }
+
+    bench_set_storage(true, false);
+    for (size_t m = 0; m < ARRAYLEN(modes); m++) {
+        g_bench_plugin_mode = modes[m].mode;
+        for (size_t c = 0; c < ARRAYLEN(g_corpora); c++) {
+            bench_result_t res;
+
+            if (g_corpora[c].count == 0) {
+                continue;
+            }
+            if (!run_corpus(&g_corpora[c], iterations, &res)) {
+                return EXIT_FAILURE;
+            }
+            print_result(&g_corpora[c], modes[m].name, &res);
+        }
+    }
+    return EXIT_SUCCESS;
+}
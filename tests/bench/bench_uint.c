@@ -0,0 +1,556 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Micro-benchmark of the 128/256-bit integer helpers.
+//
+// Every operation is first checked against a straightforward reference implementation (bit by
+// bit shift-subtract division, one division per output digit, cx_math_mult, amount formatting
+// through scratch copies), which is then timed against the app implementation.
+//
+// Usage: bench_uint [-n iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "common_utils.h"
+#include "cx.h"
+#include "uint128.h"
+#include "uint256.h"
+#include "uint_common.h"
+
+#define SAMPLES            256
+#define DEFAULT_ITERATIONS 200
+
+typedef struct {
+    const char *name;
+    uint32_t bits;  // size of the formatted numbers
+} bench_size_t;
+
+static const bench_size_t SIZES[] = {
+    {.name = "64-bit", .bits = 64},    // gas, nonces
+    {.name = "96-bit", .bits = 96},    // typical amounts in wei
+    {.name = "256-bit", .bits = 256},  // worst case, 78 decimal digits
+};
+
+// Reference implementation
+
+static void ref_divmod256(const uint256_t *l,
+                          const uint256_t *r,
+                          uint256_t *retDiv,
+                          uint256_t *retMod) {
+    uint256_t copyd, adder, resDiv, resMod;
+    uint256_t one;
+    uint32_t diffBits = bits256(l) - bits256(r);
+
+    clear256(&one);
+    LOWER(LOWER(one)) = 1;
+    clear256(&resDiv);
+    copy256(&resMod, l);
+    if (gt256(r, l)) {
+        copy256(retMod, l);
+        clear256(retDiv);
+        return;
+    }
+    shiftl256(r, diffBits, &copyd);
+    shiftl256(&one, diffBits, &adder);
+    if (gt256(&copyd, &resMod)) {
+        shiftr256(&copyd, 1, &copyd);
+        shiftr256(&adder, 1, &adder);
+    }
+    while (gte256(&resMod, r)) {
+        if (gte256(&resMod, &copyd)) {
+            sub256(&resMod, &copyd, &resMod);
+            or256(&resDiv, &adder, &resDiv);
+        }
+        shiftr256(&copyd, 1, &copyd);
+        shiftr256(&adder, 1, &adder);
+    }
+    copy256(retDiv, &resDiv);
+    copy256(retMod, &resMod);
+}
+
+static bool ref_tostring256(const uint256_t *number,
+                            uint32_t base,
+                            char *out,
+                            uint32_t outLength) {
+    uint256_t rDiv;
+    uint256_t rMod;
+    uint256_t b;
+    uint32_t offset = 0;
+
+    copy256(&rDiv, number);
+    clear256(&b);
+    LOWER(LOWER(b)) = base;
+    do {
+        if (offset >= (outLength - 1)) {
+            return false;
+        }
+        ref_divmod256(&rDiv, &b, &rDiv, &rMod);
+        out[offset++] = HEXDIGITS[(uint8_t) LOWER(LOWER(rMod))];
+    } while (!zero256(&rDiv));
+    out[offset] = '\0';
+    reverseString(out, offset);
+    return true;
+}
+
+// Amount formatting as done before amount256_to_string: digits into a scratch buffer, decimals
+// adjusted into a second one, then ticker and digits copied into the output
+static bool ref_adjust_decimals(const char *src, size_t srcLength, char *target, uint8_t decimals) {
+    size_t offset = 0;
+    size_t startOffset;
+    size_t lastZeroOffset = 0;
+
+    if ((srcLength == 1) && (src[0] == '0')) {
+        strcpy(target, "0");
+        return true;
+    }
+    if (srcLength <= decimals) {
+        target[offset++] = '0';
+        target[offset++] = '.';
+        for (size_t i = 0; i < (decimals - srcLength); i++) {
+            target[offset++] = '0';
+        }
+        startOffset = offset;
+        memcpy(target + offset, src, srcLength);
+        offset += srcLength;
+    } else {
+        memcpy(target, src, srcLength - decimals);
+        offset = srcLength - decimals;
+        if (decimals != 0) {
+            target[offset++] = '.';
+        }
+        startOffset = offset;
+        memcpy(target + offset, src + srcLength - decimals, decimals);
+        offset += decimals;
+    }
+    target[offset] = '\0';
+    for (size_t i = startOffset; i < offset; i++) {
+        if (target[i] == '0') {
+            if (lastZeroOffset == 0) {
+                lastZeroOffset = i;
+            }
+        } else {
+            lastZeroOffset = 0;
+        }
+    }
+    if (lastZeroOffset != 0) {
+        target[lastZeroOffset] = '\0';
+        if (target[lastZeroOffset - 1] == '.') {
+            target[lastZeroOffset - 1] = '\0';
+        }
+    }
+    return true;
+}
+
+static bool ref_amount_to_string(const uint256_t *amount,
+                                 uint8_t decimals,
+                                 const char *ticker,
+                                 char *out,
+                                 size_t outLength) {
+    char digits[100];
+    char adjusted[200];
+    size_t tickerLength = strlen(ticker);
+
+    if (!tostring256(amount, 10, digits, sizeof(digits)) ||
+        !ref_adjust_decimals(digits, strlen(digits), adjusted, decimals)) {
+        return false;
+    }
+    if ((tickerLength + (tickerLength > 0) + strlen(adjusted)) >= outLength) {
+        return false;
+    }
+    out[0] = '\0';
+    if (tickerLength > 0) {
+        strcat(out, ticker);
+        strcat(out, " ");
+    }
+    strcat(out, adjusted);
+    return true;
+}
+
+// Inputs
+
+static void rand_uint256(uint32_t *seed, uint32_t bits, uint256_t *out) {
+    uint8_t raw[INT256_LENGTH] = {0};
+    uint32_t bytes = (bits + 7) / 8;
+
+    bench_rand_bytes(seed, raw + sizeof(raw) - bytes, bytes);
+    // Long runs of set or cleared bits exercise the corrections of the quotient estimate
+    switch (bench_rand(seed) % 4) {
+        case 0:
+            memset(raw + sizeof(raw) - bytes, 0xff, bytes / 2);
+            break;
+        case 1:
+            memset(raw + sizeof(raw) - bytes / 2, 0x00, bytes / 2);
+            break;
+        default:
+            break;
+    }
+    readu256BE(raw, out);
+}
+
+static void to_uint128(const uint256_t *in, uint128_t *out) {
+    copy128(out, &LOWER_P(in));
+}
+
+// Checks
+
+static bool check_divmod(uint32_t *seed) {
+    for (uint32_t i = 0; i < 4 * SAMPLES; i++) {
+        uint256_t l, r, q, m, ref_q, ref_m;
+
+        rand_uint256(seed, 1 + bench_rand(seed) % 256, &l);
+        rand_uint256(seed, 1 + bench_rand(seed) % 256, &r);
+        if (zero256(&r)) {
+            continue;
+        }
+        divmod256(&l, &r, &q, &m);
+        ref_divmod256(&l, &r, &ref_q, &ref_m);
+        if (!equal256(&q, &ref_q) || !equal256(&m, &ref_m)) {
+            fprintf(stderr, "divmod256 mismatch on sample #%u\n", i);
+            return false;
+        }
+        if (!zero128(&UPPER(l)) || !zero128(&UPPER(r))) {
+            continue;
+        }
+        {
+            uint128_t l128, r128, q128, m128;
+
+            to_uint128(&l, &l128);
+            to_uint128(&r, &r128);
+            divmod128(&l128, &r128, &q128, &m128);
+            if (!equal128(&q128, &LOWER(ref_q)) || !equal128(&m128, &LOWER(ref_m))) {
+                fprintf(stderr, "divmod128 mismatch on sample #%u\n", i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool check_tostring(uint32_t *seed) {
+    static const uint32_t BASES[] = {2, 10, 16};
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        for (size_t b = 0; b < ARRAYLEN(BASES); b++) {
+            char out[260];
+            char ref[260];
+            uint256_t value;
+            uint128_t value128;
+
+            rand_uint256(seed, bench_rand(seed) % 257, &value);
+            if (!tostring256(&value, BASES[b], out, sizeof(out)) ||
+                !ref_tostring256(&value, BASES[b], ref, sizeof(ref)) || (strcmp(out, ref) != 0)) {
+                fprintf(stderr, "tostring256 mismatch in base %u: %s / %s\n", BASES[b], out, ref);
+                return false;
+            }
+            clear128(&UPPER(value));
+            to_uint128(&value, &value128);
+            if (!tostring128(&value128, BASES[b], out, sizeof(out)) ||
+                !ref_tostring256(&value, BASES[b], ref, sizeof(ref)) || (strcmp(out, ref) != 0)) {
+                fprintf(stderr, "tostring128 mismatch in base %u: %s / %s\n", BASES[b], out, ref);
+                return false;
+            }
+            // Exact fit and one byte short
+            if (!tostring256(&value, BASES[b], out, strlen(ref) + 1) ||
+                tostring256(&value, BASES[b], out, strlen(ref))) {
+                fprintf(stderr, "tostring256 output length check failed\n");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool check_amount(uint32_t *seed) {
+    static const struct {
+        uint64_t value;
+        uint8_t decimals;
+        const char *ticker;
+        const char *expected;
+    } VECTORS[] = {
+        {0, 18, "ETH", "ETH 0"},
+        {1, 18, "ETH", "ETH 0.000000000000000001"},
+        {1500000000000000000, 18, "ETH", "ETH 1.5"},
+        {1000000000000000000, 18, "", "1"},
+        {1234, 0, "USDT", "USDT 1234"},
+        {1230, 2, "DAI", "DAI 12.3"},
+        {100, 3, "X", "X 0.1"},
+    };
+    static const char *const TICKERS[] = {"", "ETH", "LONGTICKER"};
+    char out[120];
+    char ref[120];
+    uint256_t value;
+
+    for (size_t i = 0; i < ARRAYLEN(VECTORS); i++) {
+        clear256(&value);
+        LOWER(LOWER(value)) = VECTORS[i].value;
+        if (!amount256_to_string(&value, VECTORS[i].decimals, VECTORS[i].ticker, out, sizeof(out)) ||
+            (strcmp(out, VECTORS[i].expected) != 0)) {
+            fprintf(stderr, "amount256_to_string: got %s, expected %s\n", out, VECTORS[i].expected);
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        uint8_t decimals = bench_rand(seed) % 40;
+        const char *ticker = TICKERS[bench_rand(seed) % ARRAYLEN(TICKERS)];
+
+        rand_uint256(seed, bench_rand(seed) % 257, &value);
+        // trailing zeros to trim
+        if ((bench_rand(seed) % 2) == 0) {
+            uint256_t power;
+
+            clear256(&power);
+            LOWER(LOWER(power)) = 1000000;
+            shiftr256(&value, 24, &value);
+            mul256(&value, &power, &value);
+        }
+        if (!amount256_to_string(&value, decimals, ticker, out, sizeof(out)) ||
+            !ref_amount_to_string(&value, decimals, ticker, ref, sizeof(ref)) ||
+            (strcmp(out, ref) != 0)) {
+            fprintf(stderr, "amount256_to_string mismatch: %s / %s\n", out, ref);
+            return false;
+        }
+        // Exact fit, then one byte short
+        if (!amount256_to_string(&value, decimals, ticker, out, strlen(ref) + 1) ||
+            amount256_to_string(&value, decimals, ticker, out, strlen(ref)) || (out[0] != '\0')) {
+            fprintf(stderr, "amount256_to_string output length check failed\n");
+            return false;
+        }
+    }
+    // Largest amount with the longest ticker and decimals
+    memset(&value, 0xff, sizeof(value));
+    if (!amount256_to_string(&value,
+                             UINT256_DIGITS - 1,
+                             "LONGTICKER1",
+                             out,
+                             AMOUNT256_STRING_SIZE(strlen("LONGTICKER1")))) {
+        fprintf(stderr, "amount256_to_string: AMOUNT256_STRING_SIZE too small\n");
+        return false;
+    }
+    return true;
+}
+
+static void ref_mul256_full(const uint256_t *a, const uint256_t *b, uint8_t *product) {
+    uint8_t num1[INT256_LENGTH], num2[INT256_LENGTH];
+
+    for (uint8_t i = 0; i < 4; i++) {
+        write_u64_be(num1 + i * sizeof(uint64_t), a->elements[i / 2].elements[i % 2]);
+        write_u64_be(num2 + i * sizeof(uint64_t), b->elements[i / 2].elements[i % 2]);
+    }
+    cx_math_mult_no_throw(product, num1, num2, sizeof(num1));
+}
+
+static bool check_mul(uint32_t *seed) {
+    for (uint32_t i = 0; i < 4 * SAMPLES; i++) {
+        uint256_t a, b, native, cx, high, low, expected_high, expected_low, sum;
+        uint8_t product[2 * INT256_LENGTH];
+        bool fits;
+
+        rand_uint256(seed, bench_rand(seed) % 257, &a);
+        rand_uint256(seed, bench_rand(seed) % 257, &b);
+        mul256_native(&a, &b, &native);
+        mul256_cx(&a, &b, &cx);
+        mul256_full(&a, &b, &high, &low);
+        ref_mul256_full(&a, &b, product);
+        readu256BE(product, &expected_high);
+        readu256BE(product + INT256_LENGTH, &expected_low);
+        if (!equal256(&native, &cx) || !equal256(&low, &expected_low) ||
+            !equal256(&high, &expected_high)) {
+            fprintf(stderr, "mul256 mismatch on sample #%u\n", i);
+            return false;
+        }
+        fits = zero256(&expected_high);
+        if (mul256_checked(&a, &b, &native) != fits) {
+            fprintf(stderr, "mul256_checked overflow mismatch on sample #%u\n", i);
+            return false;
+        }
+        add256(&a, &b, &sum);
+        if (add256_checked(&a, &b, &native) != !gt256(&a, &sum)) {
+            fprintf(stderr, "add256_checked overflow mismatch on sample #%u\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Timing
+
+static void bench_tostring(const bench_size_t *size, uint32_t iterations) {
+    static uint256_t values[SAMPLES];
+    uint32_t seed = 0x1234abcd;
+    char out[80];
+    uint64_t ticks[2];
+
+    for (size_t i = 0; i < SAMPLES; i++) {
+        bench_rand_bytes(&seed, (uint8_t *) &values[i], sizeof(values[i]));
+        shiftr256(&values[i], 256 - size->bits, &values[i]);
+    }
+    for (int impl = 0; impl < 2; impl++) {
+        uint64_t start = bench_ticks();
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (size_t i = 0; i < SAMPLES; i++) {
+                if (impl == 0) {
+                    ref_tostring256(&values[i], 10, out, sizeof(out));
+                } else {
+                    tostring256(&values[i], 10, out, sizeof(out));
+                }
+            }
+        }
+        ticks[impl] = bench_ticks() - start;
+    }
+    printf("tostring256 %-8s %12.1f %s/call (reference) %10.1f %s/call %8.1fx\n",
+           size->name,
+           (double) ticks[0] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[1] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[0] / (double) ticks[1]);
+}
+
+static void bench_divmod(uint32_t iterations) {
+    static uint256_t dividends[SAMPLES];
+    static uint256_t divisors[SAMPLES];
+    uint32_t seed = 0xabcd1234;
+    uint64_t ticks[2];
+
+    for (size_t i = 0; i < SAMPLES; i++) {
+        rand_uint256(&seed, 256, &dividends[i]);
+        do {
+            rand_uint256(&seed, 1 + bench_rand(&seed) % 192, &divisors[i]);
+        } while (zero256(&divisors[i]));
+    }
+    for (int impl = 0; impl < 2; impl++) {
+        uint64_t start = bench_ticks();
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (size_t i = 0; i < SAMPLES; i++) {
+                uint256_t q, m;
+
+                if (impl == 0) {
+                    ref_divmod256(&dividends[i], &divisors[i], &q, &m);
+                } else {
+                    divmod256(&dividends[i], &divisors[i], &q, &m);
+                }
+            }
+        }
+        ticks[impl] = bench_ticks() - start;
+    }
+    printf("divmod256   %-8s %12.1f %s/call (reference) %10.1f %s/call %8.1fx\n",
+           "random",
+           (double) ticks[0] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[1] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[0] / (double) ticks[1]);
+}
+
+static void bench_mul(uint32_t iterations) {
+    static uint256_t factors[SAMPLES][2];
+    uint32_t seed = 0x600dcafe;
+    uint64_t ticks[2];
+
+    // gas price x gas limit like operands
+    for (size_t i = 0; i < SAMPLES; i++) {
+        rand_uint256(&seed, 40, &factors[i][0]);
+        rand_uint256(&seed, 24, &factors[i][1]);
+    }
+    for (int impl = 0; impl < 2; impl++) {
+        uint64_t start = bench_ticks();
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (size_t i = 0; i < SAMPLES; i++) {
+                uint256_t product;
+
+                if (impl == 0) {
+                    mul256_cx(&factors[i][0], &factors[i][1], &product);
+                } else {
+                    mul256_native(&factors[i][0], &factors[i][1], &product);
+                }
+            }
+        }
+        ticks[impl] = bench_ticks() - start;
+    }
+    printf("mul256      %-8s %12.1f %s/call (cx)        %10.1f %s/call %8.1fx\n",
+           "fees",
+           (double) ticks[0] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[1] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[0] / (double) ticks[1]);
+}
+
+static void bench_amount(uint32_t iterations) {
+    static uint256_t values[SAMPLES];
+    uint32_t seed = 0xfee5fee5;
+    char out[80];
+    uint64_t ticks[2];
+
+    // fees and amounts in wei
+    for (size_t i = 0; i < SAMPLES; i++) {
+        rand_uint256(&seed, 64 + bench_rand(&seed) % 32, &values[i]);
+    }
+    for (int impl = 0; impl < 2; impl++) {
+        uint64_t start = bench_ticks();
+
+        for (uint32_t it = 0; it < iterations; it++) {
+            for (size_t i = 0; i < SAMPLES; i++) {
+                if (impl == 0) {
+                    ref_amount_to_string(&values[i], 18, "ETH", out, sizeof(out));
+                } else {
+                    amount256_to_string(&values[i], 18, "ETH", out, sizeof(out));
+                }
+            }
+        }
+        ticks[impl] = bench_ticks() - start;
+    }
+    printf("amount      %-8s %12.1f %s/call (scratch)   %10.1f %s/call %8.1fx\n",
+           "wei",
+           (double) ticks[0] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[1] / ((double) iterations * SAMPLES),
+           bench_ticks_unit(),
+           (double) ticks[0] / (double) ticks[1]);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    uint32_t seed = 0x5eed5eed;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc)) {
+            iterations = (uint32_t) strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!check_divmod(&seed) || !check_tostring(&seed) || !check_mul(&seed) ||
+        !check_amount(&seed)) {
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < ARRAYLEN(SIZES); i++) {
+        bench_tostring(&SIZES[i], iterations);
+    }
+    bench_divmod(iterations);
+    bench_mul(iterations);
+    bench_amount(iterations);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cx.h"
+
+cx_err_t bip32_derive_get_pubkey_256(cx_curve_t curve,
+                                     const uint32_t *path,
+                                     size_t path_len,
+                                     uint8_t raw_pubkey[static 65],
+                                     uint8_t *chain_code,
+                                     cx_md_t hashID);
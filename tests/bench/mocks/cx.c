@@ -0,0 +1,337 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include <string.h>
+
+#include "cx.h"
+
+#define MIN_SIZE(a, b) ((a) < (b) ? (a) : (b))
+
+#define ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+static const uint64_t KECCAK_RC[24] = {
+    0x0000000000000001, 0x0000000000008082, 0x800000000000808a, 0x8000000080008000,
+    0x000000000000808b, 0x0000000080000001, 0x8000000080008081, 0x8000000000008009,
+    0x000000000000008a, 0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+    0x000000008000808b, 0x800000000000008b, 0x8000000000008089, 0x8000000000008003,
+    0x8000000000008002, 0x8000000000000080, 0x000000000000800a, 0x800000008000000a,
+    0x8000000080008081, 0x8000000000008080, 0x0000000080000001, 0x8000000080008008};
+
+static const uint8_t KECCAK_ROTC[24] = {1,  3,  6,  10, 15, 21, 28, 36, 45, 55, 2,  14,
+                                        27, 41, 56, 8,  25, 43, 62, 18, 39, 61, 20, 44};
+
+static const uint8_t KECCAK_PILN[24] = {10, 7,  11, 17, 18, 3, 5,  16, 8,  21, 24, 4,
+                                        15, 23, 19, 13, 12, 2, 20, 14, 22, 9,  6,  1};
+
+static void keccak_f1600(uint64_t st[25]) {
+    uint64_t bc[5];
+    uint64_t t;
+
+    for (int round = 0; round < 24; round++) {
+        // Theta
+        for (int i = 0; i < 5; i++) {
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                st[j + i] ^= t;
+            }
+        }
+        // Rho & Pi
+        t = st[1];
+        for (int i = 0; i < 24; i++) {
+            int j = KECCAK_PILN[i];
+            bc[0] = st[j];
+            st[j] = ROTL64(t, KECCAK_ROTC[i]);
+            t = bc[0];
+        }
+        // Chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = st[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+        // Iota
+        st[0] ^= KECCAK_RC[round];
+    }
+}
+
+static void keccak_absorb_block(cx_sha3_t *hash, const uint8_t *block) {
+    for (size_t i = 0; i < hash->block_size / 8; i++) {
+        uint64_t lane = 0;
+        for (int b = 7; b >= 0; b--) {
+            lane = (lane << 8) | block[i * 8 + b];
+        }
+        hash->acc[i] ^= lane;
+    }
+    keccak_f1600(hash->acc);
+}
+
+cx_err_t cx_keccak_init_no_throw(cx_sha3_t *hash, size_t size) {
+    if ((size != 224) && (size != 256) && (size != 384) && (size != 512)) {
+        return CX_INVALID_PARAMETER;
+    }
+    memset(hash, 0, sizeof(*hash));
+    hash->header.algo = CX_KECCAK;
+    hash->output_size = size / 8;
+    hash->block_size = 200 - 2 * hash->output_size;
+    return CX_OK;
+}
+
+static void keccak_update(cx_sha3_t *hash, const uint8_t *in, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (hash->blen != 0) {
+        size_t fill = hash->block_size - hash->blen;
+
+        if (len < fill) {
+            memcpy(hash->block + hash->blen, in, len);
+            hash->blen += len;
+            return;
+        }
+        memcpy(hash->block + hash->blen, in, fill);
+        keccak_absorb_block(hash, hash->block);
+        hash->blen = 0;
+        in += fill;
+        len -= fill;
+    }
+    while (len >= hash->block_size) {
+        keccak_absorb_block(hash, in);
+        in += hash->block_size;
+        len -= hash->block_size;
+    }
+    memcpy(hash->block, in, len);
+    hash->blen = len;
+}
+
+static void keccak_final(cx_sha3_t *hash, uint8_t *out) {
+    memset(hash->block + hash->blen, 0, hash->block_size - hash->blen);
+    hash->block[hash->blen] ^= 0x01;
+    hash->block[hash->block_size - 1] ^= 0x80;
+    keccak_absorb_block(hash, hash->block);
+    for (size_t i = 0; i < hash->output_size; i++) {
+        out[i] = (uint8_t) (hash->acc[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_block(cx_sha256_t *hash, const uint8_t *block) {
+    uint32_t w[64];
+    uint32_t s[8];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = U4BE(block, i * 4);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    memcpy(s, hash->acc, sizeof(s));
+    for (int i = 0; i < 64; i++) {
+        uint32_t S1 = ROTR32(s[4], 6) ^ ROTR32(s[4], 11) ^ ROTR32(s[4], 25);
+        uint32_t ch = (s[4] & s[5]) ^ (~s[4] & s[6]);
+        uint32_t t1 = s[7] + S1 + ch + SHA256_K[i] + w[i];
+        uint32_t S0 = ROTR32(s[0], 2) ^ ROTR32(s[0], 13) ^ ROTR32(s[0], 22);
+        uint32_t maj = (s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]);
+        uint32_t t2 = S0 + maj;
+        memmove(s + 1, s, 7 * sizeof(s[0]));
+        s[4] += t1;
+        s[0] = t1 + t2;
+    }
+    for (int i = 0; i < 8; i++) {
+        hash->acc[i] += s[i];
+    }
+}
+
+cx_err_t cx_sha256_init_no_throw(cx_sha256_t *hash) {
+    static const uint32_t iv[8] = {0x6a09e667,
+                                   0xbb67ae85,
+                                   0x3c6ef372,
+                                   0xa54ff53a,
+                                   0x510e527f,
+                                   0x9b05688c,
+                                   0x1f83d9ab,
+                                   0x5be0cd19};
+
+    memset(hash, 0, sizeof(*hash));
+    hash->header.algo = CX_SHA256;
+    memcpy(hash->acc, iv, sizeof(iv));
+    return CX_OK;
+}
+
+cx_err_t cx_sha224_init_no_throw(cx_sha256_t *hash) {
+    static const uint32_t iv[8] = {0xc1059ed8,
+                                   0x367cd507,
+                                   0x3070dd17,
+                                   0xf70e5939,
+                                   0xffc00b31,
+                                   0x68581511,
+                                   0x64f98fa7,
+                                   0xbefa4fa4};
+
+    memset(hash, 0, sizeof(*hash));
+    hash->header.algo = CX_SHA224;
+    memcpy(hash->acc, iv, sizeof(iv));
+    return CX_OK;
+}
+
+static void sha256_update(cx_sha256_t *hash, const uint8_t *in, size_t len) {
+    hash->length += len;
+    while (len > 0) {
+        size_t fill = MIN_SIZE(sizeof(hash->block) - hash->blen, len);
+
+        memcpy(hash->block + hash->blen, in, fill);
+        hash->blen += fill;
+        in += fill;
+        len -= fill;
+        if (hash->blen == sizeof(hash->block)) {
+            sha256_block(hash, hash->block);
+            hash->blen = 0;
+        }
+    }
+}
+
+static void sha256_final(cx_sha256_t *hash, uint8_t *out) {
+    uint64_t bits = hash->length * 8;
+    uint8_t pad = 0x80;
+    uint8_t digest[32];
+
+    sha256_update(hash, &pad, 1);
+    pad = 0x00;
+    while (hash->blen != (sizeof(hash->block) - sizeof(bits))) {
+        sha256_update(hash, &pad, 1);
+    }
+    for (int i = 7; i >= 0; i--) {
+        uint8_t b = (uint8_t) (bits >> (i * 8));
+        sha256_update(hash, &b, 1);
+    }
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = (uint8_t) (hash->acc[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t) (hash->acc[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t) (hash->acc[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t) hash->acc[i];
+    }
+    // SHA-224 is truncated
+    memcpy(out, digest, (hash->header.algo == CX_SHA224) ? 28 : 32);
+}
+
+cx_err_t cx_hash_no_throw(cx_hash_t *hash,
+                          uint32_t mode,
+                          const uint8_t *in,
+                          size_t len,
+                          uint8_t *out,
+                          size_t out_len) {
+    switch (hash->algo) {
+        case CX_KECCAK: {
+            cx_sha3_t *sha3 = (cx_sha3_t *) hash;
+
+            keccak_update(sha3, in, len);
+            if (mode & CX_LAST) {
+                if (out_len < sha3->output_size) {
+                    return CX_INVALID_PARAMETER;
+                }
+                keccak_final(sha3, out);
+            }
+            break;
+        }
+        case CX_SHA224:
+        case CX_SHA256: {
+            cx_sha256_t *sha256 = (cx_sha256_t *) hash;
+
+            sha256_update(sha256, in, len);
+            if (mode & CX_LAST) {
+                if (out_len < ((hash->algo == CX_SHA224) ? 28 : 32)) {
+                    return CX_INVALID_PARAMETER;
+                }
+                sha256_final(sha256, out);
+            }
+            break;
+        }
+        default:
+            return CX_INVALID_PARAMETER;
+    }
+    return CX_OK;
+}
+
+// Big-endian schoolbook multiplication, r is 2 * len bytes long
+cx_err_t cx_math_mult_no_throw(uint8_t *r, const uint8_t *a, const uint8_t *b, size_t len) {
+    uint32_t acc[2 * 64] = {0};
+
+    if (len > 64) {
+        return CX_INVALID_PARAMETER;
+    }
+    for (size_t i = 0; i < len; i++) {
+        for (size_t j = 0; j < len; j++) {
+            acc[(2 * len - 1) - ((len - 1 - i) + (len - 1 - j))] += a[i] * b[j];
+        }
+    }
+    for (size_t k = 2 * len - 1; k > 0; k--) {
+        acc[k - 1] += acc[k] >> 8;
+        r[k] = (uint8_t) acc[k];
+    }
+    r[0] = (uint8_t) acc[0];
+    return CX_OK;
+}
+
+uint32_t g_cx_ecdsa_verify_calls;
+
+cx_err_t cx_ecfp_init_public_key_no_throw(cx_curve_t curve,
+                                          const uint8_t *raw_key,
+                                          size_t key_len,
+                                          cx_ecfp_public_key_t *key) {
+    if (key_len > sizeof(key->W)) {
+        return CX_INVALID_PARAMETER;
+    }
+    key->curve = curve;
+    key->W_len = key_len;
+    memcpy(key->W, raw_key, key_len);
+    return CX_OK;
+}
+
+bool cx_ecdsa_verify_no_throw(const cx_ecfp_public_key_t *key,
+                              const uint8_t *hash,
+                              size_t hash_len,
+                              const uint8_t *sig,
+                              size_t sig_len) {
+    cx_sha256_t ctx;
+    uint8_t expected[32];
+
+    g_cx_ecdsa_verify_calls += 1;
+    cx_sha256_init_no_throw(&ctx);
+    cx_hash_no_throw((cx_hash_t *) &ctx, 0, key->W, key->W_len, NULL, 0);
+    cx_hash_no_throw((cx_hash_t *) &ctx, CX_LAST, hash, hash_len, expected, sizeof(expected));
+    return (sig_len == sizeof(expected)) && (memcmp(sig, expected, sig_len) == 0);
+}
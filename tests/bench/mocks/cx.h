@@ -0,0 +1,114 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Host replacement of the BOLOS cryptography API, hashing is backed by real implementations so
+// that the computed transaction hashes can be checked.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "os.h"
+
+typedef uint32_t cx_err_t;
+
+#define CX_OK             0x00000000
+#define CX_INTERNAL_ERROR 0xFFFFFF85
+#define CX_INVALID_PARAMETER 0xFFFFFF82
+
+#define CX_LAST (1 << 0)
+
+#define CX_CHECK(call)         \
+    do {                       \
+        error = call;          \
+        if (error) {           \
+            goto end;          \
+        }                      \
+    } while (0)
+
+#define CX_ASSERT(call)                      \
+    do {                                     \
+        cx_err_t _assert_err = call;         \
+        if (_assert_err) {                   \
+            THROW(EXCEPTION);                \
+        }                                    \
+    } while (0)
+
+typedef enum cx_md_e {
+    CX_NONE = 0,
+    CX_SHA224 = 2,
+    CX_SHA256 = 3,
+    CX_SHA512 = 5,
+    CX_KECCAK = 6,
+} cx_md_t;
+
+typedef enum cx_curve_e {
+    CX_CURVE_256K1 = 0x21,
+} cx_curve_t;
+
+typedef struct cx_hash_header_s {
+    cx_md_t algo;
+} cx_hash_t;
+
+typedef struct cx_sha3_s {
+    cx_hash_t header;
+    size_t output_size;
+    size_t block_size;
+    size_t blen;
+    uint8_t block[200];
+    uint64_t acc[25];
+} cx_sha3_t;
+
+typedef struct cx_sha256_s {
+    cx_hash_t header;
+    size_t blen;
+    uint64_t length;
+    uint8_t block[64];
+    uint32_t acc[8];
+} cx_sha256_t;
+
+typedef struct cx_ecfp_public_key_s {
+    cx_curve_t curve;
+    size_t W_len;
+    uint8_t W[65];
+} cx_ecfp_public_key_t;
+
+cx_err_t cx_keccak_init_no_throw(cx_sha3_t *hash, size_t size);
+cx_err_t cx_sha256_init_no_throw(cx_sha256_t *hash);
+cx_err_t cx_sha224_init_no_throw(cx_sha256_t *hash);
+#define cx_sha224_init(hash) cx_sha224_init_no_throw(hash)
+cx_err_t cx_hash_no_throw(cx_hash_t *hash,
+                          uint32_t mode,
+                          const uint8_t *in,
+                          size_t len,
+                          uint8_t *out,
+                          size_t out_len);
+cx_err_t cx_math_mult_no_throw(uint8_t *r, const uint8_t *a, const uint8_t *b, size_t len);
+
+// The signature of a hash is simply SHA-256(public key || hash), the calls are counted
+extern uint32_t g_cx_ecdsa_verify_calls;
+cx_err_t cx_ecfp_init_public_key_no_throw(cx_curve_t curve,
+                                          const uint8_t *raw_key,
+                                          size_t key_len,
+                                          cx_ecfp_public_key_t *key);
+bool cx_ecdsa_verify_no_throw(const cx_ecfp_public_key_t *key,
+                              const uint8_t *hash,
+                              size_t hash_len,
+                              const uint8_t *sig,
+                              size_t sig_len);
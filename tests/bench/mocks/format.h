@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+bool format_u64(char *dst, size_t dst_len, uint64_t value);
+int format_hex(const uint8_t *in, size_t in_len, char *out, size_t out_len);
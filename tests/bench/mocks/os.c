@@ -0,0 +1,82 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "os.h"
+#include "format.h"
+
+try_context_t *G_try_last = NULL;
+
+uint8_t G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+void os_longjmp(exception_t exception) {
+    if (G_try_last == NULL) {
+        fprintf(stderr, "Uncaught exception 0x%04x\n", exception);
+        abort();
+    }
+    longjmp(G_try_last->jmp_buf, exception);
+}
+
+void os_sched_exit(int exit_code) {
+    fprintf(stderr, "os_sched_exit(%d)\n", exit_code);
+    exit(1);
+}
+
+#ifndef HAVE_STRLCPY
+size_t strlcpy(char *dst, const char *src, size_t size) {
+    size_t len = strlen(src);
+
+    if (size != 0) {
+        size_t copy = (len >= size) ? (size - 1) : len;
+
+        memcpy(dst, src, copy);
+        dst[copy] = '\0';
+    }
+    return len;
+}
+
+size_t strlcat(char *dst, const char *src, size_t size) {
+    size_t dst_len = strnlen(dst, size);
+
+    if (dst_len == size) {
+        return size + strlen(src);
+    }
+    return dst_len + strlcpy(dst + dst_len, src, size - dst_len);
+}
+#endif
+
+bool format_u64(char *dst, size_t dst_len, uint64_t value) {
+    int ret = snprintf(dst, dst_len, "%llu", (unsigned long long) value);
+
+    return (ret > 0) && ((size_t) ret < dst_len);
+}
+
+int format_hex(const uint8_t *in, size_t in_len, char *out, size_t out_len) {
+    static const char digits[] = "0123456789ABCDEF";
+
+    if (out_len < (2 * in_len + 1)) {
+        return -1;
+    }
+    for (size_t i = 0; i < in_len; i++) {
+        out[i * 2] = digits[in[i] >> 4];
+        out[i * 2 + 1] = digits[in[i] & 0x0f];
+    }
+    out[2 * in_len] = '\0';
+    return (int) (2 * in_len + 1);
+}
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// Host replacement of the BOLOS os.h, only covers what the app sources built by the benchmarks
+// actually use.
+
+#pragma once
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PRINTF(...)
+
+#define UNUSED(x) (void) x
+
+#define PIC(x) ((void *) (x))
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#define U2BE(buf, off) ((((uint16_t) (buf)[off]) << 8) | ((uint16_t) (buf)[off + 1]))
+#define U4BE(buf, off)                                                                  \
+    ((((uint32_t) (buf)[off]) << 24) | (((uint32_t) (buf)[off + 1]) << 16) |           \
+     (((uint32_t) (buf)[off + 2]) << 8) | ((uint32_t) (buf)[off + 3]))
+
+#define IO_APDU_BUFFER_SIZE 260
+
+// Exceptions, mirrors the numbering of the SDK
+#define EXCEPTION          1
+#define INVALID_PARAMETER  2
+#define EXCEPTION_OVERFLOW 3
+#define EXCEPTION_SECURITY 4
+#define INVALID_STATE      9
+#define EXCEPTION_IO_RESET 0x10
+
+typedef unsigned short exception_t;
+
+typedef struct try_context_s {
+    jmp_buf jmp_buf;
+    struct try_context_s *previous;
+    volatile exception_t ex;
+} try_context_t;
+
+extern try_context_t *G_try_last;
+
+void os_longjmp(exception_t exception) __attribute__((noreturn));
+
+// setjmp() based TRY/CATCH, only supports the BEGIN_TRY / TRY / CATCH_OTHER / FINALLY / END_TRY
+// layout used throughout the app
+#define BEGIN_TRY                                           \
+    {                                                       \
+        try_context_t __try_ctx;                            \
+        __try_ctx.previous = G_try_last;                    \
+        G_try_last = &__try_ctx;                            \
+        __try_ctx.ex = (exception_t) setjmp(__try_ctx.jmp_buf);
+
+#define TRY if (__try_ctx.ex == 0)
+
+#define CATCH_OTHER(e)                                                        \
+    else for (exception_t e __attribute__((unused)) =                         \
+                  (G_try_last = __try_ctx.previous, __try_ctx.ex),            \
+                  __c = 1;                                                    \
+              __c;                                                            \
+              __c = 0)
+
+#define CATCH_ALL CATCH_OTHER(__unused_ex)
+
+#define FINALLY G_try_last = __try_ctx.previous;
+
+#define END_TRY }
+
+#define CLOSE_TRY G_try_last = __try_ctx.previous
+
+#define THROW(x) os_longjmp(x)
+
+#define BOLOS_UX_OK 0xAA
+
+extern uint8_t G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+void os_sched_exit(int exit_code) __attribute__((noreturn));
+
+#ifndef HAVE_STRLCPY
+size_t strlcpy(char *dst, const char *src, size_t size);
+size_t strlcat(char *dst, const char *src, size_t size);
+#endif
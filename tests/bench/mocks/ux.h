@@ -0,0 +1,5 @@
+#pragma once
+
+#include "os.h"
+
+typedef struct bagl_element_e bagl_element_t;
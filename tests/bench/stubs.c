@@ -0,0 +1,236 @@
+/*******************************************************************************
+ *   Ledger Ethereum App
+ *   (c) 2023 Ledger
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ ********************************************************************************/
+
+// App globals normally defined in main.c and the device-only functions referenced by the sources
+// built on the host
+
+#include <stdio.h>
+#include <string.h>
+
+// The settings normally live in flash and are declared const, keep a writable copy here
+#define N_storage_real N_storage_real_const
+#include "shared_context.h"
+#undef N_storage_real
+#include "common_ui.h"
+#include "crypto_helpers.h"
+#include "format.h"
+#include "eth_plugin_handler.h"
+#include "feature_signTx.h"
+#include "manage_asset_info.h"
+#include "plugin_utils.h"
+#include "bench.h"
+
+internalStorage_t N_storage_real;
+
+tmpCtx_t tmpCtx;
+txContext_t txContext;
+tmpContent_t tmpContent;
+dataContext_t dataContext;
+strings_t strings;
+cx_sha3_t global_sha3;
+uint16_t apdu_response_code;
+
+uint8_t appState;
+bool G_called_from_swap;
+bool G_swap_response_ready;
+pluginType_t pluginType;
+
+static chain_config_t bench_chain_config = {.coinName = "ETH", .chainId = 1};
+const chain_config_t *chainConfig = &bench_chain_config;
+
+bench_plugin_mode_e g_bench_plugin_mode = BENCH_PLUGIN_NONE;
+uint32_t g_bench_plugin_parameters = 0;
+uint32_t g_bench_plugin_calls = 0;
+uint32_t g_bench_plugin_digest = 0;
+
+void bench_set_storage(bool data_allowed, bool contract_details) {
+    N_storage_real.dataAllowed = data_allowed;
+    N_storage_real.contractDetails = contract_details;
+    N_storage_real.initialized = true;
+}
+
+void reset_app_context(void) {
+    appState = APP_STATE_IDLE;
+    G_called_from_swap = false;
+    G_swap_response_ready = false;
+    pluginType = OLD_INTERNAL;
+    memset(&tmpCtx, 0, sizeof(tmpCtx));
+    forget_known_assets();
+    memset(&txContext, 0, sizeof(txContext));
+    memset(&tmpContent, 0, sizeof(tmpContent));
+}
+
+void io_seproxyhal_send_status(uint32_t sw) {
+    UNUSED(sw);
+}
+
+unsigned int io_seproxyhal_touch_tx_ok(const bagl_element_t *e) {
+    UNUSED(e);
+    return 0;
+}
+
+void ui_idle(void) {
+}
+
+void ui_warning_contract_data(void) {
+}
+
+void ui_confirm_selector(void) {
+}
+
+void ui_confirm_parameter(void) {
+}
+
+void ux_approve_tx(bool fromPlugin) {
+    UNUSED(fromPlugin);
+}
+
+// Plugin layer
+
+void eth_plugin_prepare_init(ethPluginInitContractExt_t *init,
+                             const uint8_t *selector,
+                             uint32_t dataSize) {
+    memset(init, 0, sizeof(*init));
+    init->base.selector = selector;
+    init->base.dataSize = dataSize;
+}
+
+void eth_plugin_prepare_provide_parameter(ethPluginProvideParameter_t *provideParameter,
+                                          uint8_t *parameter,
+                                          uint32_t parameterOffset) {
+    memset(provideParameter, 0, sizeof(*provideParameter));
+    provideParameter->parameter = parameter;
+    provideParameter->parameterOffset = parameterOffset;
+}
+
+void eth_plugin_prepare_provide_parameters(ethPluginProvideParameters_t *provideParameters,
+                                           const uint8_t *parameters,
+                                           uint32_t parameterOffset,
+                                           uint16_t count) {
+    memset(provideParameters, 0, sizeof(*provideParameters));
+    provideParameters->base.parameter = parameters;
+    provideParameters->base.parameterOffset = parameterOffset;
+    provideParameters->count = count;
+}
+
+void eth_plugin_prepare_finalize(ethPluginFinalize_t *finalize) {
+    memset(finalize, 0, sizeof(*finalize));
+}
+
+void eth_plugin_prepare_provide_info(ethPluginProvideInfo_t *provideToken) {
+    memset(provideToken, 0, sizeof(*provideToken));
+}
+
+eth_plugin_result_t eth_plugin_perform_init(uint8_t *contractAddress,
+                                            ethPluginInitContractExt_t *initExt) {
+    UNUSED(contractAddress);
+    UNUSED(initExt);
+    dataContext.tokenContext.pluginBatchParameters = false;
+    if (g_bench_plugin_mode == BENCH_PLUGIN_NONE) {
+        return ETH_PLUGIN_RESULT_UNAVAILABLE;
+    }
+    dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
+    dataContext.tokenContext.pluginBatchParameters = (g_bench_plugin_mode == BENCH_PLUGIN_BATCH);
+    return ETH_PLUGIN_RESULT_OK;
+}
+
+// FNV-1a, only meant to compare the delivery modes
+static void digest_parameter(const uint8_t *parameter, uint32_t offset) {
+    for (size_t i = 0; i < sizeof(offset); i++) {
+        g_bench_plugin_digest = (g_bench_plugin_digest ^ ((offset >> (8 * i)) & 0xff)) * 16777619;
+    }
+    for (size_t i = 0; i < 32; i++) {
+        g_bench_plugin_digest = (g_bench_plugin_digest ^ parameter[i]) * 16777619;
+    }
+}
+
+eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
+    if (dataContext.tokenContext.pluginStatus <= ETH_PLUGIN_RESULT_UNSUCCESSFUL) {
+        return dataContext.tokenContext.pluginStatus;
+    }
+    if (method == ETH_PLUGIN_PROVIDE_PARAMETER) {
+        const ethPluginProvideParameters_t *msg = parameter;
+
+        for (uint16_t i = 0; i < msg->count; i++) {
+            digest_parameter(msg->base.parameter + i * 32, msg->base.parameterOffset + i * 32);
+        }
+        g_bench_plugin_parameters += msg->count;
+        g_bench_plugin_calls += 1;
+    }
+    return ETH_PLUGIN_RESULT_OK;
+}
+
+// Ethereum plugin SDK helpers
+
+uint64_t u64_from_BE(const uint8_t *in, uint8_t size) {
+    uint64_t res = 0;
+
+    for (uint8_t i = 0; (i < size) && (i < sizeof(res)); i++) {
+        res = (res << 8) | in[i];
+    }
+    return res;
+}
+
+bool u64_to_string(uint64_t src, char *dst, uint8_t dst_size) {
+    return format_u64(dst, dst_size, src);
+}
+
+bool getEthAddressFromRawKey(const uint8_t raw_pubkey[static 65],
+                             uint8_t out[static ADDRESS_LENGTH]) {
+    UNUSED(raw_pubkey);
+    UNUSED(out);
+    return false;
+}
+
+// Not checksummed, only meant to fill the screens
+bool getEthDisplayableAddress(uint8_t *in, char *out, size_t out_len, uint64_t chainId) {
+    UNUSED(chainId);
+    if (out_len < (2 + 2 * ADDRESS_LENGTH + 1)) {
+        return false;
+    }
+    strcpy(out, "0x");
+    for (size_t i = 0; i < ADDRESS_LENGTH; i++) {
+        snprintf(out + 2 + 2 * i, 3, "%02x", in[i]);
+    }
+    return true;
+}
+
+bool U4BE_from_parameter(const uint8_t *parameter, uint32_t *value) {
+    for (size_t i = 0; i < 28; i++) {
+        if (parameter[i] != 0) {
+            return false;
+        }
+    }
+    *value = ((uint32_t) parameter[28] << 24) | ((uint32_t) parameter[29] << 16) |
+             ((uint32_t) parameter[30] << 8) | parameter[31];
+    return true;
+}
+
+cx_err_t bip32_derive_get_pubkey_256(cx_curve_t curve,
+                                     const uint32_t *path,
+                                     size_t path_len,
+                                     uint8_t raw_pubkey[static 65],
+                                     uint8_t *chain_code,
+                                     cx_md_t hashID) {
+    UNUSED(curve);
+    UNUSED(path);
+    UNUSED(path_len);
+    UNUSED(raw_pubkey);
+    UNUSED(chain_code);
+    UNUSED(hashID);
+    return CX_INTERNAL_ERROR;
+}
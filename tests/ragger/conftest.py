@@ -2,9 +2,13 @@ import sys
 from pathlib import Path
 import warnings
 import glob
+import json
+import pytest
 
 from ragger.conftest import configuration
 
+from client.client import EthAppClient
+
 #######################
 # CONFIGURATION START #
 #######################
@@ -15,6 +19,12 @@ from ragger.conftest import configuration
 
 def pytest_addoption(parser):
     parser.addoption("--with_lib_mode", action="store_true", help="Run the test with Library Mode")
+    parser.addoption("--profiling",
+                     action="store",
+                     default=None,
+                     metavar="FILE",
+                     help="Append the profiling counters & memory usage of each test to FILE, "
+                     "as JSON lines (needs an app built with PROFILING=1)")
 
 
 parent: Path = Path(__file__).parent
@@ -47,3 +57,26 @@ else:
 
 # Pull all features from the base ragger conftest using the overridden configuration
 pytest_plugins = ("ragger.conftest.base_conftest", )
+
+
+# Profiling counters & memory usage of each test, reset before it and collected after it
+@pytest.fixture(autouse=True)
+def profiling_counters(request):
+    path = request.config.getoption("profiling")
+    if path is None:
+        yield
+        return
+    app_client = EthAppClient(request.getfixturevalue("backend"))
+    # no dynamic memory on LNS
+    with_memory = request.getfixturevalue("firmware").device != "nanos"
+    app_client.get_profiling_counters(reset=True)
+    if with_memory:
+        app_client.get_memory_usage(reset=True)
+    yield
+    result = {"test": request.node.nodeid,
+              "counters": [counter._asdict()
+                           for counter in app_client.get_profiling_counters(reset=True)]}
+    if with_memory:
+        result["memory"] = app_client.get_memory_usage(reset=True)._asdict()
+    with open(path, "a") as f:
+        f.write(json.dumps(result) + "\n")
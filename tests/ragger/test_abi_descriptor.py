@@ -0,0 +1,87 @@
+import pytest
+
+from ragger.error import ExceptionRAPDU
+from ragger.backend import BackendInterface
+from ragger.firmware import Firmware
+
+from client.client import EthAppClient, StatusWord
+from client.abi_descriptor import AbiParam, AbiType, abi_descriptor_payload, ABI_DESCRIPTOR_MAGIC
+from client.keychain import sign_data, Key
+
+
+# Values used across all tests
+CHAIN_ID = 1
+ADDR = bytes.fromhex("0011223344556677889900112233445566778899")
+SELECTOR = bytes.fromhex("a9059cbb")
+PARAMS = [
+    AbiParam("To", AbiType.ADDRESS),
+    AbiParam("Amount", AbiType.UINT, 6, "USDC"),
+    AbiParam("Memo", AbiType.STRING),
+    AbiParam("Ids", AbiType.UINT, array=True),
+]
+
+
+def common(firmware: Firmware, backend: BackendInterface) -> EthAppClient:
+    if firmware.device == "nanos":
+        pytest.skip("Not supported on LNS")
+    return EthAppClient(backend)
+
+
+def test_provide_abi_descriptor(firmware: Firmware, backend: BackendInterface):
+    app_client = common(firmware, backend)
+
+    response = app_client.provide_abi_descriptor(CHAIN_ID, ADDR, SELECTOR, "Test", "send", PARAMS)
+    assert response.status == StatusWord.OK
+
+
+def test_provide_abi_descriptor_wrong_signature(firmware: Firmware, backend: BackendInterface):
+    app_client = common(firmware, backend)
+
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_abi_descriptor(CHAIN_ID,
+                                          ADDR,
+                                          SELECTOR,
+                                          "Test",
+                                          "send",
+                                          PARAMS,
+                                          bytes.fromhex("deadbeef"))
+    assert e.value.status == StatusWord.INVALID_DATA
+
+
+def test_provide_abi_descriptor_tampered(firmware: Firmware, backend: BackendInterface):
+    app_client = common(firmware, backend)
+
+    # well-formed signature of the genuine descriptor, the labels being changed afterwards
+    payload = abi_descriptor_payload(CHAIN_ID, ADDR, SELECTOR, "Test", "send", PARAMS)
+    sig = sign_data(Key.CAL, ABI_DESCRIPTOR_MAGIC + payload)
+    tampered = [AbiParam("From", AbiType.ADDRESS)] + PARAMS[1:]
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_abi_descriptor(CHAIN_ID, ADDR, SELECTOR, "Test", "send", tampered, sig)
+    assert e.value.status == StatusWord.INVALID_DATA
+
+
+def test_provide_abi_descriptor_unsupported_array(firmware: Firmware, backend: BackendInterface):
+    app_client = common(firmware, backend)
+
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_abi_descriptor(CHAIN_ID,
+                                          ADDR,
+                                          SELECTOR,
+                                          "Test",
+                                          "send",
+                                          [AbiParam("Names", AbiType.STRING, array=True)])
+    assert e.value.status == StatusWord.INVALID_DATA
+
+
+
+def test_provide_abi_descriptor_invalid_width(firmware: Firmware, backend: BackendInterface):
+    app_client = common(firmware, backend)
+
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_abi_descriptor(CHAIN_ID,
+                                          ADDR,
+                                          SELECTOR,
+                                          "Test",
+                                          "send",
+                                          [AbiParam("Amount", AbiType.UINT, bits=264)])
+    assert e.value.status == StatusWord.INVALID_DATA
@@ -8,13 +8,14 @@ import pytest
 from eth_account.messages import encode_typed_data
 
 from ragger.backend import BackendInterface
+from ragger.error import ExceptionRAPDU
 from ragger.firmware import Firmware
 from ragger.navigator import Navigator, NavInsID
 from ragger.navigator.navigation_scenario import NavigateWithScenario
 
 import client.response_parser as ResponseParser
 from client.utils import recover_message
-from client.client import EthAppClient
+from client.client import EthAppClient, StatusWord
 from client.eip712 import InputData
 from client.settings import SettingID, settings_toggle
 
@@ -112,11 +113,17 @@ def eip712_new_common(firmware: Firmware,
                       app_client: EthAppClient,
                       json_data: dict,
                       filters: Optional[dict],
-                      verbose: bool):
+                      verbose: bool,
+                      packed_schema: bool = False,
+                      cached_schema: bool = False,
+                      packed_arrays: bool = False):
     assert InputData.process_data(app_client,
                                   json_data,
                                   filters,
-                                  partial(autonext, firmware, navigator, default_screenshot_path))
+                                  partial(autonext, firmware, navigator, default_screenshot_path),
+                                  packed_schema,
+                                  cached_schema,
+                                  packed_arrays)
     with app_client.eip712_sign_new(BIP32_PATH):
         moves = []
         if firmware.device.startswith("nano"):
@@ -180,6 +187,106 @@ def test_eip712_new(firmware: Firmware,
     assert recovered_addr == get_wallet_addr(app_client)
 
 
+def test_eip712_packed_schema(firmware: Firmware,
+                              backend: BackendInterface,
+                              navigator: Navigator,
+                              default_screenshot_path: Path,
+                              input_file: Path,
+                              record_property):
+    app_client = EthAppClient(backend)
+    if firmware.device == "nanos":
+        pytest.skip("Not supported on LNS")
+
+    with open(input_file, encoding="utf-8") as file:
+        data = json.load(file)
+
+    # same message with its schema sent one definition per APDU, then packed
+    uploads = []
+    for packed_schema in (False, True):
+        vrs = eip712_new_common(firmware,
+                                navigator,
+                                default_screenshot_path,
+                                app_client,
+                                data,
+                                None,
+                                False,
+                                packed_schema)
+        assert recover_message(data, vrs) == get_wallet_addr(app_client)
+        uploads.append(InputData.schema_upload)
+
+    assert uploads[1]["apdus"] <= uploads[0]["apdus"]
+    for name, upload in zip(("schema", "packed_schema"), uploads):
+        record_property(f"{name}_apdus", upload["apdus"])
+        record_property(f"{name}_seconds", upload["seconds"])
+    print(f"{input_file.name}: schema in {uploads[0]['apdus']} APDUs / "
+          f"{uploads[0]['seconds'] * 1000:.1f} ms, packed in {uploads[1]['apdus']} APDUs / "
+          f"{uploads[1]['seconds'] * 1000:.1f} ms")
+
+
+def test_eip712_cached_schema(firmware: Firmware,
+                              backend: BackendInterface,
+                              navigator: Navigator,
+                              default_screenshot_path: Path,
+                              input_file: Path):
+    app_client = EthAppClient(backend)
+    if firmware.device == "nanos":
+        pytest.skip("Not supported on LNS")
+
+    with open(input_file, encoding="utf-8") as file:
+        data = json.load(file)
+
+    # the first message has its schema cached if it was not already, the second one uses it
+    for _ in range(2):
+        vrs = eip712_new_common(firmware,
+                                navigator,
+                                default_screenshot_path,
+                                app_client,
+                                data,
+                                None,
+                                False,
+                                cached_schema=True)
+        assert recover_message(data, vrs) == get_wallet_addr(app_client)
+    assert InputData.schema_upload["apdus"] == 1
+
+
+def test_eip712_packed_arrays(firmware: Firmware,
+                              backend: BackendInterface,
+                              navigator: Navigator,
+                              default_screenshot_path: Path,
+                              input_file: Path,
+                              verbose: bool):
+    app_client = EthAppClient(backend)
+    if firmware.device == "nanos":
+        pytest.skip("Not supported on LNS")
+
+    # in verbose mode the app refuses the packed values, which are then sent one by one
+    if verbose:
+        settings_toggle(firmware, navigator, [SettingID.VERBOSE_EIP712])
+
+    with open(input_file, encoding="utf-8") as file:
+        data = json.load(file)
+
+    vrs = eip712_new_common(firmware,
+                            navigator,
+                            default_screenshot_path,
+                            app_client,
+                            data,
+                            None,
+                            verbose,
+                            packed_arrays=True)
+    assert recover_message(data, vrs) == get_wallet_addr(app_client)
+
+
+def test_eip712_unknown_schema_hash(firmware: Firmware, backend: BackendInterface):
+    app_client = EthAppClient(backend)
+    if firmware.device == "nanos":
+        pytest.skip("Not supported on LNS")
+
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.eip712_send_struct_defs_schema_hash(bytes(28))
+    assert e.value.status == StatusWord.REF_DATA_NOT_FOUND
+
+
 def test_eip712_advanced_filtering(firmware: Firmware,
                                    backend: BackendInterface,
                                    navigator: Navigator,
@@ -4,6 +4,8 @@ from ragger.error import ExceptionRAPDU
 from ragger.backend import BackendInterface
 
 from client.client import EthAppClient, StatusWord
+from client.command_builder import CommandBuilder
+from client.token_list import TokenListTree
 
 
 def test_provide_erc20_token(backend: BackendInterface):
@@ -25,3 +27,37 @@ def test_provide_erc20_token_error(backend: BackendInterface):
         app_client.provide_token_metadata("ZRX", addr, 18, 1, sign)
 
     assert e.value.status == StatusWord.INVALID_DATA
+
+
+def test_provide_erc20_token_list(backend: BackendInterface):
+
+    app_client = EthAppClient(backend)
+
+    tokens = [("TK%u" % idx, bytes([idx]) * 20, 18, 1) for idx in range(1, 8)]
+    indexes = app_client.provide_token_list(tokens)
+    assert len(indexes) == len(tokens)
+    assert len(set(indexes)) == len(indexes)
+
+
+def test_provide_erc20_token_list_error(backend: BackendInterface):
+
+    app_client = EthAppClient(backend)
+
+    tokens = [("TK%u" % idx, bytes([idx]) * 20, 18, 1) for idx in range(1, 4)]
+    descriptors = [CommandBuilder().erc20_token_descriptor(*token) for token in tokens]
+    tree = TokenListTree(descriptors)
+
+    # entries without a verified root
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_token_list_entries([(descriptors[0], tree.proof(0))])
+    assert e.value.status == StatusWord.CONDITION_NOT_SATISFIED
+
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_token_list_root(tree.root, bytes.fromhex("deadbeef"))
+    assert e.value.status == StatusWord.INVALID_DATA
+
+    # proof of another entry
+    app_client.provide_token_list_root(tree.root)
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_token_list_entries([(descriptors[0], tree.proof(1))])
+    assert e.value.status == StatusWord.INVALID_DATA
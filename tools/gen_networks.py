@@ -2,7 +2,7 @@
 
 import os
 import sys
-import re
+import json
 import argparse
 from pathlib import Path
 
@@ -31,56 +31,69 @@ def get_header() -> str:
 """ % (sys.argv[0])
 
 
-def gen_icons_array_inc(networks: list[Network], path: str) -> bool:
+def gen_networks_array_inc(networks: list[Network], path: str, icons: bool) -> bool:
     with open(path + ".h", "w") as out:
         print(get_header() + """\
-#ifndef NETWORK_ICONS_GENERATED_H_
-#define NETWORK_ICONS_GENERATED_H_
-
-#include <stdint.h>
-#include "nbgl_types.h"
-
+#ifndef NETWORKS_GENERATED_H_
+#define NETWORKS_GENERATED_H_
+
+#include <stdint.h>\
+""", file=out)
+        if icons:
+            print("#include \"nbgl_types.h\"", file=out)
+        print("""
 typedef struct {
     uint64_t chain_id;
-    const nbgl_icon_details_t *icon;
-} network_icon_t;
-
-extern const network_icon_t g_network_icons[%u];
-
-#endif // NETWORK_ICONS_GENERATED_H_ \
+    const char *name;
+    const char *ticker;\
+""", file=out)
+        if icons:
+            print("    const nbgl_icon_details_t *icon;", file=out)
+        print("""\
+} network_info_t;
+
+// Sorted by chain ID
+extern const network_info_t g_networks[%u];
+
+#endif // NETWORKS_GENERATED_H_ \
 """ % (len(networks)), file=out)
     return True
 
 
-def gen_icons_array_src(networks: list[Network], path: str) -> bool:
+def gen_networks_array_src(networks: list[Network], path: str, icons: bool) -> bool:
     with open(path + ".c", "w") as out:
-        print(get_header() + """\
-#include "glyphs.h"
+        print(get_header(), end="", file=out)
+        if icons:
+            print("#include \"glyphs.h\"", file=out)
+        print("""\
 #include "%s.h"
 
-const network_icon_t g_network_icons[%u] = {\
+const network_info_t g_networks[%u] = {\
 """ % (os.path.basename(path), len(networks)), file=out)
 
         for net in networks:
-            glyph_name = get_network_glyph_name(net)
-            glyph_file = "glyphs/%s.gif" % (glyph_name)
-            if os.path.isfile(glyph_file):
+            print(" "*4, end="", file=out)
+            print("{.chain_id = %u, .name = %s, .ticker = %s" % (net.chain_id,
+                                                                json.dumps(net.name),
+                                                                json.dumps(net.ticker)),
+                  end="",
+                  file=out)
+            if icons and network_icon_exists(net):
+                glyph_name = get_network_glyph_name(net)
+                glyph_file = "glyphs/%s.gif" % (glyph_name)
                 if os.path.islink(glyph_file):
                     glyph_name = Path(os.path.realpath(glyph_file)).stem
-                print(" "*4, end="", file=out)
-                print("{.chain_id = %u, .icon = &C_%s}, // %s" % (net.chain_id,
-                                                                  glyph_name,
-                                                                  net.name),
-                      file=out)
+                print(", .icon = &C_%s" % (glyph_name), end="", file=out)
+            print("},", file=out)
 
         print("};", file=out)
     return True
 
 
-def gen_icons_array(networks: list[Network], path: str) -> bool:
-    path += "/net_icons.gen"
-    if not gen_icons_array_inc(networks, path) or \
-       not gen_icons_array_src(networks, path):
+def gen_networks_array(networks: list[Network], path: str, icons: bool) -> bool:
+    path += "/networks.gen"
+    if not gen_networks_array_inc(networks, path, icons) or \
+       not gen_networks_array_src(networks, path, icons):
         return False
     return True
 
@@ -89,26 +102,25 @@ def network_icon_exists(net: Network) -> bool:
     return os.path.isfile("glyphs/%s.gif" % (get_network_glyph_name(net)))
 
 
-def main(output_dir: str) -> bool:
+def main(output_dir: str, icons: bool) -> bool:
     networks: list[Network] = list()
 
-    # get chain IDs and network names
-    expr = r"{\.chain_id = ([0-9]*), \.name = \"(.*)\", \.ticker = \"(.*)\"},"
-    with open("src/network.c") as f:
-        for line in f.readlines():
-            line = line.strip()
-            if line.startswith("{") and line.endswith("},"):
-                m = re.search(expr,
-                              line)
-                assert(m.lastindex == 3)
-                networks.append(Network(int(m.group(1)),
-                                        m.group(2),
-                                        m.group(3)))
+    # get chain IDs, network names and tickers
+    with open("src/networks.json") as f:
+        for entry in json.load(f):
+            networks.append(Network(int(entry["chain_id"]),
+                                    entry["name"],
+                                    entry["ticker"]))
 
+    # the app looks the chain IDs up with a binary search
     networks.sort(key=lambda x: x.chain_id)
+    for prev, net in zip(networks, networks[1:]):
+        if prev.chain_id == net.chain_id:
+            print("Duplicate chain ID %u (%s, %s)" % (net.chain_id, prev.name, net.name),
+                  file=sys.stderr)
+            return False
 
-    if not gen_icons_array(list(filter(network_icon_exists, networks)),
-                           output_dir):
+    if not gen_networks_array(networks, output_dir, icons):
         return False
     return True
 
@@ -116,6 +128,9 @@ def main(output_dir: str) -> bool:
 if __name__ == "__main__":
     parser = argparse.ArgumentParser()
     parser.add_argument("OUTPUT_DIR")
+    parser.add_argument("--icons",
+                        action="store_true",
+                        help="reference the network icons (NBGL devices)")
     args = parser.parse_args()
-    assert os.path.isdir(args.OUTPUT_DIR)
-    quit(0 if main(args.OUTPUT_DIR) else 1)
+    os.makedirs(args.OUTPUT_DIR, exist_ok=True)
+    quit(0 if main(args.OUTPUT_DIR, args.icons) else 1)
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+
+import os
+import re
+import sys
+import argparse
+from typing import Optional
+
+
+SOURCE = "src/eth_plugin_internal.c"
+
+SELECTOR_RE = re.compile(r"static\s+const\s+uint8_t\s+(\w+)\s*\[\s*SELECTOR_SIZE\s*\]\s*=\s*"
+                         r"\{([^}]*)\}\s*;")
+SELECTOR_LIST_RE = re.compile(r"const\s+uint8_t\s*\*\s*const\s+(\w+)\s*\[\s*\w+\s*\]\s*=\s*"
+                              r"\{([^}]*)\}\s*;")
+PLUGIN_RE = re.compile(r"\{\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*\"([^\"]*)\"\s*,\s*(\w+)\s*\}")
+DIRECTIVE_RE = re.compile(r"#\s*(ifdef|ifndef|endif|if|elif|else)\b\s*(\w*)")
+
+
+class Plugin:
+    index_name: str
+    selectors: str
+    guards: list[str]
+
+    def __init__(self, alias: str, selectors: str, guards: list[str]):
+        self.index_name = "INTERNAL_PLUGIN_" + alias.lstrip("-").upper()
+        self.selectors = selectors
+        self.guards = guards
+
+
+class Selector:
+    value: int
+    plugin: Plugin
+
+    def __init__(self, value: int, plugin: Plugin):
+        self.value = value
+        self.plugin = plugin
+
+
+def get_header() -> str:
+    return """\
+/*
+ * Generated by %s from %s
+ */
+
+""" % (sys.argv[0], SOURCE)
+
+
+def update_guards(guards: list[str], line: str) -> bool:
+    m = DIRECTIVE_RE.match(line.strip())
+    if m is None:
+        return False
+    directive, macro = m.groups()
+    if directive == "ifdef":
+        guards.append(macro)
+    elif directive == "endif":
+        guards.pop()
+    else:
+        # would require evaluating expressions, keep the internal plugins table simple
+        raise ValueError("Unsupported directive in %s: %s" % (SOURCE, line.strip()))
+    return True
+
+
+def parse_source(path: str) -> Optional[tuple[list[Plugin], list[Selector]]]:
+    selectors: dict[str, int] = dict()
+    lists: dict[str, list[str]] = dict()
+    plugins: list[Plugin] = list()
+    guards: list[str] = list()
+    statement = ""
+    in_table = False
+
+    with open(path) as f:
+        for line in f:
+            if update_guards(guards, line):
+                continue
+            if in_table:
+                m = PLUGIN_RE.search(line)
+                if m is not None:
+                    _, sel_list, _, alias, _ = m.groups()
+                    if sel_list != "NULL":
+                        plugins.append(Plugin(alias, sel_list, list(guards)))
+                if "};" in line:
+                    in_table = False
+                continue
+            if "INTERNAL_ETH_PLUGINS[]" in line:
+                in_table = True
+                continue
+            statement += line
+            if ";" not in line:
+                continue
+            m = SELECTOR_RE.search(statement)
+            if m is not None:
+                value = bytes(int(b, 0) for b in m.group(2).split(","))
+                selectors[m.group(1)] = int.from_bytes(value, "big")
+            m = SELECTOR_LIST_RE.search(statement)
+            if m is not None:
+                lists[m.group(1)] = [s.strip() for s in m.group(2).split(",") if s.strip()]
+            statement = ""
+
+    entries: list[Selector] = list()
+    for plugin in plugins:
+        if plugin.selectors not in lists:
+            print("Unknown selector list %s" % (plugin.selectors), file=sys.stderr)
+            return None
+        for name in lists[plugin.selectors]:
+            if name not in selectors:
+                print("Unknown selector %s" % (name), file=sys.stderr)
+                return None
+            entries.append(Selector(selectors[name], plugin))
+    return plugins, entries
+
+
+def print_guarded(out, guards: list[str], text: str):
+    for guard in guards:
+        print("#ifdef %s" % (guard), file=out)
+    print(text, file=out)
+    for guard in reversed(guards):
+        print("#endif  // %s" % (guard), file=out)
+
+
+def gen_selectors_inc(plugins: list[Plugin], path: str):
+    with open(path + ".h", "w") as out:
+        print(get_header() + """\
+#ifndef PLUGIN_SELECTORS_GENERATED_H_
+#define PLUGIN_SELECTORS_GENERATED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Indexes in INTERNAL_ETH_PLUGINS
+enum {""", file=out)
+        for plugin in plugins:
+            print_guarded(out, plugin.guards, "    %s," % (plugin.index_name))
+        print("""\
+};
+
+typedef struct {
+    uint32_t selector;
+    uint8_t plugin;
+} internal_plugin_selector_t;
+
+// Sorted by selector, then in the order of INTERNAL_ETH_PLUGINS
+extern const internal_plugin_selector_t g_internal_plugin_selectors[];
+extern const size_t g_internal_plugin_selectors_count;
+
+#endif  // PLUGIN_SELECTORS_GENERATED_H_""", file=out)
+
+
+def gen_selectors_src(entries: list[Selector], path: str):
+    with open(path + ".c", "w") as out:
+        print(get_header() + """\
+#include "%s.h"
+
+const internal_plugin_selector_t g_internal_plugin_selectors[] = {\
+""" % (os.path.basename(path)), file=out)
+        for entry in entries:
+            print_guarded(out,
+                          entry.plugin.guards,
+                          "    {.selector = 0x%08x, .plugin = %s}," % (entry.value,
+                                                                       entry.plugin.index_name))
+        print("""\
+};
+
+const size_t g_internal_plugin_selectors_count =
+    sizeof(g_internal_plugin_selectors) / sizeof(g_internal_plugin_selectors[0]);""", file=out)
+
+
+def main(output_dir: str) -> bool:
+    parsed = parse_source(SOURCE)
+    if parsed is None:
+        return False
+    plugins, entries = parsed
+    # the app looks the selectors up with a binary search, stable to keep the plugins priority
+    entries.sort(key=lambda x: x.value)
+
+    path = os.path.join(output_dir, "plugin_selectors.gen")
+    gen_selectors_inc(plugins, path)
+    gen_selectors_src(entries, path)
+    return True
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("OUTPUT_DIR")
+    args = parser.parse_args()
+    os.makedirs(args.OUTPUT_DIR, exist_ok=True)
+    quit(0 if main(args.OUTPUT_DIR) else 1)